@@ -0,0 +1,255 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/ast_rules.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+#include "src/checks_util.h"
+#include "src/config.pb.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+#include "zetasql/parser/parse_tree.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr int kNodeKinds = kLastASTNodeKind + 1;
+
+// Returns <name> in lowercase without underscores.
+std::string NormalizeKindName(absl::string_view name) {
+  std::string normalized = absl::AsciiStrToLower(name);
+  normalized.erase(std::remove(normalized.begin(), normalized.end(), '_'),
+                   normalized.end());
+  return normalized;
+}
+
+// Adds the kind named <name> to <kinds>.
+absl::Status AddKind(const AstRule &rule, absl::string_view name,
+                     std::vector<bool> *kinds) {
+  ASTNodeKind kind;
+  if (!ParseNodeKind(name, &kind))
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown node kind '", name, "' in syntax tree rule '",
+                     rule.name(), "'."));
+  (*kinds)[kind] = true;
+  return absl::OkStatus();
+}
+
+// Returns if <node> is named by its own text.
+bool IsName(const ASTNode *node) {
+  return node->node_kind() == AST_IDENTIFIER ||
+         node->node_kind() == AST_PATH_EXPRESSION;
+}
+
+// Returns a fingerprint of the syntax tree rules of <config>.
+uint64_t RulesFingerprint(const Config &config) {
+  uint64_t fingerprint = config.ast_rule_size();
+  for (const AstRule &rule : config.ast_rule())
+    fingerprint = CombineFingerprints(fingerprint,
+                                      Fingerprint64(rule.SerializeAsString()));
+  return fingerprint;
+}
+
+}  // namespace
+
+bool ParseNodeKind(absl::string_view name, ASTNodeKind *kind) {
+  static const auto *kinds = [] {
+    auto *kinds = new std::map<std::string, ASTNodeKind>();
+    for (int i = 0; i < kNodeKinds; ++i) {
+      ASTNodeKind kind = static_cast<ASTNodeKind>(i);
+      (*kinds)[NormalizeKindName(ASTNode::NodeKindToString(kind))] = kind;
+    }
+    return kinds;
+  }();
+  if (absl::StartsWithIgnoreCase(name, "AST_")) name.remove_prefix(4);
+  auto it = kinds->find(NormalizeKindName(name));
+  if (it == kinds->end()) return false;
+  *kind = it->second;
+  return true;
+}
+
+absl::Status AstRuleSet::Compile(const Config &config,
+                                 std::unique_ptr<AstRuleSet> *rules) {
+  std::unique_ptr<AstRuleSet> compiled(new AstRuleSet());
+  compiled->programs_.resize(kNodeKinds);
+
+  for (const AstRule &rule : config.ast_rule()) {
+    if (rule.name().empty())
+      return absl::InvalidArgumentError(
+          absl::StrCat("Syntax tree rule of node kind '", rule.node_kind(),
+                       "' doesn't have a name."));
+    ASTNodeKind kind;
+    if (!ParseNodeKind(rule.node_kind(), &kind))
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown node kind '", rule.node_kind(),
+                       "' in syntax tree rule '", rule.name(), "'."));
+
+    Program program;
+    program.rule = compiled->rules_.size();
+    // Every required kind is a predicate of its own, forbidden kinds are
+    // checked together.
+    for (const std::string &child : rule.has_child()) {
+      Instruction has_child{Instruction::kHasChild,
+                            std::vector<bool>(kNodeKinds)};
+      absl::Status status = AddKind(rule, child, &has_child.kinds);
+      if (!status.ok()) return status;
+      program.instructions.push_back(std::move(has_child));
+    }
+    if (rule.no_child_size() > 0) {
+      Instruction no_child{Instruction::kNoChild,
+                           std::vector<bool>(kNodeKinds)};
+      for (const std::string &child : rule.no_child()) {
+        absl::Status status = AddKind(rule, child, &no_child.kinds);
+        if (!status.ok()) return status;
+      }
+      program.instructions.push_back(std::move(no_child));
+    }
+    if (rule.has_name_pattern()) {
+      auto pattern = std::make_unique<RE2>(rule.name_pattern(), RE2::Quiet);
+      if (!pattern->ok())
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid name pattern of syntax tree rule '",
+                         rule.name(), "': ", pattern->error()));
+      Instruction name{Instruction::kName};
+      name.pattern = compiled->patterns_.size();
+      compiled->patterns_.push_back(std::move(pattern));
+      program.instructions.push_back(std::move(name));
+    }
+    for (const std::string &ancestor : rule.has_ancestor()) {
+      Instruction has_ancestor{Instruction::kHasAncestor,
+                               std::vector<bool>(kNodeKinds)};
+      absl::Status status = AddKind(rule, ancestor, &has_ancestor.kinds);
+      if (!status.ok()) return status;
+      program.instructions.push_back(std::move(has_ancestor));
+    }
+    if (rule.no_ancestor_size() > 0) {
+      Instruction no_ancestor{Instruction::kNoAncestor,
+                              std::vector<bool>(kNodeKinds)};
+      for (const std::string &ancestor : rule.no_ancestor()) {
+        absl::Status status = AddKind(rule, ancestor, &no_ancestor.kinds);
+        if (!status.ok()) return status;
+      }
+      program.instructions.push_back(std::move(no_ancestor));
+    }
+
+    compiled->rules_.push_back(rule);
+    compiled->programs_[kind].push_back(std::move(program));
+  }
+  *rules = std::move(compiled);
+  return absl::OkStatus();
+}
+
+std::shared_ptr<const AstRuleSet> AstRuleSet::ForConfig(const Config &config) {
+  if (config.ast_rule_size() == 0) return nullptr;
+
+  static absl::Mutex mutex(absl::kConstInit);
+  static auto *cache =
+      new std::map<uint64_t, std::shared_ptr<const AstRuleSet>>();
+  const uint64_t fingerprint = RulesFingerprint(config);
+  absl::MutexLock lock(&mutex);
+  auto it = cache->find(fingerprint);
+  if (it != cache->end()) return it->second;
+
+  std::unique_ptr<AstRuleSet> rules;
+  std::shared_ptr<const AstRuleSet> shared;
+  if (Compile(config, &rules).ok()) shared = std::move(rules);
+  (*cache)[fingerprint] = shared;
+  return shared;
+}
+
+LinterResult AstRuleSet::Check(absl::string_view sql,
+                               const LinterOptions &options) const {
+  return ASTNodeRule([this](const ASTNode *node, const absl::string_view &sql,
+                            const LinterOptions &options) {
+           return CheckNode(node, sql, options);
+         })
+      .ApplyTo(sql, options);
+}
+
+LinterResult AstRuleSet::CheckNode(const ASTNode *node, absl::string_view sql,
+                                   const LinterOptions &options) const {
+  LinterResult result;
+  const int kind = node->node_kind();
+  if (kind < 0 || kind >= kNodeKinds) return result;
+  for (const Program &program : programs_[kind]) {
+    bool holds = true;
+    for (const Instruction &instruction : program.instructions) {
+      if (!Run(instruction, node, sql)) {
+        holds = false;
+        break;
+      }
+    }
+    if (!holds) continue;
+    const int position = GetStartPosition(*node);
+    if (options.IsActive(ErrorCode::kAstRule, position)) {
+      const AstRule &rule = rules_[program.rule];
+      result.Add(ErrorCode::kAstRule, sql, position,
+                 absl::StrCat(rule.name(), ": ", rule.message()));
+    }
+  }
+  return result;
+}
+
+bool AstRuleSet::Run(const Instruction &instruction, const ASTNode *node,
+                     absl::string_view sql) const {
+  switch (instruction.op) {
+    case Instruction::kHasChild:
+    case Instruction::kNoChild: {
+      bool found = false;
+      for (int i = 0; i < node->num_children() && !found; ++i)
+        found = instruction.kinds[node->child(i)->node_kind()];
+      return found == (instruction.op == Instruction::kHasChild);
+    }
+    case Instruction::kName: {
+      const ASTNode *named = node;
+      if (!IsName(named) && node->num_children() > 0) named = node->child(0);
+      if (!IsName(named)) return false;
+      // Quoted identifiers are matched without their backticks.
+      const std::string name =
+          absl::StrReplaceAll(GetNodeString(named, sql), {{"`", ""}});
+      return RE2::FullMatch(name, *patterns_[instruction.pattern]);
+    }
+    case Instruction::kHasAncestor:
+    case Instruction::kNoAncestor: {
+      bool found = false;
+      for (const ASTNode *parent = node->parent(); parent != nullptr && !found;
+           parent = parent->parent())
+        found = instruction.kinds[parent->node_kind()];
+      return found == (instruction.op == Instruction::kHasAncestor);
+    }
+  }
+  return false;
+}
+
+}  // namespace zetasql::linter
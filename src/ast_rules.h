@@ -0,0 +1,100 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_AST_RULES_H_
+#define SRC_AST_RULES_H_
+
+// Rules defined in configuration files as constraints on syntax tree nodes,
+// like "a join without an ON clause". Every rule is compiled into a short
+// program of predicates, and programs are indexed by the node kind they
+// report. All rules are checked in a single traversal of the tree, and a
+// rule is only evaluated on nodes of its kind.
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "re2/re2.h"
+#include "src/config.pb.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+#include "zetasql/parser/parse_tree.h"
+
+namespace zetasql::linter {
+
+// Sets <kind> to the node kind named <name>, like "AST_FUNCTION_CALL" or
+// "FunctionCall". Case and underscores are ignored. Returns false if there
+// isn't such a kind.
+bool ParseNodeKind(absl::string_view name, ASTNodeKind *kind);
+
+class AstRuleSet {
+ public:
+  AstRuleSet(const AstRuleSet &) = delete;
+  AstRuleSet &operator=(const AstRuleSet &) = delete;
+
+  // Compiles the syntax tree rules of <config> into <rules>. Returns an error
+  // if a rule doesn't have a name, has an unknown node kind or an invalid
+  // name pattern.
+  static absl::Status Compile(const Config &config,
+                              std::unique_ptr<AstRuleSet> *rules);
+
+  // Returns the compiled syntax tree rules of <config>, or null if it doesn't
+  // have any or they are invalid. Rules are compiled once per process.
+  static std::shared_ptr<const AstRuleSet> ForConfig(const Config &config);
+
+  // Returns the findings of all rules in <sql>.
+  LinterResult Check(absl::string_view sql, const LinterOptions &options) const;
+
+  // Returns the findings of the rules of the kind of <node>.
+  LinterResult CheckNode(const ASTNode *node, absl::string_view sql,
+                         const LinterOptions &options) const;
+
+ private:
+  AstRuleSet() = default;
+
+  // A single predicate of a rule.
+  struct Instruction {
+    enum Op { kHasChild, kNoChild, kName, kHasAncestor, kNoAncestor };
+    Op op;
+    // Node kinds of child and ancestor predicates, indexed by ASTNodeKind.
+    std::vector<bool> kinds;
+    // Pattern of kName, an index in 'patterns_'.
+    int pattern = -1;
+  };
+
+  // Predicates of a rule, all of them should hold for a finding. Cheap
+  // predicates come first, so most nodes are rejected without walking up
+  // the tree.
+  struct Program {
+    int rule;
+    std::vector<Instruction> instructions;
+  };
+
+  // Returns if <instruction> holds for <node>.
+  bool Run(const Instruction &instruction, const ASTNode *node,
+           absl::string_view sql) const;
+
+  std::vector<AstRule> rules_;
+  std::vector<std::unique_ptr<RE2>> patterns_;
+  // Programs indexed by the node kind they report.
+  std::vector<std::vector<Program>> programs_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_AST_RULES_H_
@@ -0,0 +1,108 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/ast_rules.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns the findings of the syntax tree rules of <config> in <sql>.
+std::vector<LintError> Check(const Config &config, absl::string_view sql) {
+  std::unique_ptr<AstRuleSet> rules;
+  EXPECT_TRUE(AstRuleSet::Compile(config, &rules).ok());
+  return rules->Check(sql, LinterOptions()).GetErrors();
+}
+
+TEST(AstRulesTest, ParseNodeKind) {
+  ASTNodeKind kind;
+  EXPECT_TRUE(ParseNodeKind("AST_FUNCTION_CALL", &kind));
+  EXPECT_EQ(kind, AST_FUNCTION_CALL);
+  EXPECT_TRUE(ParseNodeKind("FunctionCall", &kind));
+  EXPECT_EQ(kind, AST_FUNCTION_CALL);
+  EXPECT_TRUE(ParseNodeKind("where_clause", &kind));
+  EXPECT_EQ(kind, AST_WHERE_CLAUSE);
+  EXPECT_FALSE(ParseNodeKind("AST_NO_SUCH_NODE", &kind));
+}
+
+TEST(AstRulesTest, ChildConstraints) {
+  Config config;
+  AstRule *rule = config.add_ast_rule();
+  rule->set_name("no-cross-join");
+  rule->set_message("Join on a condition");
+  rule->set_node_kind("AST_JOIN");
+  rule->add_no_child("AST_ON_CLAUSE");
+  rule->add_no_child("AST_USING_CLAUSE");
+
+  EXPECT_TRUE(Check(config, "SELECT a FROM t JOIN u ON t.a = u.a;").empty());
+  EXPECT_TRUE(Check(config, "SELECT a FROM t JOIN u USING (a);").empty());
+  std::vector<LintError> errors =
+      Check(config, "SELECT a FROM t CROSS JOIN u JOIN v ON u.a = v.a;");
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors[0].GetType(), ErrorCode::kAstRule);
+  EXPECT_EQ(errors[0].GetErrorMessage(), "no-cross-join: Join on a condition");
+}
+
+TEST(AstRulesTest, NameAndAncestorConstraints) {
+  Config config;
+  AstRule *rule = config.add_ast_rule();
+  rule->set_name("no-rand-filter");
+  rule->set_node_kind("AST_FUNCTION_CALL");
+  rule->set_name_pattern("(?i)rand");
+  rule->add_has_ancestor("AST_WHERE_CLAUSE");
+
+  absl::string_view sql =
+      "SELECT RAND() FROM t WHERE rand() < 0.5 AND SQRT(a) > 1;";
+  std::vector<LintError> errors = Check(config, sql);
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors[0].GetOffset(), static_cast<int>(sql.find("rand()")));
+}
+
+TEST(AstRulesTest, InvalidRules) {
+  std::unique_ptr<AstRuleSet> rules;
+  Config unknown_kind;
+  AstRule *rule = unknown_kind.add_ast_rule();
+  rule->set_name("rule");
+  rule->set_node_kind("AST_JOIN");
+  rule->add_has_child("AST_NO_SUCH_NODE");
+  EXPECT_FALSE(AstRuleSet::Compile(unknown_kind, &rules).ok());
+  EXPECT_EQ(AstRuleSet::ForConfig(unknown_kind), nullptr);
+
+  Config invalid_pattern;
+  rule = invalid_pattern.add_ast_rule();
+  rule->set_name("rule");
+  rule->set_node_kind("AST_FUNCTION_CALL");
+  rule->set_name_pattern("(a");
+  EXPECT_FALSE(AstRuleSet::Compile(invalid_pattern, &rules).ok());
+
+  Config no_name;
+  no_name.add_ast_rule()->set_node_kind("AST_JOIN");
+  EXPECT_FALSE(AstRuleSet::Compile(no_name, &rules).ok());
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,227 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/baseline.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "src/file_utils.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// "ZLBASE01" in the byte order of the writer. A file of the other byte order
+// has a different magic and is rejected.
+constexpr uint64_t kMagic = 0x31304553414c425aULL;
+constexpr int kHeaderWords = 3;
+
+// Filter bits per fingerprint, and bits set for each of them. It gives
+// about 0.25% false positives.
+constexpr int kFilterBitsPerFingerprint = 16;
+constexpr int kFilterProbes = 4;
+
+// Fingerprints of check names, indexed by error code. They are computed once,
+// names are looked up in a map.
+const std::vector<uint64_t> &CheckFingerprints() {
+  static const std::vector<uint64_t> *fingerprints = [] {
+    auto *result = new std::vector<uint64_t>(
+        static_cast<int>(ErrorCode::COUNT) + 1, Fingerprint64(""));
+    for (const auto &[name, code] : GetErrorMap())
+      (*result)[static_cast<int>(code)] = Fingerprint64(name);
+    return result;
+  }();
+  return *fingerprints;
+}
+
+// Computes fingerprints of findings of a single file.
+class FileFingerprinter {
+ public:
+  FileFingerprinter(absl::string_view filename, absl::string_view content)
+      : content_(content) {
+    // './a.sql' and 'a.sql' are the same file.
+    while (absl::ConsumePrefix(&filename, "./")) continue;
+    file_fingerprint_ = Fingerprint64(filename);
+  }
+
+  uint64_t Fingerprint(const LintError &error) {
+    // Most files don't have findings, lines are split only when needed.
+    if (lines_.empty()) FingerprintLines();
+    int line = error.GetLineNumber();
+    uint64_t text = Fingerprint64("");
+    int copy = 0;
+    if (line >= 1 && line <= static_cast<int>(lines_.size()))
+      std::tie(text, copy) = lines_[line - 1];
+    uint64_t check = CheckFingerprints()[static_cast<int>(error.GetType())];
+    uint64_t key = CombineFingerprints(
+        CombineFingerprints(check, file_fingerprint_), text);
+    // Copies of a line, and findings of the same check on a line, are told
+    // apart. So a baseline with one of them doesn't suppress the others.
+    int &index = same_line_[CombineFingerprints(key, line)];
+    return CombineFingerprints(CombineFingerprints(key, copy), index++);
+  }
+
+ private:
+  // Splits the content into lines, and computes their fingerprints.
+  void FingerprintLines() {
+    absl::flat_hash_map<uint64_t, int> copies;
+    std::string text;
+    for (absl::string_view line : absl::StrSplit(content_, '\n')) {
+      // Whitespace is collapsed, so reindenting doesn't change findings.
+      text.clear();
+      for (char c : absl::StripAsciiWhitespace(line)) {
+        if (!absl::ascii_isspace(c))
+          text.push_back(c);
+        else if (text.back() != ' ')
+          text.push_back(' ');
+      }
+      uint64_t fingerprint = Fingerprint64(text);
+      lines_.emplace_back(fingerprint, copies[fingerprint]++);
+    }
+  }
+
+  absl::string_view content_;
+  // Fingerprints of the lines, with the number of lines of the same text
+  // before them.
+  std::vector<std::pair<uint64_t, int>> lines_;
+  uint64_t file_fingerprint_ = 0;
+  // Number of findings fingerprinted so far, for each key and line.
+  absl::flat_hash_map<uint64_t, int> same_line_;
+};
+
+// Returns the filter bit of probe <i> of <fingerprint>, with double hashing
+// of the halves of the fingerprint.
+uint64_t FilterBit(uint64_t fingerprint, int i, uint64_t filter_bits) {
+  uint64_t low = fingerprint & 0xffffffff;
+  uint64_t high = (fingerprint >> 32) | 1;
+  return (low + i * high) % filter_bits;
+}
+
+}  // namespace
+
+void AppendFingerprints(absl::string_view filename, absl::string_view content,
+                        const LinterResult &result,
+                        std::vector<uint64_t> *fingerprints) {
+  FileFingerprinter fingerprinter(filename, content);
+  for (const LintError &error : result.GetErrors())
+    fingerprints->push_back(fingerprinter.Fingerprint(error));
+}
+
+absl::Status WriteBaseline(absl::string_view filename,
+                           std::vector<uint64_t> fingerprints) {
+  std::sort(fingerprints.begin(), fingerprints.end());
+  fingerprints.erase(std::unique(fingerprints.begin(), fingerprints.end()),
+                     fingerprints.end());
+  const uint64_t filter_words = std::max<uint64_t>(
+      1, (fingerprints.size() * kFilterBitsPerFingerprint + 63) / 64);
+
+  std::vector<uint64_t> words = {kMagic, fingerprints.size(), filter_words};
+  words.resize(kHeaderWords + filter_words);
+  uint64_t *filter = words.data() + kHeaderWords;
+  for (uint64_t fingerprint : fingerprints) {
+    for (int i = 0; i < kFilterProbes; ++i) {
+      uint64_t bit = FilterBit(fingerprint, i, filter_words * 64);
+      filter[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+  }
+  words.insert(words.end(), fingerprints.begin(), fingerprints.end());
+  return WriteFileAtomically(
+      filename, absl::string_view(reinterpret_cast<const char *>(words.data()),
+                                  words.size() * sizeof(uint64_t)));
+}
+
+Baseline::~Baseline() {
+  if (data_ != nullptr) munmap(data_, size_);
+}
+
+absl::Status Baseline::Load(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return absl::NotFoundError(absl::StrCat(
+        "Baseline couldn't be opened: ", filename, ": ", strerror(errno)));
+  }
+  struct stat info;
+  void *data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 &&
+      info.st_size >= kHeaderWords * static_cast<int>(sizeof(uint64_t)))
+    data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  absl::Status invalid =
+      absl::InvalidArgumentError(absl::StrCat("Invalid baseline: ", filename));
+  if (data == MAP_FAILED) return invalid;
+
+  const size_t size = info.st_size;
+  const uint64_t *words = static_cast<const uint64_t *>(data);
+  const uint64_t count = words[1];
+  const uint64_t filter_words = words[2];
+  const uint64_t total = size / sizeof(uint64_t);
+  if (words[0] != kMagic || size % sizeof(uint64_t) != 0 ||
+      filter_words == 0 || filter_words > total || count > total ||
+      kHeaderWords + filter_words + count != total) {
+    munmap(data, size);
+    return invalid;
+  }
+  if (data_ != nullptr) munmap(data_, size_);
+  data_ = data;
+  size_ = size;
+  filter_ = words + kHeaderWords;
+  filter_words_ = filter_words;
+  fingerprints_ = filter_ + filter_words;
+  count_ = count;
+  return absl::OkStatus();
+}
+
+bool Baseline::Contains(uint64_t fingerprint) const {
+  if (count_ == 0) return false;
+  for (int i = 0; i < kFilterProbes; ++i) {
+    uint64_t bit = FilterBit(fingerprint, i, filter_words_ * 64);
+    if (((filter_[bit / 64] >> (bit % 64)) & 1) == 0) return false;
+  }
+  return std::binary_search(fingerprints_, fingerprints_ + count_,
+                            fingerprint);
+}
+
+void Baseline::Suppress(absl::string_view filename, absl::string_view content,
+                        LinterResult *result) const {
+  if (count_ == 0) return;
+  FileFingerprinter fingerprinter(filename, content);
+  result->RemoveErrors([&](const LintError &error) {
+    return Contains(fingerprinter.Fingerprint(error));
+  });
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,89 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_BASELINE_H_
+#define SRC_BASELINE_H_
+
+// A baseline of accepted findings, like legacy ones that are not fixed yet,
+// so that only new findings are reported.
+//
+// A finding is identified by the fingerprint of its check, its file and the
+// text of its line with whitespace collapsed, not by its position. Copies of
+// a line in the file are counted, and so are findings of the same check on a
+// line, so a baseline suppresses only as many of them as it has. Findings
+// stay in the baseline when other lines above them change. Messages are not
+// part of the fingerprint, so rewording a message doesn't invalidate
+// baselines.
+//
+// A baseline file is a sequence of 64 bit words in the byte order of the
+// machine that wrote it: a magic number, the number of fingerprints, the
+// number of words of a Bloom filter, the filter and the sorted fingerprints.
+// It is memory mapped when loaded, and most findings that are not in it are
+// rejected by the filter without searching the fingerprints.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+// Appends fingerprints of findings in <result> of file <filename>, whose
+// content is <content>, to <fingerprints>.
+void AppendFingerprints(absl::string_view filename, absl::string_view content,
+                        const LinterResult &result,
+                        std::vector<uint64_t> *fingerprints);
+
+// Writes a baseline file of <fingerprints>, duplicates are allowed.
+absl::Status WriteBaseline(absl::string_view filename,
+                           std::vector<uint64_t> fingerprints);
+
+class Baseline {
+ public:
+  Baseline() = default;
+  ~Baseline();
+
+  Baseline(const Baseline &) = delete;
+  Baseline &operator=(const Baseline &) = delete;
+
+  // Maps the baseline file <filename>. Without a loaded file, the baseline
+  // is empty.
+  absl::Status Load(const std::string &filename);
+
+  // Returns if <fingerprint> is in the baseline.
+  bool Contains(uint64_t fingerprint) const;
+
+  // Removes findings of <result> that are in the baseline. <filename> and
+  // <content> are the same with 'AppendFingerprints'.
+  void Suppress(absl::string_view filename, absl::string_view content,
+                LinterResult *result) const;
+
+ private:
+  // The mapped file, and the parts of it.
+  void *data_ = nullptr;
+  size_t size_ = 0;
+  const uint64_t *filter_ = nullptr;
+  uint64_t filter_words_ = 0;
+  const uint64_t *fingerprints_ = nullptr;
+  uint64_t count_ = 0;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_BASELINE_H_
@@ -0,0 +1,133 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/baseline.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr absl::string_view kContent =
+    "SELECT a b FROM T;\n"
+    "SELECT\n"
+    "  COUNT(1) FROM T;\n";
+
+LinterResult Findings(int alias_line, int count_line) {
+  LinterResult result;
+  result.Add(ErrorCode::kAlias, alias_line, 10, "Always use AS");
+  result.Add(ErrorCode::kCountStar, count_line, 3, "Use COUNT(*)");
+  return result;
+}
+
+TEST(BaselineTest, SuppressesFindingsInBaseline) {
+  std::string filename = testing::TempDir() + "/baseline.bin";
+  std::vector<uint64_t> fingerprints;
+  AppendFingerprints("q.sql", kContent, Findings(1, 3), &fingerprints);
+  ASSERT_EQ(fingerprints.size(), 2);
+  ASSERT_TRUE(WriteBaseline(filename, fingerprints).ok());
+
+  Baseline baseline;
+  ASSERT_TRUE(baseline.Load(filename).ok());
+
+  // Lines moved and reindented, the findings are still the same.
+  std::string moved =
+      "SELECT 1;\n\nSELECT  a b FROM T;\nSELECT\nCOUNT(1) FROM T;\n";
+  LinterResult result = Findings(3, 5);
+  baseline.Suppress("./q.sql", moved, &result);
+  EXPECT_TRUE(result.GetErrors().empty());
+
+  // A new finding of the same check, and the same finding in other files.
+  result = Findings(1, 3);
+  result.Add(ErrorCode::kAlias, 2, 1, "Always use AS");
+  baseline.Suppress("q.sql", kContent, &result);
+  ASSERT_EQ(result.GetErrors().size(), 1);
+  EXPECT_EQ(result.GetErrors()[0].GetLineNumber(), 2);
+
+  result = Findings(1, 3);
+  baseline.Suppress("other.sql", kContent, &result);
+  EXPECT_EQ(result.GetErrors().size(), 2);
+}
+
+TEST(BaselineTest, RepeatedLines) {
+  std::string filename = testing::TempDir() + "/repeated_baseline.bin";
+  std::vector<uint64_t> fingerprints;
+  AppendFingerprints("q.sql", kContent, Findings(1, 3), &fingerprints);
+  ASSERT_TRUE(WriteBaseline(filename, fingerprints).ok());
+  Baseline baseline;
+  ASSERT_TRUE(baseline.Load(filename).ok());
+
+  // A copy of a line with a finding in the baseline is a new finding.
+  std::string duplicated = absl::StrCat("SELECT a b FROM T;\n", kContent);
+  LinterResult result = Findings(2, 4);
+  result.Add(ErrorCode::kAlias, 1, 10, "Always use AS");
+  result.Sort();
+  baseline.Suppress("q.sql", duplicated, &result);
+  EXPECT_EQ(result.GetErrors().size(), 1);
+
+  // Also when only findings of some lines are checked, e.g. changed ones.
+  result = LinterResult();
+  result.Add(ErrorCode::kAlias, 2, 10, "Always use AS");
+  baseline.Suppress("q.sql", duplicated, &result);
+  EXPECT_EQ(result.GetErrors().size(), 1);
+
+  // And another finding of the same check on a line.
+  result = Findings(1, 3);
+  result.Add(ErrorCode::kAlias, 1, 12, "Always use AS");
+  baseline.Suppress("q.sql", kContent, &result);
+  EXPECT_EQ(result.GetErrors().size(), 1);
+}
+
+TEST(BaselineTest, ManyFingerprints) {
+  std::string filename = testing::TempDir() + "/large_baseline.bin";
+  std::vector<uint64_t> fingerprints;
+  for (uint64_t i = 0; i < 100000; ++i)
+    fingerprints.push_back(i * 0x9e3779b97f4a7c15ULL);
+  ASSERT_TRUE(WriteBaseline(filename, fingerprints).ok());
+
+  Baseline baseline;
+  ASSERT_TRUE(baseline.Load(filename).ok());
+  for (uint64_t fingerprint : fingerprints)
+    ASSERT_TRUE(baseline.Contains(fingerprint));
+  for (uint64_t i = 100000; i < 200000; ++i)
+    EXPECT_FALSE(baseline.Contains(i * 0x9e3779b97f4a7c15ULL));
+}
+
+TEST(BaselineTest, InvalidFiles) {
+  Baseline baseline;
+  EXPECT_FALSE(baseline.Load(testing::TempDir() + "/missing.bin").ok());
+
+  std::string filename = testing::TempDir() + "/invalid.bin";
+  std::ofstream(filename, std::ios::binary) << "not a baseline file at all";
+  EXPECT_FALSE(baseline.Load(filename).ok());
+  EXPECT_FALSE(baseline.Contains(0));
+
+  ASSERT_TRUE(WriteBaseline(filename, {}).ok());
+  EXPECT_TRUE(baseline.Load(filename).ok());
+  EXPECT_FALSE(baseline.Contains(0));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
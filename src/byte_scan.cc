@@ -0,0 +1,177 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/byte_scan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ZETASQL_LINTER_HAS_X86_KERNELS 1
+#endif
+
+namespace zetasql::linter {
+
+namespace {
+
+uint64_t MatchMaskScalar(const char *data, const ByteSet &set) {
+  uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i)
+    if (set.Contains(data[i])) mask |= uint64_t{1} << i;
+  return mask;
+}
+
+#ifdef ZETASQL_LINTER_HAS_X86_KERNELS
+
+// SSE2 is part of every x86-64 processor.
+uint64_t MatchMaskSse2(const char *data, const ByteSet &set) {
+  __m128i blocks[4];
+  for (int b = 0; b < 4; ++b)
+    blocks[b] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + b);
+  __m128i matches[4] = {_mm_setzero_si128(), _mm_setzero_si128(),
+                        _mm_setzero_si128(), _mm_setzero_si128()};
+  for (int i = 0; i < set.size(); ++i) {
+    const __m128i byte = _mm_set1_epi8(set.bytes()[i]);
+    for (int b = 0; b < 4; ++b)
+      matches[b] = _mm_or_si128(matches[b], _mm_cmpeq_epi8(blocks[b], byte));
+  }
+  uint64_t mask = 0;
+  for (int b = 0; b < 4; ++b) {
+    mask |= static_cast<uint64_t>(
+                static_cast<uint16_t>(_mm_movemask_epi8(matches[b])))
+            << (16 * b);
+  }
+  return mask;
+}
+
+__attribute__((target("avx2"))) uint64_t MatchMaskAvx2(const char *data,
+                                                       const ByteSet &set) {
+  const __m256i low =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  const __m256i high =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32));
+  __m256i low_matches = _mm256_setzero_si256();
+  __m256i high_matches = _mm256_setzero_si256();
+  for (int i = 0; i < set.size(); ++i) {
+    const __m256i byte = _mm256_set1_epi8(set.bytes()[i]);
+    low_matches = _mm256_or_si256(low_matches, _mm256_cmpeq_epi8(low, byte));
+    high_matches =
+        _mm256_or_si256(high_matches, _mm256_cmpeq_epi8(high, byte));
+  }
+  return static_cast<uint32_t>(_mm256_movemask_epi8(low_matches)) |
+         static_cast<uint64_t>(
+             static_cast<uint32_t>(_mm256_movemask_epi8(high_matches)))
+             << 32;
+}
+
+#endif  // ZETASQL_LINTER_HAS_X86_KERNELS
+
+using MaskFunction = uint64_t (*)(const char *, const ByteSet &);
+
+MaskFunction KernelFunction(ScanKernel kernel) {
+  switch (kernel) {
+#ifdef ZETASQL_LINTER_HAS_X86_KERNELS
+    case ScanKernel::kSse2:
+      return MatchMaskSse2;
+    case ScanKernel::kAvx2:
+      return MatchMaskAvx2;
+#endif
+    default:
+      return MatchMaskScalar;
+  }
+}
+
+MaskFunction FastestKernelFunction() {
+  static const MaskFunction function =
+      KernelFunction(SupportedScanKernels().back());
+  return function;
+}
+
+}  // namespace
+
+ByteSet::ByteSet(std::initializer_list<char> bytes) {
+  for (char c : bytes) {
+    if (Contains(c) || size_ == kMaxBytes) continue;
+    bytes_[size_++] = c;
+    table_[static_cast<unsigned char>(c)] = true;
+  }
+}
+
+const std::vector<ScanKernel> &SupportedScanKernels() {
+  static const std::vector<ScanKernel> *kernels = [] {
+    auto *result = new std::vector<ScanKernel>{ScanKernel::kScalar};
+#ifdef ZETASQL_LINTER_HAS_X86_KERNELS
+    result->push_back(ScanKernel::kSse2);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) result->push_back(ScanKernel::kAvx2);
+#endif
+    return result;
+  }();
+  return *kernels;
+}
+
+uint64_t MatchMask64(const char *data, const ByteSet &set) {
+  return FastestKernelFunction()(data, set);
+}
+
+uint64_t MatchMask64(const char *data, const ByteSet &set, ScanKernel kernel) {
+  return KernelFunction(kernel)(data, set);
+}
+
+int FindFirstOf(absl::string_view text, int from, const ByteSet &set) {
+  const int size = text.size();
+  // Hits are often close, a few bytes are tested before classifying blocks.
+  const int near_end = std::min(size, from + 8);
+  for (; from < near_end; ++from)
+    if (set.Contains(text[from])) return from;
+
+  const MaskFunction match_mask = FastestKernelFunction();
+  for (; from + 64 <= size; from += 64) {
+    uint64_t mask = match_mask(text.data() + from, set);
+    if (mask != 0) return from + __builtin_ctzll(mask);
+  }
+  for (; from < size; ++from)
+    if (set.Contains(text[from])) return from;
+  return size;
+}
+
+int ByteScanner::Next(int from) {
+  const int size = text_.size();
+  while (from < size) {
+    const int block = from - from % 64;
+    if (block != block_start_) {
+      block_start_ = block;
+      if (block + 64 <= size) {
+        mask_ = MatchMask64(text_.data() + block, set_);
+      } else {
+        mask_ = 0;
+        for (int i = block; i < size; ++i)
+          if (set_.Contains(text_[i])) mask_ |= uint64_t{1} << (i - block);
+      }
+    }
+    uint64_t mask = mask_ & (~uint64_t{0} << (from - block));
+    if (mask != 0) return block + __builtin_ctzll(mask);
+    from = block + 64;
+  }
+  return size;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,97 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_BYTE_SCAN_H_
+#define SRC_BYTE_SCAN_H_
+
+// Search of a few byte values in text, like line delimiters, tabs, quotes
+// and comment markers. Most bytes of sql are identifiers and whitespace
+// that checks don't look at, so checks jump from one interesting byte to
+// the next one instead of testing every byte.
+//
+// Text is classified in blocks of 64 bytes, into a bitmask of the bytes in
+// the set. Blocks are compared with SSE2 or AVX2 instructions if the
+// processor supports them, which is detected at runtime.
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// A set of at most 'kMaxBytes' byte values.
+class ByteSet {
+ public:
+  static constexpr int kMaxBytes = 8;
+
+  ByteSet(std::initializer_list<char> bytes);
+
+  // Returns if <c> is in the set.
+  bool Contains(char c) const { return table_[static_cast<unsigned char>(c)]; }
+
+  const char *bytes() const { return bytes_; }
+  int size() const { return size_; }
+
+ private:
+  char bytes_[kMaxBytes] = {};
+  int size_ = 0;
+  bool table_[256] = {};
+};
+
+// Implementations of 'MatchMask64'.
+enum class ScanKernel { kScalar, kSse2, kAvx2 };
+
+// Returns the kernels that the processor supports, the fastest one last.
+const std::vector<ScanKernel> &SupportedScanKernels();
+
+// Returns a mask of the 64 bytes at <data>, bit i is set if data[i] is in
+// <set>. Uses the fastest supported kernel.
+uint64_t MatchMask64(const char *data, const ByteSet &set);
+
+// Same with above function, with <kernel> that should be supported.
+uint64_t MatchMask64(const char *data, const ByteSet &set, ScanKernel kernel);
+
+// Returns the position of the first byte in <set> at or after <from> in
+// <text>, or the size of <text> if there isn't any.
+int FindFirstOf(absl::string_view text, int from, const ByteSet &set);
+
+// Iterates over positions of the bytes of a set in a text. Each block is
+// classified only once, so it is faster than 'FindFirstOf' when there are
+// many hits.
+class ByteScanner {
+ public:
+  // <text> and <set> should outlive the scanner.
+  ByteScanner(absl::string_view text, const ByteSet &set)
+      : text_(text), set_(set) {}
+
+  // Returns the position of the first byte in the set at or after <from>,
+  // or the size of the text if there isn't any.
+  int Next(int from);
+
+ private:
+  absl::string_view text_;
+  const ByteSet &set_;
+
+  // The last classified block, and its mask.
+  int block_start_ = -1;
+  uint64_t mask_ = 0;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_BYTE_SCAN_H_
@@ -0,0 +1,126 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of byte scan kernels, in GB/s of scanned text.
+//
+//    bazel run -c opt //src:byte_scan_benchmark
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/byte_scan.h"
+
+namespace zetasql::linter {
+namespace {
+
+constexpr int kTextSize = 64 << 20;
+constexpr int kRounds = 10;
+
+// Mostly identifiers and spaces, with a line delimiter about every 60 bytes
+// and a quote or comment marker about every 200 bytes.
+std::string SqlLikeText() {
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> byte(0, 11999);
+  const char kSpecial[] = "'\"-/#\t";
+  std::string text(kTextSize, ' ');
+  for (char &c : text) {
+    int value = byte(random);
+    if (value < 200)
+      c = '\n';
+    else if (value < 260)
+      c = kSpecial[value % 6];
+    else if (value < 2000)
+      c = ' ';
+    else
+      c = 'a' + value % 26;
+  }
+  return text;
+}
+
+const char *KernelName(ScanKernel kernel) {
+  switch (kernel) {
+    case ScanKernel::kScalar:
+      return "scalar";
+    case ScanKernel::kSse2:
+      return "sse2";
+    case ScanKernel::kAvx2:
+      return "avx2";
+  }
+  return "";
+}
+
+double GigabytesPerSecond(absl::Duration duration) {
+  return static_cast<double>(kTextSize) * kRounds / 1e9 /
+         absl::ToDoubleSeconds(duration);
+}
+
+void Run() {
+  const std::string text = SqlLikeText();
+  const ByteSet sets[] = {{'\n'}, {'\'', '"', '-', '/', '#'}};
+  const char *set_names[] = {"line delimiter", "quotes and comments"};
+
+  for (int s = 0; s < 2; ++s) {
+    for (ScanKernel kernel : SupportedScanKernels()) {
+      uint64_t hits = 0;
+      absl::Time start = absl::Now();
+      for (int round = 0; round < kRounds; ++round)
+        for (int i = 0; i + 64 <= kTextSize; i += 64)
+          hits += __builtin_popcountll(
+              MatchMask64(text.data() + i, sets[s], kernel));
+      std::cout << absl::StrFormat(
+                       "MatchMask64 %-20s %-7s %6.2f GB/s (%d hits)\n",
+                       set_names[s], KernelName(kernel),
+                       GigabytesPerSecond(absl::Now() - start), hits);
+    }
+
+    uint64_t hits = 0;
+    absl::Time start = absl::Now();
+    for (int round = 0; round < kRounds; ++round) {
+      for (int i = FindFirstOf(text, 0, sets[s]); i < kTextSize;
+           i = FindFirstOf(text, i + 1, sets[s]))
+        ++hits;
+    }
+    std::cout << absl::StrFormat("FindFirstOf %-20s         %6.2f GB/s "
+                                 "(%d hits)\n",
+                                 set_names[s],
+                                 GigabytesPerSecond(absl::Now() - start), hits);
+
+    hits = 0;
+    start = absl::Now();
+    for (int round = 0; round < kRounds; ++round) {
+      ByteScanner scanner(text, sets[s]);
+      for (int i = scanner.Next(0); i < kTextSize; i = scanner.Next(i + 1))
+        ++hits;
+    }
+    std::cout << absl::StrFormat("ByteScanner %-20s         %6.2f GB/s "
+                                 "(%d hits)\n",
+                                 set_names[s],
+                                 GigabytesPerSecond(absl::Now() - start), hits);
+  }
+}
+
+}  // namespace
+}  // namespace zetasql::linter
+
+int main() {
+  zetasql::linter::Run();
+  return 0;
+}
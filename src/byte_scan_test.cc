@@ -0,0 +1,111 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/byte_scan.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Sql-like text with rare interesting bytes.
+std::string RandomText(int size, std::mt19937 *random) {
+  const std::string alphabet =
+      "abcdefghijklmnopqrstuvwxyzABC_0123456789     \n\t'\"-/#*\xc3\xa7";
+  std::uniform_int_distribution<int> index(0, alphabet.size() - 1);
+  std::string text;
+  for (int i = 0; i < size; ++i) text += alphabet[index(*random)];
+  return text;
+}
+
+TEST(ByteScanTest, ByteSet) {
+  ByteSet set({'a', '\n', 'a', '\xff'});
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_TRUE(set.Contains('a'));
+  EXPECT_TRUE(set.Contains('\xff'));
+  EXPECT_FALSE(set.Contains('b'));
+  EXPECT_FALSE(set.Contains('\0'));
+}
+
+TEST(ByteScanTest, KernelsMatchScalar) {
+  std::mt19937 random(42);
+  const ByteSet sets[] = {{'\n'},
+                          {'\t', '\n'},
+                          {'\'', '"', '-', '/', '#'},
+                          {'\xc3', '*', ' ', '\n', '\t', '\'', '"', '#'}};
+  ASSERT_FALSE(SupportedScanKernels().empty());
+  for (int round = 0; round < 100; ++round) {
+    std::string text = RandomText(64, &random);
+    for (const ByteSet &set : sets) {
+      uint64_t expected = 0;
+      for (int i = 0; i < 64; ++i)
+        if (set.Contains(text[i])) expected |= uint64_t{1} << i;
+      EXPECT_EQ(MatchMask64(text.data(), set), expected);
+      for (ScanKernel kernel : SupportedScanKernels())
+        EXPECT_EQ(MatchMask64(text.data(), set, kernel), expected)
+            << static_cast<int>(kernel);
+    }
+  }
+}
+
+TEST(ByteScanTest, FindFirstOf) {
+  std::mt19937 random(7);
+  const ByteSet set({'#', '\t'});
+  for (int size : {0, 1, 9, 63, 64, 65, 200, 1000}) {
+    std::string text = RandomText(size, &random);
+    for (int from = 0; from <= size; ++from) {
+      int expected = from;
+      while (expected < size && !set.Contains(text[expected])) ++expected;
+      ASSERT_EQ(FindFirstOf(text, from, set), expected) << size << " " << from;
+    }
+  }
+
+  // Hits after long runs without any.
+  std::string text = std::string(1000, 'x') + "#" + std::string(100, 'y');
+  EXPECT_EQ(FindFirstOf(text, 0, set), 1000);
+  EXPECT_EQ(FindFirstOf(text, 1001, set), text.size());
+}
+
+TEST(ByteScanTest, ByteScanner) {
+  std::mt19937 random(3);
+  const ByteSet set({'\n', '\''});
+  for (int size : {0, 5, 64, 130, 1000}) {
+    std::string text = RandomText(size, &random);
+    ByteScanner scanner(text, set);
+    std::vector<int> hits;
+    for (int i = scanner.Next(0); i < size; i = scanner.Next(i + 1))
+      hits.push_back(i);
+    std::vector<int> expected;
+    for (int i = 0; i < size; ++i)
+      if (set.Contains(text[i])) expected.push_back(i);
+    EXPECT_EQ(hits, expected) << size;
+
+    // Positions can go back too.
+    if (!expected.empty()) {
+      EXPECT_EQ(scanner.Next(0), expected[0]);
+    }
+  }
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -23,23 +23,38 @@
 #include <utility>
 #include <vector>
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "src/ast_rules.h"
+#include "src/byte_scan.h"
 #include "src/checks_util.h"
+#include "src/custom_rules.h"
+#include "src/identifier_table.h"
 #include "src/lint_error.h"
 #include "src/linter_options.h"
+#include "src/schema_catalog.h"
+#include "src/scope_builder.h"
+#include "src/statement_splitter.h"
+#include "src/utf8.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
 #include "zetasql/base/statusor.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_visitor.h"
 #include "zetasql/parser/parser.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/error_helpers.h"
+#include "zetasql/public/error_location.pb.h"
 #include "zetasql/public/parse_helpers.h"
 #include "zetasql/public/parse_location.h"
 #include "zetasql/public/parse_resume_location.h"
 #include "zetasql/public/parse_tokens.h"
+#include "zetasql/public/type.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 
 // Implemented rules in the same order with
 // rules in the documention in 'docs/checks.md'.
@@ -47,21 +62,24 @@ namespace zetasql::linter {
 
 LinterResult CheckLineLength(absl::string_view sql,
                              const LinterOptions &options) {
-  int line_size = 0;
   LinterResult result;
-  for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
-    if (sql[i] == options.LineDelimeter()) {
-      if (line_size > options.LineLimit() &&
-          !OneLineStatement(sql.substr(i - line_size, i))) {
-        if (options.IsActive(ErrorCode::kLineLimit, i))
-          result.Add(ErrorCode::kLineLimit, sql, i,
-                     absl::StrCat("Lines should be <= ", options.LineLimit(),
-                                  " characters long."));
-      }
-      line_size = 0;
-    } else {
-      ++line_size;
+  const ByteSet delimiter({static_cast<char>(options.LineDelimeter())});
+  ByteScanner scanner(sql, delimiter);
+  int line_start = 0;
+  for (int i = scanner.Next(0); i < static_cast<int>(sql.size());
+       i = scanner.Next(i + 1)) {
+    const absl::string_view line = sql.substr(line_start, i - line_start);
+    // A line has at most as many characters as bytes, so characters are
+    // counted only for lines that can be too long.
+    if (static_cast<int>(line.size()) > options.LineLimit() &&
+        CountCharacters(line) > options.LineLimit() &&
+        !OneLineStatement(line)) {
+      if (options.IsActive(ErrorCode::kLineLimit, i))
+        result.Add(ErrorCode::kLineLimit, sql, i,
+                   absl::StrCat("Lines should be <= ", options.LineLimit(),
+                                " characters long."));
     }
+    line_start = i + 1;
   }
   return result;
 }
@@ -89,11 +107,12 @@ LinterResult CheckSemicolon(absl::string_view sql,
 
 LinterResult CheckUppercaseKeywords(absl::string_view sql,
                                     const LinterOptions &options) {
-  std::vector<ParseToken> keywords = GetKeywords(sql, ErrorCode::kLetterCase);
+  std::shared_ptr<const std::vector<ParseToken>> keywords =
+      GetKeywords(sql, options, ErrorCode::kLetterCase);
   std::vector<const ASTNode *> identifiers = GetIdentifiers(sql, options);
   LinterResult result;
   int index = 0;
-  for (auto &token : keywords) {
+  for (auto &token : *keywords) {
     // Two pointer algorithm to reduce complexity O(N^2) to O(N)
     while (index < identifiers.size() && IsBefore(identifiers[index], token))
       index++;
@@ -104,24 +123,25 @@ LinterResult CheckUppercaseKeywords(absl::string_view sql,
 
     if (!ConsistentUppercaseLowercase(sql, token.GetLocationRange(), options)) {
       int position = token.GetLocationRange().start().GetByteOffset();
+      int length = token.GetLocationRange().end().GetByteOffset() - position;
+      std::string keyword(sql.substr(position, length));
+      if (options.UpperKeyword())
+        absl::AsciiStrToUpper(&keyword);
+      else
+        absl::AsciiStrToLower(&keyword);
       if (options.IsActive(ErrorCode::kLetterCase, position))
         result.Add(
             ErrorCode::kLetterCase, sql, position,
             absl::StrCat("Keyword '", token.GetImage(), "' should be all ",
-                         options.UpperKeyword() ? "uppercase" : "lowercase"));
+                         options.UpperKeyword() ? "uppercase" : "lowercase"),
+            {{position, length, keyword}});
     }
   }
   return result;
 }
 
-LinterResult CheckCommentType(absl::string_view sql,
-                              const LinterOptions &options) {
-  LinterResult result;
-  bool dash_comment = false;
-  bool slash_comment = false;
-  bool hash_comment = false;
-  absl::string_view first_type = "";
-
+void ScanCommentTypes(absl::string_view sql, const LinterOptions &options,
+                      std::vector<CommentUse> *uses) {
   for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
     if (IgnoreStrings(sql, &i)) continue;
     if (IgnoreComments(sql, options, &i, false)) continue;
@@ -131,22 +151,7 @@ LinterResult CheckCommentType(absl::string_view sql,
     if (sql[i] == '#') type = "#";
 
     if (type != "") {
-      if (type == "--") {
-        dash_comment = true;
-      } else if (type == "//") {
-        slash_comment = true;
-      } else {
-        hash_comment = true;
-      }
-
-      if (dash_comment + slash_comment + hash_comment == 1)
-        first_type = type;
-      else if (type != first_type &&
-               options.IsActive(ErrorCode::kCommentStyle, i))
-        result.Add(
-            ErrorCode::kCommentStyle, sql, i,
-            absl::StrCat("One line comments should be consistent, expected: ",
-                         first_type, ", found: ", type));
+      uses->push_back({i, type, options.IsActive(ErrorCode::kCommentStyle, i)});
 
       // Ignore the line.
       while (i < static_cast<int>(sql.size()) &&
@@ -156,10 +161,31 @@ LinterResult CheckCommentType(absl::string_view sql,
       continue;
     }
   }
+}
 
+LinterResult EvaluateCommentTypes(absl::string_view sql,
+                                  const std::vector<CommentUse> &uses) {
+  LinterResult result;
+  absl::string_view first_type = "";
+  for (const CommentUse &use : uses) {
+    if (first_type == "")
+      first_type = use.type;
+    else if (use.type != first_type && use.active)
+      result.Add(
+          ErrorCode::kCommentStyle, sql, use.position,
+          absl::StrCat("One line comments should be consistent, expected: ",
+                       first_type, ", found: ", use.type));
+  }
   return result;
 }
 
+LinterResult CheckCommentType(absl::string_view sql,
+                              const LinterOptions &options) {
+  std::vector<CommentUse> uses;
+  ScanCommentTypes(sql, options, &uses);
+  return EvaluateCommentTypes(sql, uses);
+}
+
 LinterResult CheckAliasKeyword(absl::string_view sql,
                                const LinterOptions &options) {
   // If parser is not active from config this check won't work.
@@ -169,12 +195,12 @@ LinterResult CheckAliasKeyword(absl::string_view sql,
            LinterResult result;
            if (node->node_kind() == AST_ALIAS) {
              int position = GetStartPosition(*node);
-             const std::string name =
-                 ConvertToUppercase(GetNodeString(node, sql));
-             if (name.size() < 2 || !absl::StartsWith(name, "AS")) {
+             if (!absl::StartsWithIgnoreCase(GetNodeString(node, sql),
+                                             "AS")) {
                if (options.IsActive(ErrorCode::kAlias, position))
                  result.Add(ErrorCode::kAlias, sql, position,
-                            "Always use AS keyword before aliases");
+                            "Always use AS keyword before aliases",
+                            {{position, 0, "AS "}});
              }
            }
            return result;
@@ -184,23 +210,28 @@ LinterResult CheckAliasKeyword(absl::string_view sql,
 
 LinterResult CheckTabCharactersUniform(absl::string_view sql,
                                        const LinterOptions &options) {
-  bool is_indent = true;
   const char kSpace = ' ', kTab = '\t';
+  const char delimiter = options.LineDelimeter();
+  const int size = sql.size();
   LinterResult result;
 
-  for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
-    if (sql[i] == options.LineDelimeter()) {
-      is_indent = true;
-    } else if (is_indent && sql[i] != options.AllowedIndent()) {
-      if (sql[i] == kTab || sql[i] == kSpace) {
-        if (options.IsActive(ErrorCode::kUniformIndent, i))
-          result.Add(
-              ErrorCode::kUniformIndent, sql, i,
-              absl::StrCat("Inconsistent use of indentation symbols, "
-                           "expected: ",
-                           (sql[i] == kTab ? "whitespace" : "tab character")));
-      }
-      is_indent = false;
+  // Only the first character of each line that isn't the allowed
+  // indentation is checked, the rest of the line is skipped.
+  const ByteSet delimiters({delimiter});
+  ByteScanner scanner(sql, delimiters);
+  for (int line_start = 0; line_start < size;
+       line_start = scanner.Next(line_start) + 1) {
+    int i = line_start;
+    while (i < size && sql[i] != delimiter && sql[i] == options.AllowedIndent())
+      ++i;
+    if (i == size || sql[i] == delimiter) continue;
+    if (sql[i] == kTab || sql[i] == kSpace) {
+      if (options.IsActive(ErrorCode::kUniformIndent, i))
+        result.Add(
+            ErrorCode::kUniformIndent, sql, i,
+            absl::StrCat("Inconsistent use of indentation symbols, "
+                         "expected: ",
+                         (sql[i] == kTab ? "whitespace" : "tab character")));
     }
   }
 
@@ -210,20 +241,31 @@ LinterResult CheckTabCharactersUniform(absl::string_view sql,
 LinterResult CheckNoTabsBesidesIndentations(absl::string_view sql,
                                             const LinterOptions &options) {
   const char kSpace = ' ', kTab = '\t';
-
-  bool is_indent = true;
+  const char delimiter = options.LineDelimeter();
+  const int size = sql.size();
   LinterResult result;
 
-  for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
-    if (sql[i] == options.LineDelimeter()) {
-      is_indent = true;
-    } else if (sql[i] != kSpace && sql[i] != kTab) {
-      is_indent = false;
-    } else if (sql[i] == kTab && !is_indent) {
-      if (options.IsActive(ErrorCode::kNotIndentTab, i))
-        result.Add(ErrorCode::kNotIndentTab, sql, i,
-                   "Tab is not in the indentation");
+  // Only tabs and line delimiters are visited. The end of the indentation
+  // of a line is found when the line has a tab.
+  const ByteSet tabs({delimiter, kTab});
+  ByteScanner scanner(sql, tabs);
+  int line_start = 0;
+  int indent_end = -1;
+  for (int i = scanner.Next(0); i < size; i = scanner.Next(i + 1)) {
+    if (sql[i] == delimiter) {
+      line_start = i + 1;
+      indent_end = -1;
+      continue;
+    }
+    if (indent_end < 0) {
+      indent_end = line_start;
+      while (indent_end < size && sql[indent_end] != delimiter &&
+             (sql[indent_end] == kSpace || sql[indent_end] == kTab))
+        ++indent_end;
     }
+    if (i > indent_end && options.IsActive(ErrorCode::kNotIndentTab, i))
+      result.Add(ErrorCode::kNotIndentTab, sql, i,
+                 "Tab is not in the indentation", {{i, 1, " "}});
   }
   return result;
 }
@@ -232,18 +274,44 @@ LinterResult CheckSingleQuotes(absl::string_view sql,
                                const LinterOptions &options) {
   LinterResult result;
 
+  // Other characters can't start a comment or a string.
+  static const ByteSet *kStarts = new ByteSet({'\'', '"', '-', '/', '#'});
+  ByteScanner scanner(sql, *kStarts);
   for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
+    i = scanner.Next(i);
+    if (i == static_cast<int>(sql.size())) break;
     if (IgnoreComments(sql, options, &i)) continue;
 
     if (sql[i] == '\'' || sql[i] == '"') {
-      if ((options.SingleQuote() && sql[i] == '"')) {
-        result.Add(ErrorCode::kSingleQuote, sql, i,
-                   "Use single quotes(') instead of double quotes(\")");
-      } else if ((!options.SingleQuote() && sql[i] == '\'')) {
-        result.Add(ErrorCode::kSingleQuote, sql, i,
-                   "Use double quotes(\") instead of single quotes(')");
-      }
+      const int start = i;
+      const char quote = sql[i];
       IgnoreStrings(sql, &i);
+      if (quote == (options.SingleQuote() ? '\'' : '"') ||
+          !options.IsActive(ErrorCode::kSingleQuote, start))
+        continue;
+
+      // Quotes are swapped only if it doesn't change the string, so strings
+      // with quotes or escapes inside and triple quoted strings are not
+      // fixed.
+      const std::string other(1, quote == '"' ? '\'' : '"');
+      absl::string_view content = sql.substr(start + 1, i - start - 1);
+      bool fixable = i > start && sql[i] == quote &&
+                     (start == 0 || sql[start - 1] != quote) &&
+                     (i + 1 == static_cast<int>(sql.size()) ||
+                      sql[i + 1] != quote) &&
+                     !absl::StrContains(content, "\\") &&
+                     !absl::StrContains(content, other);
+      std::vector<TextEdit> fix;
+      if (fixable) fix = {{start, 1, other}, {i, 1, other}};
+
+      if (options.SingleQuote())
+        result.Add(ErrorCode::kSingleQuote, sql, start,
+                   "Use single quotes(') instead of double quotes(\")",
+                   std::move(fix));
+      else
+        result.Add(ErrorCode::kSingleQuote, sql, start,
+                   "Use double quotes(\") instead of single quotes(')",
+                   std::move(fix));
     }
   }
   return result;
@@ -265,39 +333,43 @@ LinterResult CheckNames(absl::string_view sql, const LinterOptions &options) {
              int position =
                  node->GetParseLocationRange().start().GetByteOffset();
              absl::string_view name = GetNodeString(node, sql);
+             // Styles of a name are computed once per run.
+             auto styles = [name]() {
+               return IdentifierTable::Shared().Styles(name);
+             };
 
              if (parent->node_kind() == AST_PATH_EXPRESSION)
                if (parent->child(parent->num_children() - 1) != node)
                  return result;
 
              if (kind == AST_CREATE_TABLE_STATEMENT) {
-               if (!IsUpperCamelCase(name) &&
+               if (!(styles() & kUpperCamelCase) &&
                    options.IsActive(ErrorCode::kTableName, position))
                  result.Add(ErrorCode::kTableName, sql, position,
                             "Table names or"
                             " table aliases should be UpperCamelCase.");
 
              } else if (kind == AST_WINDOW_CLAUSE) {
-               if (!IsUpperCamelCase(name) &&
+               if (!(styles() & kUpperCamelCase) &&
                    options.IsActive(ErrorCode::kWindowName, position))
                  result.Add(ErrorCode::kWindowName, sql, position,
                             "Window names should be UpperCamelCase.");
 
              } else if (kind == AST_FUNCTION_DECLARATION) {
-               if (!IsUpperCamelCase(name) &&
+               if (!(styles() & kUpperCamelCase) &&
                    options.IsActive(ErrorCode::kFunctionName, position))
                  result.Add(ErrorCode::kFunctionName, sql, position,
                             "Function names should be UpperCamelCase.");
 
              } else if (kind == AST_SIMPLE_TYPE) {
-               if (!IsAllCaps(name) &&
+               if (!(styles() & kAllCaps) &&
                    options.IsActive(ErrorCode::kDataTypeName, position))
                  result.Add(ErrorCode::kDataTypeName, sql, position,
                             "Simple SQL data types should be all caps.");
 
              } else if (kind == AST_SELECT_COLUMN) {
                if (parent->node_kind() != AST_ALIAS) return result;
-               if (!IsLowerSnakeCase(name) && !IsUpperCamelCase(name) &&
+               if (!(styles() & (kLowerSnakeCase | kUpperCamelCase)) &&
                    options.IsActive(ErrorCode::kColumnName, position))
                  result.Add(ErrorCode::kColumnName, sql, position,
                             "Column names should be lower_snake_case.");
@@ -307,20 +379,20 @@ LinterResult CheckNames(absl::string_view sql, const LinterOptions &options) {
                // is the type.
                bool isTable = parent->child(1)->node_kind() == AST_TVF_SCHEMA;
 
-               if (!isTable && !IsLowerSnakeCase(name) &&
+               if (!isTable && !(styles() & kLowerSnakeCase) &&
                    options.IsActive(ErrorCode::kParameterName, position))
                  result.Add(ErrorCode::kParameterName, sql, position,
                             "Non-table function parameters should be "
                             "lower_snake_case.");
 
-               if (isTable && !IsUpperCamelCase(name) &&
+               if (isTable && !(styles() & kUpperCamelCase) &&
                    options.IsActive(ErrorCode::kParameterName, position))
                  result.Add(ErrorCode::kParameterName, sql, position,
                             "Table or proto function parameters should be "
                             "UpperCamelCase.");
 
              } else if (kind == AST_CREATE_CONSTANT_STATEMENT) {
-               if (!IsCapsSnakeCase(name) &&
+               if (!(styles() & kCapsSnakeCase) &&
                    options.IsActive(ErrorCode::kConstantName, position))
                  result.Add(ErrorCode::kConstantName, sql, position,
                             "Constant names should be CAPS_SNAKE_CASE.");
@@ -352,46 +424,69 @@ LinterResult CheckJoin(absl::string_view sql, const LinterOptions &options) {
       .ApplyTo(sql, options);
 }
 
-LinterResult CheckImports(absl::string_view sql, const LinterOptions &options) {
+void ScanImports(absl::string_view sql, const LinterOptions &options,
+                 std::vector<ImportUse> *uses) {
+  // End of the last import, words of an import are not imports.
+  int end = 0;
+  for (const TextMatch &match : *GetTextMatches(sql, options)) {
+    int i = match.position;
+    // Patterns are case insensitive, but only uppercase IMPORT is an import.
+    if (match.pattern != TextPattern::kImport || i < end ||
+        sql.substr(i, 6) != "IMPORT")
+      continue;
+    if (!options.IsActive(ErrorCode::kImport, i)) continue;
+    i += 6;
+    ImportUse use;
+    absl::string_view word = GetNextWord(sql, &i);
+    use.type_end = i;
+    if (absl::EqualsIgnoreCase(word, "PROTO") ||
+        absl::EqualsIgnoreCase(word, "MODULE")) {
+      use.type = (absl::EqualsIgnoreCase(word, "PROTO") ? 1 : 2);
+      use.name = std::string(GetNextWord(sql, &i));
+      use.name_end = i;
+    }
+    uses->push_back(std::move(use));
+    end = i;
+  }
+}
+
+LinterResult EvaluateImports(absl::string_view sql,
+                             const std::vector<ImportUse> &uses) {
   std::vector<std::string> imports;
   LinterResult result;
   int first_type = 0, second_type = 0;
-  for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
-    if (IgnoreStrings(sql, &i)) continue;
-    if (IgnoreComments(sql, options, &i)) continue;
-
-    if (i + 6 <= sql.size() && sql.substr(i, 6) == "IMPORT") {
-      if (!options.IsActive(ErrorCode::kImport, i)) continue;
-      i += 6;
-      std::string word = ConvertToUppercase(GetNextWord(sql, &i));
-      if (word == "PROTO" || word == "MODULE") {
-        int type = (word == "PROTO" ? 1 : 2);
-        // Mixed check, There will be no PROTO-MODULE-PROTO
-        // or MODULE-PROTO-MODULE.
-        if (first_type == type && second_type != 0)
-          result.Add(ErrorCode::kImport, sql, i,
-                     "PROTO and MODULE inputs should be in separate groups.");
-        if (first_type == 0)
-          first_type = type;
-        else if (second_type == 0 && type != first_type)
-          second_type = type;
-        std::string name = GetNextWord(sql, &i);
-        for (const std::string prev_name : imports)
-          if (prev_name == name) {
-            result.Add(ErrorCode::kImport, sql, i,
-                       absl::StrCat("\"", name, "\" is already defined."));
-            break;
-          }
-        imports.push_back(name);
-      } else {
-        result.Add(ErrorCode::kImport, sql, i,
-                   "Imports should specify the type 'MODULE' or 'PROTO'.");
-      }
+  for (const ImportUse &use : uses) {
+    if (use.type == 0) {
+      result.Add(ErrorCode::kImport, sql, use.type_end,
+                 "Imports should specify the type 'MODULE' or 'PROTO'.");
+      continue;
     }
+    // Mixed check, There will be no PROTO-MODULE-PROTO
+    // or MODULE-PROTO-MODULE.
+    if (first_type == use.type && second_type != 0)
+      result.Add(ErrorCode::kImport, sql, use.type_end,
+                 "PROTO and MODULE inputs should be in separate groups.");
+    if (first_type == 0)
+      first_type = use.type;
+    else if (second_type == 0 && use.type != first_type)
+      second_type = use.type;
+    for (const std::string &prev_name : imports)
+      if (prev_name == use.name) {
+        result.Add(ErrorCode::kImport, sql, use.name_end,
+                   absl::StrCat("\"", use.name, "\" is already defined."));
+        break;
+      }
+    imports.push_back(use.name);
   }
   return result;
 }
 
+LinterResult CheckImports(absl::string_view sql, const LinterOptions &options) {
+  std::vector<ImportUse> uses;
+  ScanImports(sql, options, &uses);
+  return EvaluateImports(sql, uses);
+}
+
 LinterResult CheckExpressionParantheses(absl::string_view sql,
                                         const LinterOptions &options) {
   return ASTNodeRule([](const ASTNode *node, const absl::string_view &sql,
@@ -426,25 +521,22 @@ LinterResult CheckExpressionParantheses(absl::string_view sql,
 LinterResult CheckCountStar(absl::string_view sql,
                             const LinterOptions &options) {
   LinterResult result;
-  for (int i = 0; i < static_cast<int>(sql.size()); i++) {
-    IgnoreComments(sql, options, &i);
-    IgnoreStrings(sql, &i);
-    if (i + 5 < static_cast<int>(sql.size()) &&
-        absl::EqualsIgnoreCase(sql.substr(i, 5), "COUNT")) {
-      i += 5;
-      if (IgnoreSpacesForward(sql, &i)) continue;
-      if (sql[i] != '(') continue;
-      i++;
-      if (IgnoreSpacesForward(sql, &i)) continue;
-      if (sql[i] != '1') continue;
-      i++;
-      if (IgnoreSpacesForward(sql, &i)) continue;
-      if (sql[i] != ')') continue;
-
-      if (options.IsActive(ErrorCode::kCountStar, i))
-        result.Add(ErrorCode::kCountStar, sql, i,
-                   "Use COUNT(*) instead of COUNT(1)");
-    }
+  for (const TextMatch &match : *GetTextMatches(sql, options)) {
+    if (match.pattern != TextPattern::kCount) continue;
+    int i = match.position + 5;
+    if (IgnoreSpacesForward(sql, &i)) continue;
+    if (sql[i] != '(') continue;
+    i++;
+    if (IgnoreSpacesForward(sql, &i)) continue;
+    if (sql[i] != '1') continue;
+    const int one = i;
+    i++;
+    if (IgnoreSpacesForward(sql, &i)) continue;
+    if (sql[i] != ')') continue;
+
+    if (options.IsActive(ErrorCode::kCountStar, i))
+      result.Add(ErrorCode::kCountStar, sql, i,
+                 "Use COUNT(*) instead of COUNT(1)", {{one, 1, "*"}});
   }
   return result;
 }
@@ -452,33 +544,203 @@ LinterResult CheckCountStar(absl::string_view sql,
 LinterResult CheckKeywordNamedIdentifier(absl::string_view sql,
                                          const LinterOptions &options) {
   LinterResult result;
-  std::vector<ParseToken> keywords =
-      GetKeywords(sql, ErrorCode::kKeywordIdentifier);
-  std::vector<const ASTNode *> identifiers = GetIdentifiers(sql, options);
-  int index = 0;
-  for (auto &token : keywords) {
-    // Two pointer algorithm to reduce complexity O(N^2) to O(N)
-    while (index < identifiers.size() && IsBefore(identifiers[index], token))
-      index++;
+  for (const ASTNode *identifier : GetIdentifiers(sql, options)) {
+    // Escaped identifiers include their backticks, so they aren't keywords.
+    absl::string_view name = GetNodeString(identifier, sql);
+    if (!(IdentifierTable::Shared().Styles(name) & kKeyword)) continue;
+    int position = GetStartPosition(*identifier);
+    if (options.IsActive(ErrorCode::kKeywordIdentifier, position))
+      result.Add(ErrorCode::kKeywordIdentifier, sql, position,
+                 absl::StrCat("Identifier `", name,
+                              "` is an SQL keyword. Change the name or escape "
+                              "with backticks (`)"));
+  }
+  return result;
+}
 
-    // The Identifier is also a keyword
-    if (index < identifiers.size() && IsTheSame(identifiers[index], token)) {
-      int position = token.GetLocationRange().start().GetByteOffset();
-      if (options.IsActive(ErrorCode::kKeywordIdentifier, position))
-        result.Add(
-            ErrorCode::kKeywordIdentifier, sql, position,
-            absl::StrCat("Identifier `", token.GetImage(),
-                         "` is an SQL keyword. Change the name or escape with "
-                         "backticks (`)"));
+LinterResult CheckUtf8Encoding(absl::string_view sql,
+                               const LinterOptions &options) {
+  LinterResult result;
+  const ByteSet delimiter({static_cast<char>(options.LineDelimeter())});
+  int line_start = 0;
+  while (line_start < static_cast<int>(sql.size())) {
+    const int invalid = FindInvalidUtf8(sql.substr(line_start));
+    if (invalid < 0) break;
+    const int i = line_start + invalid;
+    if (options.IsActive(ErrorCode::kUtf8Encoding, i))
+      result.Add(ErrorCode::kUtf8Encoding, sql, i,
+                 absl::StrCat("Invalid UTF-8 byte 0x",
+                              absl::Hex(static_cast<unsigned char>(sql[i]),
+                                        absl::kZeroPad2),
+                              ", files should be encoded in UTF-8"));
+    // Only the first invalid byte of a line is reported.
+    line_start = FindFirstOf(sql, i + 1, delimiter) + 1;
+  }
+  return result;
+}
+
+LinterResult CheckCustomRules(absl::string_view sql,
+                              const LinterOptions &options) {
+  if (options.CustomRules() == nullptr) return LinterResult();
+  return options.CustomRules()->Check(sql, options);
+}
+
+LinterResult CheckAstRules(absl::string_view sql,
+                           const LinterOptions &options) {
+  if (options.AstRules() == nullptr) return LinterResult();
+  return options.AstRules()->Check(sql, options);
+}
+
+namespace {
+
+// Reports an analyzer error of the statement at <start> if it is a finding of
+// a semantic check, like an unrecognized name.
+void AddAnalyzerError(absl::string_view sql, int start,
+                      const absl::Status &status, const LinterOptions &options,
+                      LinterResult *result) {
+  absl::string_view message = status.message();
+  ErrorCode code;
+  if (absl::StartsWith(message, "Unrecognized name:") ||
+      absl::StrContains(message, " not found inside ")) {
+    code = ErrorCode::kUnknownColumn;
+  } else if (absl::StrContains(message, " is ambiguous")) {
+    code = ErrorCode::kAmbiguousColumn;
+  } else {
+    // Other errors, like unknown tables, are not findings.
+    return;
+  }
+  ErrorLocation location;
+  if (!GetErrorLocation(status, &location)) return;
+  const int position = start + ByteOffsetOf(sql.substr(start), location.line(),
+                                            location.column());
+  if (options.IsActive(code, position))
+    result->Add(code, sql, position, std::string(message));
+}
+
+// Adds equality comparisons of the conjunction <condition> to <equalities>.
+void AddEqualities(const ResolvedExpr *condition,
+                   std::vector<const ResolvedFunctionCall *> *equalities) {
+  if (condition->node_kind() != RESOLVED_FUNCTION_CALL) return;
+  const auto *call = condition->GetAs<ResolvedFunctionCall>();
+  const std::string &name = call->function()->Name();
+  if (name == "$and") {
+    for (int i = 0; i < call->argument_list_size(); ++i)
+      AddEqualities(call->argument_list(i), equalities);
+  } else if (name == "$equal") {
+    equalities->push_back(call);
+  }
+}
+
+// Returns if <cast> is an implicit coercion of a column, not a CAST in sql.
+// An implicit cast doesn't have a parse location of its own.
+bool IsImplicitColumnCast(const ResolvedExpr *expr) {
+  if (expr->node_kind() != RESOLVED_CAST) return false;
+  const auto *cast = expr->GetAs<ResolvedCast>();
+  if (cast->expr()->node_kind() != RESOLVED_COLUMN_REF) return false;
+  const ParseLocationRange *cast_range = cast->GetParseLocationRangeOrNULL();
+  const ParseLocationRange *column_range =
+      cast->expr()->GetParseLocationRangeOrNULL();
+  return cast_range == nullptr ||
+         (column_range != nullptr &&
+          cast_range->start() == column_range->start() &&
+          cast_range->end() == column_range->end());
+}
+
+// Reports join keys of <statement> at <start> that are compared after an
+// implicit cast, e.g. an INT64 key with a FLOAT64 key.
+void AddJoinKeyTypes(absl::string_view sql, int start,
+                     const ResolvedStatement &statement,
+                     const LinterOptions &options, LinterResult *result) {
+  std::vector<const ResolvedNode *> joins;
+  statement.GetDescendantsWithKinds({RESOLVED_JOIN_SCAN}, &joins);
+  for (const ResolvedNode *node : joins) {
+    const ResolvedExpr *condition =
+        node->GetAs<ResolvedJoinScan>()->join_expr();
+    if (condition == nullptr) continue;
+    std::vector<const ResolvedFunctionCall *> equalities;
+    AddEqualities(condition, &equalities);
+    for (const ResolvedFunctionCall *equality : equalities) {
+      for (const auto &argument : equality->argument_list()) {
+        if (!IsImplicitColumnCast(argument.get())) continue;
+        const auto *cast = argument->GetAs<ResolvedCast>();
+        const ParseLocationRange *range =
+            equality->GetParseLocationRangeOrNULL();
+        const int position =
+            start + (range == nullptr ? 0 : range->start().GetByteOffset());
+        if (options.IsActive(ErrorCode::kJoinKeyType, position))
+          result->Add(
+              ErrorCode::kJoinKeyType, sql, position,
+              absl::StrCat("Join keys have different types, ",
+                           cast->expr()->type()->TypeName(PRODUCT_EXTERNAL),
+                           " key is cast to ",
+                           cast->type()->TypeName(PRODUCT_EXTERNAL)));
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+LinterResult CheckSemantics(absl::string_view sql,
+                            const LinterOptions &options) {
+  LinterResult result;
+  SchemaCatalog *catalog = options.Catalog().get();
+  if (catalog == nullptr) return result;
+
+  for (const auto &[start, end] : StatementRanges(sql)) {
+    // Statements are analyzed only for active checks, and only queries are
+    // analyzed.
+    if (!options.IsActive(ErrorCode::kUnknownColumn, start) &&
+        !options.IsActive(ErrorCode::kAmbiguousColumn, start) &&
+        !options.IsActive(ErrorCode::kJoinKeyType, start))
+      continue;
+    const absl::string_view statement = sql.substr(start, end - start);
+    if (GetNextStatementKind(ParseResumeLocation::FromStringView(statement),
+                             catalog->analyzer_options().language()) !=
+        AST_QUERY_STATEMENT)
+      continue;
+
+    std::unique_ptr<const AnalyzerOutput> output;
+    absl::Status status =
+        AnalyzeStatement(statement, catalog->analyzer_options(), catalog,
+                         catalog->type_factory(), &output);
+    if (!status.ok()) {
+      AddAnalyzerError(sql, start, status, options, &result);
+      continue;
     }
+    AddJoinKeyTypes(sql, start, *output->resolved_statement(), options,
+                    &result);
   }
   return result;
 }
 
 LinterResult CheckSpecifyTable(absl::string_view sql,
                                const LinterOptions &options) {
-  LinterResult result;
+  // If parser is not active from config this check won't work.
+  if (!options.IsActive(ErrorCode::kParseFailed, -1)) return LinterResult();
 
+  LinterResult result;
+  ForEachStatement(sql, options, [&](const ASTNode *statement) {
+    const QueryScopes scopes = BuildQueryScopes(statement);
+    for (const ColumnReference &column : scopes.columns) {
+      const QueryScope &scope = scopes.scopes[column.scope];
+      if (!scope.has_join || column.path->num_names() != 1) continue;
+      // Whole rows of tables, columns of USING clauses and aliases of the
+      // select list don't belong to a single table.
+      const std::string name = column.path->first_name()->GetAsString();
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      if (scope.table_names.contains(lower_name) ||
+          scope.using_columns.contains(lower_name) ||
+          scope.output_aliases.contains(lower_name))
+        continue;
+      int position = GetStartPosition(*column.path);
+      if (options.IsActive(ErrorCode::kSpecifyTable, position))
+        result.Add(ErrorCode::kSpecifyTable, sql, position,
+                   absl::StrCat("Specify the table of column `", name,
+                                "` in a query with JOIN"));
+    }
+  });
   return result;
 }
 
@@ -67,6 +67,25 @@ LinterResult CheckUppercaseKeywords(absl::string_view sql,
 LinterResult CheckCommentType(absl::string_view sql,
                               const LinterOptions &options);
 
+// A one line comment, as found by 'ScanCommentTypes'.
+struct CommentUse {
+  // Position of the comment's second character ('#' for '#' comments).
+  int position;
+  // "--", "//" or "#".
+  absl::string_view type;
+  // If 'consistent-comment-style' is active at the comment.
+  bool active;
+};
+
+// 'CheckCommentType' compares comments of a whole file. It is split in two
+// steps, so that parts of a file can be scanned separately and evaluated
+// together: 'ScanCommentTypes' appends one line comments in <sql> to <uses>,
+// and 'EvaluateCommentTypes' reports inconsistent ones.
+void ScanCommentTypes(absl::string_view sql, const LinterOptions &options,
+                      std::vector<CommentUse> *uses);
+LinterResult EvaluateCommentTypes(absl::string_view sql,
+                                  const std::vector<CommentUse> &uses);
+
 // Checks whether all aliases denoted by 'AS' keyword.
 LinterResult CheckAliasKeyword(absl::string_view sql,
                                const LinterOptions &options);
@@ -95,6 +114,23 @@ LinterResult CheckJoin(absl::string_view sql, const LinterOptions &options);
 // Also checks if there is a dublicate import.
 LinterResult CheckImports(absl::string_view sql, const LinterOptions &options);
 
+// An import with active 'imports' check, as found by 'ScanImports'.
+struct ImportUse {
+  // 1 for PROTO, 2 for MODULE and 0 if the type is missing.
+  int type = 0;
+  // Positions just after the type and the name.
+  int type_end = 0;
+  int name_end = 0;
+  std::string name;
+};
+
+// Split steps of 'CheckImports', same with 'ScanCommentTypes' and
+// 'EvaluateCommentTypes'.
+void ScanImports(absl::string_view sql, const LinterOptions &options,
+                 std::vector<ImportUse> *uses);
+LinterResult EvaluateImports(absl::string_view sql,
+                             const std::vector<ImportUse> &uses);
+
 // Checks if any complex expression is without parantheses.
 LinterResult CheckExpressionParantheses(absl::string_view sql,
                                         const LinterOptions &options);
@@ -107,7 +143,27 @@ LinterResult CheckCountStar(absl::string_view sql,
 LinterResult CheckKeywordNamedIdentifier(absl::string_view sql,
                                          const LinterOptions &options);
 
-// Checks if table names are specified in a query containing "JOIN".
+// Checks if the sql is valid UTF-8. The first invalid byte of every line is
+// reported.
+LinterResult CheckUtf8Encoding(absl::string_view sql,
+                               const LinterOptions &options);
+
+// Checks the custom regular expression rules of the configuration.
+LinterResult CheckCustomRules(absl::string_view sql,
+                              const LinterOptions &options);
+
+// Checks the syntax tree rules of the configuration.
+LinterResult CheckAstRules(absl::string_view sql,
+                           const LinterOptions &options);
+
+// Checks queries against the schema of the configuration: unknown and
+// ambiguous column names, and join keys of different types. Only queries
+// whose tables are all in the schema are checked.
+LinterResult CheckSemantics(absl::string_view sql,
+                            const LinterOptions &options);
+
+// Checks if table names are specified in a query containing "JOIN". Columns
+// of USING clauses and aliases of the select list don't need a table.
 LinterResult CheckSpecifyTable(absl::string_view sql,
                                const LinterOptions &options);
 }  // namespace zetasql::linter
@@ -41,6 +41,56 @@ ChecksList GetParserDependantChecks() {
   list.Add(CheckNames);
   list.Add(CheckJoin);
   list.Add(CheckExpressionParantheses);
+  list.Add(CheckAstRules);
+  list.Add(CheckSemantics);
+  list.Add(CheckSpecifyTable);
+  return list;
+}
+
+ChecksList GetLiteralSensitiveChecks() {
+  ChecksList list;
+  list.Add(CheckLineLength);
+  list.Add(CheckTabCharactersUniform);
+  list.Add(CheckNoTabsBesidesIndentations);
+  list.Add(CheckSingleQuotes);
+  list.Add(CheckImports);
+  list.Add(CheckCountStar);
+  list.Add(CheckUtf8Encoding);
+  list.Add(CheckCustomRules);
+  return list;
+}
+
+ChecksList GetStatementLocalChecks() {
+  ChecksList list;
+  list.Add(CheckLineLength);
+  list.Add(CheckSemicolon);
+  list.Add(CheckUppercaseKeywords);
+  list.Add(CheckAliasKeyword);
+  list.Add(CheckTabCharactersUniform);
+  list.Add(CheckNoTabsBesidesIndentations);
+  list.Add(CheckSingleQuotes);
+  list.Add(CheckNames);
+  list.Add(CheckJoin);
+  list.Add(CheckExpressionParantheses);
+  list.Add(CheckCountStar);
+  list.Add(CheckKeywordNamedIdentifier);
+  list.Add(CheckUtf8Encoding);
+  list.Add(CheckCustomRules);
+  list.Add(CheckAstRules);
+  list.Add(CheckSemantics);
+  list.Add(CheckSpecifyTable);
+  return list;
+}
+
+ChecksList GetParserIndependentChecks() {
+  ChecksList list;
+  list.Add(CheckLineLength);
+  list.Add(CheckTabCharactersUniform);
+  list.Add(CheckNoTabsBesidesIndentations);
+  list.Add(CheckSingleQuotes);
+  list.Add(CheckCountStar);
+  list.Add(CheckUtf8Encoding);
+  list.Add(CheckCustomRules);
   return list;
 }
 
@@ -60,6 +110,11 @@ ChecksList GetAllChecks() {
   list.Add(CheckExpressionParantheses);
   list.Add(CheckCountStar);
   list.Add(CheckKeywordNamedIdentifier);
+  list.Add(CheckUtf8Encoding);
+  list.Add(CheckCustomRules);
+  list.Add(CheckAstRules);
+  list.Add(CheckSemantics);
+  list.Add(CheckSpecifyTable);
   return list;
 }
 
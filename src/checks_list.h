@@ -51,6 +51,21 @@ class ChecksList {
 // This function gives all Checks that are using ZetaSQL parser.
 ChecksList GetParserDependantChecks();
 
+// This function gives all Checks whose results depend on the contents of
+// literals, not only on their positions. Results of other checks are the same
+// for queries that differ only in literals.
+ChecksList GetLiteralSensitiveChecks();
+
+// This function gives all Checks whose results in a statement don't depend
+// on other statements of the file. 'CheckCommentType' and 'CheckImports' are
+// the only other checks, and they have split scan and evaluate steps for
+// linting statements separately.
+ChecksList GetStatementLocalChecks();
+
+// This function gives the statement local Checks that don't use the ZetaSQL
+// parser, so they are meaningful for text that can't be parsed.
+ChecksList GetParserIndependentChecks();
+
 // This function is the main function to get all the checks.
 // Whenever a new check is added this should be
 // the first place to update.
@@ -18,6 +18,7 @@
 
 #include <cstdio>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -26,7 +27,9 @@
 #include "gtest/gtest.h"
 #include "src/checks_list.h"
 #include "src/checks_util.h"
+#include "src/fix_applier.h"
 #include "src/linter_options.h"
+#include "src/schema_catalog.h"
 
 namespace zetasql::linter {
 
@@ -377,7 +380,118 @@ TEST(LinterTest, CheckKeywordNamedIdentifier) {
       CheckKeywordNamedIdentifier("SELECT `Table`.column1", options).ok());
 }
 
-TEST(LinterTest, CheckSpecifyTable) { LinterOptions options; }
+TEST(LinterTest, Fixes) {
+  LinterOptions options;
+  // Returns <sql> with the fixes of <check> applied.
+  auto fixed = [&options](LinterResult (*check)(absl::string_view,
+                                                const LinterOptions &),
+                          absl::string_view sql) {
+    std::string output;
+    ApplyFixes(sql, check(sql, options), &output);
+    return output;
+  };
+  EXPECT_EQ(fixed(CheckCountStar, "SELECT count ( 1 ) FROM T;"),
+            "SELECT count ( * ) FROM T;");
+  EXPECT_EQ(fixed(CheckAliasKeyword, "SELECT a b FROM T;"),
+            "SELECT a AS b FROM T;");
+  EXPECT_EQ(fixed(CheckUppercaseKeywords, "select a From T;"),
+            "SELECT a FROM T;");
+  EXPECT_EQ(fixed(CheckNoTabsBesidesIndentations, "\tSELECT\ta;"),
+            "\tSELECT a;");
+  // Strings that would change with other quotes are not fixed.
+  EXPECT_EQ(fixed(CheckSingleQuotes, "SELECT \"a\", \"it's\", \"\\n\";"),
+            "SELECT 'a', \"it's\", \"\\n\";");
+}
+
+TEST(LinterTest, CheckUtf8Encoding) {
+  LinterOptions options;
+  EXPECT_TRUE(CheckUtf8Encoding("SELECT 'café' AS `日本`; -- 🙂\n", options)
+                  .ok());
+
+  LinterResult result = CheckUtf8Encoding(
+      "SELECT 'é', 'caf\xE9\xE9';\nSELECT '\xFF';", options);
+  std::vector<LintError> errors = result.GetErrors();
+  ASSERT_EQ(errors.size(), 2);
+  // Columns are counted in characters.
+  EXPECT_EQ(errors[0].GetPosition(), std::make_pair(1, 17));
+  EXPECT_EQ(errors[1].GetPosition(), std::make_pair(2, 9));
+
+  // Non-ASCII characters count as one for line length.
+  options.SetLineLimit(13);
+  EXPECT_TRUE(CheckLineLength("SELECT 'ééé';\n", options).ok());
+  EXPECT_FALSE(CheckLineLength("SELECT 'éééé';\n", options).ok());
+}
+
+TEST(LinterTest, CheckSemantics) {
+  LinterOptions options;
+  // Without a schema, nothing is analyzed.
+  EXPECT_TRUE(CheckSemantics("SELECT missing FROM ds.orders;", options).ok());
+
+  std::string filename = testing::TempDir() + "/checks_schema.bin";
+  ASSERT_TRUE(WriteSchema("ds.orders,id,INT64\n"
+                          "ds.orders,user_id,INT64\n"
+                          "ds.users,id,INT64\n"
+                          "ds.users,score,FLOAT64\n",
+                          filename)
+                  .ok());
+  std::shared_ptr<SchemaCatalog> catalog;
+  ASSERT_TRUE(SchemaCatalog::Shared(filename, &catalog).ok());
+  options.SetCatalog(catalog);
+
+  EXPECT_TRUE(CheckSemantics("SELECT o.id FROM ds.orders o JOIN ds.users u "
+                             "ON o.user_id = u.id;",
+                             options)
+                  .ok());
+  // Queries of unknown tables are not checked.
+  EXPECT_TRUE(CheckSemantics("SELECT missing FROM ds.other;", options).ok());
+
+  absl::string_view sql =
+      "SELECT 1;\n"
+      "SELECT missing FROM ds.orders;\n"
+      "SELECT id FROM ds.orders o JOIN ds.users u ON o.user_id = u.id;\n"
+      "SELECT o.id FROM ds.orders o JOIN ds.users u ON o.user_id = u.score;";
+  std::vector<LintError> errors = CheckSemantics(sql, options).GetErrors();
+  ASSERT_EQ(errors.size(), 3);
+  EXPECT_EQ(errors[0].GetType(), ErrorCode::kUnknownColumn);
+  EXPECT_EQ(errors[0].GetPosition(), std::make_pair(2, 8));
+  EXPECT_EQ(errors[1].GetType(), ErrorCode::kAmbiguousColumn);
+  EXPECT_EQ(errors[1].GetPosition(), std::make_pair(3, 8));
+  EXPECT_EQ(errors[2].GetType(), ErrorCode::kJoinKeyType);
+  EXPECT_EQ(errors[2].GetLineNumber(), 4);
+
+  options.DisableCheck(ErrorCode::kUnknownColumn);
+  options.DisableCheck(ErrorCode::kAmbiguousColumn);
+  options.DisableCheck(ErrorCode::kJoinKeyType);
+  EXPECT_TRUE(CheckSemantics(sql, options).ok());
+}
+
+TEST(LinterTest, CheckSpecifyTable) {
+  LinterOptions options;
+  EXPECT_TRUE(CheckSpecifyTable("SELECT a FROM t WHERE b > 0;", options).ok());
+  EXPECT_TRUE(CheckSpecifyTable("SELECT t.a, u.b AS c FROM t INNER JOIN u "
+                                "ON t.k = u.k ORDER BY c;",
+                                options)
+                  .ok());
+  // Columns of USING and whole rows don't belong to a single table.
+  EXPECT_TRUE(
+      CheckSpecifyTable("SELECT k, u FROM t INNER JOIN u USING (k);", options)
+          .ok());
+
+  std::vector<LintError> errors =
+      CheckSpecifyTable(
+          "SELECT a, t.b FROM t INNER JOIN u ON t.k = k\n"
+          "WHERE EXISTS (SELECT c FROM v);",
+          options)
+          .GetErrors();
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors[0].GetPosition(), std::make_pair(1, 8));
+  EXPECT_EQ(errors[1].GetPosition(), std::make_pair(1, 44));
+
+  options.DisableCheck(ErrorCode::kSpecifyTable);
+  EXPECT_TRUE(CheckSpecifyTable("SELECT a FROM t INNER JOIN u ON t.k = u.k;",
+                                options)
+                  .ok());
+}
 
 }  // namespace
 }  // namespace zetasql::linter
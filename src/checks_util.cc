@@ -22,9 +22,11 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "src/byte_scan.h"
 #include "src/lint_error.h"
 #include "src/linter_options.h"
 #include "zetasql/parser/parse_tree.h"
@@ -54,27 +56,19 @@ int GetStartPosition(const ParseToken &token) {
 
 bool IsUppercase(char c) { return 'A' <= c && c <= 'Z'; }
 bool IsLowercase(char c) { return 'a' <= c && c <= 'z'; }
-
-std::string ConvertToUppercase(absl::string_view name) {
-  std::string ret = "";
-  for (char c : name) {
-    if (IsLowercase(c))
-      ret += (c - 'z' + 'Z');
-    else
-      ret += c;
-  }
-  return ret;
-}
+bool IsAsciiCharacter(char c) { return (c & 0x80) == 0; }
 
 bool IsUpperCamelCase(absl::string_view name) {
-  if (!name.empty() && !IsUppercase(name[0])) return false;
+  if (!name.empty() && !IsUppercase(name[0]) && IsAsciiCharacter(name[0]))
+    return false;
   for (char c : name)
     if (c == '_') return false;
   return true;
 }
 
 bool IsLowerCamelCase(absl::string_view name) {
-  if (!name.empty() && !IsLowercase(name[0])) return false;
+  if (!name.empty() && !IsLowercase(name[0]) && IsAsciiCharacter(name[0]))
+    return false;
   for (char c : name)
     if (c == '_') return false;
   return true;
@@ -129,11 +123,10 @@ bool IgnoreComments(absl::string_view sql, const LinterOptions &options,
     // It will start checking after '/*' and after the iteration
     // finished, the pointer 'i' will be just after '*/' (incrementation
     // from the for statement is included).
-    i += 3;
-    while (i < static_cast<int>(sql.size()) &&
-           !(sql[i - 1] == '*' && sql[i] == '/')) {
-      ++i;
-    }
+    static const ByteSet *kSlash = new ByteSet({'/'});
+    i = FindFirstOf(sql, i + 3, *kSlash);
+    while (i < static_cast<int>(sql.size()) && sql[i - 1] != '*')
+      i = FindFirstOf(sql, i + 1, *kSlash);
     return 1;
   }
 
@@ -143,10 +136,8 @@ bool IgnoreComments(absl::string_view sql, const LinterOptions &options,
                           ((sql[i] == '-' && sql[i + 1] == '-') ||
                            (sql[i] == '/' && sql[i + 1] == '/')))) {
       // Ignore the line.
-      while (i < static_cast<int>(sql.size()) &&
-             sql[i] != options.LineDelimeter()) {
-        ++i;
-      }
+      i = FindFirstOf(sql, i,
+                      ByteSet({static_cast<char>(options.LineDelimeter())}));
       return 1;
     }
   }
@@ -171,17 +162,16 @@ bool IgnoreStrings(absl::string_view sql, int *position) {
   return 0;
 }
 
-std::string GetNextWord(absl::string_view sql, int *position) {
+absl::string_view GetNextWord(absl::string_view sql, int *position) {
   int &i = *position;
   while (i < sql.size() && (sql[i] == ' ' || sql[i] == '\t')) i++;
-  std::string word = "";
+  const int start = i;
   while (i < sql.size() &&
          !(sql[i] == ' ' || sql[i] == '\t' || sql[i] == '\n' || sql[i] == ';' ||
            sql[i] == '(' || sql[i] == ',')) {
-    word += sql[i];
     i++;
   }
-  return word;
+  return sql.substr(start, i - start);
 }
 
 LinterResult PrintASTTree(absl::string_view sql) {
@@ -208,17 +198,17 @@ LinterResult PrintASTTree(absl::string_view sql) {
 }
 
 bool OneLineStatement(absl::string_view line) {
+  static constexpr absl::string_view kLastWords[] = {
+      "FUNCTION", "EXISTS", "TABLE", "TYPE", "VIEW", "=", "PROTO", "MODULE"};
   bool first = true;
   bool last = false;
   bool finish = false;
-  std::vector<std::string> last_words{"FUNCTION", "EXISTS", "TABLE", "TYPE",
-                                      "VIEW",     "=",      "PROTO", "MODULE"};
-  for (auto word : absl::StrSplit(line, ' ')) {
+  for (absl::string_view word : absl::StrSplit(line, ' ')) {
     if (word.empty()) continue;
     if (finish) return false;
-    std::string uppercase_word = ConvertToUppercase(word);
     if (first) {
-      if (uppercase_word != "CREATE" && uppercase_word != "IMPORT")
+      if (!absl::EqualsIgnoreCase(word, "CREATE") &&
+          !absl::EqualsIgnoreCase(word, "IMPORT"))
         return false;
       first = false;
       continue;
@@ -227,8 +217,8 @@ bool OneLineStatement(absl::string_view line) {
       finish = true;
       continue;
     }
-    for (auto &last_word : last_words)
-      if (uppercase_word == last_word) {
+    for (absl::string_view last_word : kLastWords)
+      if (absl::EqualsIgnoreCase(word, last_word)) {
         if (last_word == "=") finish = true;
         last = true;
       }
@@ -252,6 +242,20 @@ bool ConsistentUppercaseLowercase(const absl::string_view &sql,
   return !uppercase;
 }
 
+int ByteOffsetOf(absl::string_view sql, int line, int column) {
+  const int size = sql.size();
+  int i = 0;
+  for (int current = 1; current < line && i < size; ++i) {
+    if (sql[i] == '\n' ||
+        (sql[i] == '\r' && (i + 1 == size || sql[i + 1] != '\n')))
+      ++current;
+  }
+  for (int current = 1;
+       current < column && i < size && sql[i] != '\n' && sql[i] != '\r'; ++i)
+    current = sql[i] == '\t' ? (current - 1) / 8 * 8 + 9 : current + 1;
+  return i;
+}
+
 LinterResult ASTNodeRule::ApplyTo(absl::string_view sql,
                                   const LinterOptions &options) {
   RuleVisitor visitor(rule_, sql, options);
@@ -306,6 +310,51 @@ std::vector<ParseToken> GetKeywords(absl::string_view sql, ErrorCode code) {
   return keywords;
 }
 
+std::shared_ptr<const std::vector<ParseToken>> GetKeywords(
+    absl::string_view sql, const LinterOptions &options, ErrorCode code) {
+  if (options.Keywords() != nullptr) return options.Keywords();
+  return std::make_shared<const std::vector<ParseToken>>(
+      GetKeywords(sql, code));
+}
+
+std::vector<TextMatch> FindTextPatterns(absl::string_view sql,
+                                        const LinterOptions &options) {
+  static const PatternMatcher *kMatcher =
+      new PatternMatcher(TextPatternStrings());
+  // Strings and comments start with one of these, other bytes are only
+  // passed to the automaton.
+  static const ByteSet *kStarts = new ByteSet({'\'', '"', '-', '/', '#'});
+  std::vector<TextMatch> matches;
+  ByteScanner scanner(sql, *kStarts);
+  int next = scanner.Next(0);
+  int state = PatternMatcher::kStart;
+  for (int i = 0; i < static_cast<int>(sql.size()); ++i) {
+    if (i == next) {
+      const bool skipped =
+          IgnoreComments(sql, options, &i) || IgnoreStrings(sql, &i);
+      next = scanner.Next(i + 1);
+      if (skipped) {
+        // Patterns don't continue over strings and comments.
+        state = PatternMatcher::kStart;
+        continue;
+      }
+    }
+    state = kMatcher->Next(state, sql[i]);
+    for (int pattern : kMatcher->Matches(state)) {
+      matches.push_back({static_cast<TextPattern>(pattern),
+                         i + 1 - kMatcher->PatternSize(pattern)});
+    }
+  }
+  return matches;
+}
+
+std::shared_ptr<const std::vector<TextMatch>> GetTextMatches(
+    absl::string_view sql, const LinterOptions &options) {
+  if (options.TextMatches() != nullptr) return options.TextMatches();
+  return std::make_shared<const std::vector<TextMatch>>(
+      FindTextPatterns(sql, options));
+}
+
 void GetIdentifiers(const ASTNode *node, std::vector<const ASTNode *> *list) {
   if (node->node_kind() == AST_IDENTIFIER) list->push_back(node);
   for (int i = 0; i < node->num_children(); i++)
@@ -339,4 +388,22 @@ std::vector<const ASTNode *> GetIdentifiers(absl::string_view sql,
   return identifiers;
 }
 
+void ForEachStatement(absl::string_view sql, const LinterOptions &options,
+                      const std::function<void(const ASTNode *)> &visit) {
+  if (options.RememberParser()) {
+    for (auto &output : options.ParserOutputs()) visit(output->statement());
+    return;
+  }
+  std::unique_ptr<ParserOutput> output;
+  ParseResumeLocation location = ParseResumeLocation::FromStringView(sql);
+
+  bool is_the_end = false;
+  while (!is_the_end) {
+    absl::Status status = ParseNextScriptStatement(&location, ParserOptions(),
+                                                   &output, &is_the_end);
+    if (!status.ok()) return;
+    visit(output->statement());
+  }
+}
+
 }  // namespace zetasql::linter
@@ -19,6 +19,8 @@
 
 // This class is for all the helper functions that checks use.
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +29,7 @@
 #include "absl/strings/string_view.h"
 #include "src/lint_error.h"
 #include "src/linter_options.h"
+#include "src/pattern_matcher.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_visitor.h"
 #include "zetasql/parser/parser.h"
@@ -95,8 +98,9 @@ bool IsUppercase(char c);
 // Checks if a character is lowercase.
 bool IsLowercase(char c);
 
-// Converts and returns all uppercase version of a name.
-std::string ConvertToUppercase(absl::string_view name);
+// Checks if a character is ASCII. Case of other characters isn't known, so
+// naming checks don't report names starting with them.
+bool IsAsciiCharacter(char c);
 
 // Checks if a name is written in UpperCamelCase.
 bool IsUpperCamelCase(absl::string_view name);
@@ -145,9 +149,14 @@ bool IgnoreComments(absl::string_view sql, const LinterOptions &options,
 bool IgnoreStrings(absl::string_view sql, int *position);
 
 // Given a position in a sql file, returns first word comes
-// after that position. The separator characters in a sql file will be :
-// ( ' ', '\t', '\n', ';', ',', '(' ).
-std::string GetNextWord(absl::string_view sql, int *position);
+// after that position, as a part of <sql>. The separator characters in a sql
+// file will be : ( ' ', '\t', '\n', ';', ',', '(' ).
+absl::string_view GetNextWord(absl::string_view sql, int *position);
+
+// Returns the byte offset of 1-based <line> and <column> in <sql>, counted
+// like ZetaSQL error locations with tabs expanded to multiples of 8.
+// Positions after the end of a line are moved to the end of the line.
+int ByteOffsetOf(absl::string_view sql, int line, int column);
 
 // Prints AST tree of an sql statement.
 LinterResult PrintASTTree(absl::string_view sql);
@@ -167,6 +176,21 @@ bool ConsistentUppercaseLowercase(const absl::string_view &sql,
 // They will be returned sorted in ascending position order.
 std::vector<ParseToken> GetKeywords(absl::string_view sql, ErrorCode code);
 
+// Same with above function, but returns the keywords in <options> if they
+// were already tokenized.
+std::shared_ptr<const std::vector<ParseToken>> GetKeywords(
+    absl::string_view sql, const LinterOptions &options, ErrorCode code);
+
+// Returns occurrences of all 'TextPattern's in code of a sql query, outside
+// of strings and comments, sorted by their end positions.
+std::vector<TextMatch> FindTextPatterns(absl::string_view sql,
+                                        const LinterOptions &options);
+
+// Same with above function, but returns the matches in <options> if they were
+// already found.
+std::shared_ptr<const std::vector<TextMatch>> GetTextMatches(
+    absl::string_view sql, const LinterOptions &options);
+
 // Helper function that adds all identifiers in subtree of a ASTNode
 // to a list.
 void GetIdentifiers(const ASTNode *node, std::vector<const ASTNode *> *list);
@@ -176,6 +200,12 @@ void GetIdentifiers(const ASTNode *node, std::vector<const ASTNode *> *list);
 std::vector<const ASTNode *> GetIdentifiers(absl::string_view sql,
                                             const LinterOptions &options);
 
+// Calls <visit> with the syntax tree of every statement, from previously
+// parsed AST if options has it. Stops at the first statement that can't be
+// parsed.
+void ForEachStatement(absl::string_view sql, const LinterOptions &options,
+                      const std::function<void(const ASTNode *)> &visit);
+
 }  // namespace zetasql::linter
 
 #endif  // SRC_CHECKS_UTIL_H_
@@ -16,8 +16,11 @@
 
 #include "src/checks_util.h"
 
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <new>
 #include <map>
 #include <string>
 #include <utility>
@@ -28,14 +31,24 @@
 #include "src/lint_error.h"
 #include "src/linter_options.h"
 
+// Heap allocations of the test, counted by the replaced 'operator new'.
+static std::atomic<int> allocations{0};
+
+void *operator new(size_t size) {
+  ++allocations;
+  if (void *pointer = malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+
 namespace zetasql::linter {
 
 namespace {
 
 TEST(CheckUtilTest, LetterCaseFunctionsCheck) {
-  EXPECT_EQ(ConvertToUppercase("mOdule"), "MODULE");
-  EXPECT_EQ(ConvertToUppercase("Here19_m"), "HERE19_M");
-
   EXPECT_TRUE(IsUpperCamelCase("LongName"));
   EXPECT_FALSE(IsUpperCamelCase("LONG_NAME"));
   EXPECT_TRUE(IsUpperCamelCase("LONGNAME"));
@@ -103,5 +116,65 @@ TEST(CheckUtilTest, OneLineStatementCheck) {
   EXPECT_TRUE(OneLineStatement("CREATE TEMPORARY FUNCTION A("));
 }
 
+TEST(CheckUtilTest, FindTextPatterns) {
+  LinterOptions options;
+  std::vector<TextMatch> matches = FindTextPatterns(
+      "IMPORT MODULE a; -- count\nSELECT 'count', Count(1) /* IMPORT */;",
+      options);
+  ASSERT_EQ(matches.size(), 2);
+  EXPECT_EQ(matches[0].pattern, TextPattern::kImport);
+  EXPECT_EQ(matches[0].position, 0);
+  EXPECT_EQ(matches[1].pattern, TextPattern::kCount);
+  EXPECT_EQ(matches[1].position, 42);
+}
+
+TEST(CheckUtilTest, ByteOffsetOf) {
+  absl::string_view sql = "SELECT 1;\r\nSELECT\tx;\rSELECT y";
+  EXPECT_EQ(ByteOffsetOf(sql, 1, 1), 0);
+  EXPECT_EQ(ByteOffsetOf(sql, 1, 8), 7);
+  // The tab spans columns 7 and 8.
+  EXPECT_EQ(ByteOffsetOf(sql, 2, 9), 18);
+  EXPECT_EQ(ByteOffsetOf(sql, 3, 8), 28);
+  EXPECT_EQ(ByteOffsetOf(sql, 1, 100), 9);
+  EXPECT_EQ(ByteOffsetOf(sql, 4, 1), static_cast<int>(sql.size()));
+}
+
+TEST(CheckUtilTest, TextHelpersDontAllocate) {
+  const std::string sql =
+      "IMPORT proto 'a/long/path/that/does/not/fit/in/a/small/string.proto';";
+  const std::string line =
+      "CREATE TEMPORARY FUNCTION AVeryLongFunctionNameThatIsNotShort(";
+  const std::string comments =
+      "/* A block comment that doesn't fit in a small string. */\n"
+      "-- A line comment that doesn't fit in a small string either.\n"
+      "SELECT 1;";
+  LinterOptions options;
+  // The first call sets up the byte set of block comments.
+  int comment_end = 0;
+  IgnoreComments(comments, options, &comment_end);
+
+  const int before = allocations;
+  int position = 6;
+  const absl::string_view type = GetNextWord(sql, &position);
+  const absl::string_view name = GetNextWord(sql, &position);
+  const bool one_line = OneLineStatement(line);
+  const bool not_one_line = OneLineStatement("create table T (a INT64);");
+  int block_end = 0;
+  const bool block = IgnoreComments(comments, options, &block_end);
+  int line_end = block_end + 2;
+  const bool line_comment = IgnoreComments(comments, options, &line_end);
+  const int count = allocations - before;
+
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(type, "proto");
+  EXPECT_EQ(name, "'a/long/path/that/does/not/fit/in/a/small/string.proto'");
+  EXPECT_TRUE(one_line);
+  EXPECT_FALSE(not_one_line);
+  EXPECT_TRUE(block);
+  EXPECT_EQ(comments[block_end], '/');
+  EXPECT_TRUE(line_comment);
+  EXPECT_EQ(comments.substr(line_end + 1), "SELECT 1;");
+}
+
 }  // namespace
 }  // namespace zetasql::linter
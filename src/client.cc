@@ -0,0 +1,103 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "src/file_utils.h"
+#include "src/lint_daemon.h"
+#include "src/wire_format.h"
+
+ABSL_FLAG(std::string, socket, "",
+          "Path of the Unix domain socket of the daemon.");
+
+ABSL_FLAG(std::string, config, "",
+          "A prototxt file having configuration options.");
+
+namespace zetasql::linter {
+namespace {
+
+// The daemon can run in another directory, it searches per directory
+// configuration files with absolute paths.
+std::string AbsolutePath(const std::string& filename) {
+  if (absl::StartsWith(filename, "/")) return filename;
+  char cwd[4096];
+  if (getcwd(cwd, sizeof(cwd)) == nullptr) return filename;
+  return absl::StrCat(cwd, "/", filename);
+}
+
+}  // namespace
+}  // namespace zetasql::linter
+
+int main(int argc, char* argv[]) {
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  std::string socket_path = absl::GetFlag(FLAGS_socket);
+  if (socket_path.empty()) {
+    std::cerr << "Usage: ./client --socket=<socket_path> "
+              << "--config=<config_file> <file_names>" << std::endl;
+    return 1;
+  }
+  // The first argument is './client'.
+  std::vector<std::string> sql_files;
+  absl::Status status = zetasql::linter::ExpandResponseFiles(
+      std::vector<std::string>(args.begin() + 1, args.end()), &sql_files);
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
+    return 1;
+  }
+
+  // All files are sent in one request.
+  zetasql::linter::LintRequest request;
+  std::string config_file = absl::GetFlag(FLAGS_config);
+  if (!config_file.empty())
+    request.config = zetasql::linter::ReadFile(config_file);
+  for (const std::string& filename : sql_files) {
+    request.files.push_back({zetasql::linter::AbsolutePath(filename),
+                             zetasql::linter::ReadFile(filename)});
+  }
+
+  zetasql::linter::LintResponse response;
+  status = zetasql::linter::CallLintDaemon(socket_path, request, &response);
+  if (status.ok() && !response.error.empty())
+    status = absl::InvalidArgumentError(response.error);
+  if (status.ok() && response.files.size() != sql_files.size())
+    status = absl::InternalError("Response doesn't match the request.");
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
+    return 1;
+  }
+
+  // Results are printed like the runner prints them.
+  for (int i = 0; i < static_cast<int>(sql_files.size()); ++i) {
+    for (const zetasql::linter::LintFinding& finding :
+         response.files[i].findings) {
+      std::cout << sql_files[i] << ":In line " << finding.line << ", column "
+                << finding.column << ": " << finding.message << " ["
+                << finding.check << "]" << std::endl;
+    }
+    std::cerr << "Linter is done processing file: " << sql_files[i]
+              << std::endl;
+  }
+  return 0;
+}
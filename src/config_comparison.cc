@@ -0,0 +1,96 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/config_comparison.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Findings of a file are matched by their check and position. Messages are
+// left out, as some of them depend on the configuration, e.g. the line limit.
+using FindingKey = std::tuple<ErrorCode, int, int>;
+
+FindingKey KeyOf(const LintError &error) {
+  const auto [line, column] = error.GetPosition();
+  return {error.GetType(), line, column};
+}
+
+}  // namespace
+
+ConfigComparison::ConfigComparison(std::vector<std::string> names)
+    : names_(std::move(names)), counts_(names_.size()) {}
+
+void ConfigComparison::Add(std::vector<LinterResult> results) {
+  // Findings are matched as multisets.
+  absl::flat_hash_map<FindingKey, int> first;
+  std::vector<LintError> first_errors = results[0].GetErrors();
+  for (LintError &error : first_errors) ++first[KeyOf(error)];
+  counts_[0].total += first_errors.size();
+
+  for (int i = 1; i < static_cast<int>(results.size()); ++i) {
+    Counts &counts = counts_[i];
+    absl::flat_hash_map<FindingKey, int> remaining = first;
+    std::vector<LintError> errors = results[i].GetErrors();
+    counts.total += errors.size();
+    for (LintError &error : errors) {
+      if (remaining[KeyOf(error)]-- <= 0)
+        ++counts.added[error.ErrorCodeToString()];
+    }
+    for (LintError &error : first_errors) {
+      if (remaining[KeyOf(error)]-- > 0)
+        ++counts.removed[error.ErrorCodeToString()];
+    }
+  }
+}
+
+std::string ConfigComparison::Summary() const {
+  std::string summary;
+  for (int i = 0; i < static_cast<int>(names_.size()); ++i) {
+    const Counts &counts = counts_[i];
+    absl::StrAppend(&summary, names_[i], ": ", counts.total, " findings");
+    if (i == 0) {
+      summary += "\n";
+      continue;
+    }
+    int added = 0, removed = 0;
+    for (const auto &[check, count] : counts.added) added += count;
+    for (const auto &[check, count] : counts.removed) removed += count;
+    absl::StrAppend(&summary, " (+", added, " -", removed, " compared to ",
+                    names_[0], ")\n");
+
+    std::map<std::string, std::pair<int, int>> checks;
+    for (const auto &[check, count] : counts.added) checks[check].first = count;
+    for (const auto &[check, count] : counts.removed)
+      checks[check].second = count;
+    for (const auto &[check, count] : checks)
+      absl::StrAppend(&summary, "  ", check, ": +", count.first, " -",
+                      count.second, "\n");
+  }
+  return summary;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,61 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_CONFIG_COMPARISON_H_
+#define SRC_CONFIG_COMPARISON_H_
+
+// Comparison of findings of the same files linted with several
+// configurations, to see the effect of a configuration change before
+// making it.
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+class ConfigComparison {
+ public:
+  // <names> are the names of the configurations, the first one is the
+  // baseline that others are compared with.
+  explicit ConfigComparison(std::vector<std::string> names);
+
+  // Adds the results of a file, one for each configuration in the same order
+  // with the names.
+  void Add(std::vector<LinterResult> results);
+
+  // Returns the number of findings of each configuration and, for the
+  // others, the findings they add and remove compared to the first one for
+  // each check.
+  std::string Summary() const;
+
+ private:
+  struct Counts {
+    int total = 0;
+    // Added and removed findings of each check.
+    std::map<std::string, int> added;
+    std::map<std::string, int> removed;
+  };
+
+  std::vector<std::string> names_;
+  std::vector<Counts> counts_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_CONFIG_COMPARISON_H_
@@ -0,0 +1,53 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/config_comparison.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(ConfigComparisonTest, Summary) {
+  ConfigComparison comparison({"current", "strict", "same"});
+
+  LinterResult current;
+  current.Add(ErrorCode::kAlias, 1, 10, "Always use AS keyword before aliases");
+  current.Add(ErrorCode::kLineLimit, 2, 121, "Lines should be <= 100 long.");
+  LinterResult strict;
+  strict.Add(ErrorCode::kAlias, 1, 10, "Always use AS keyword before aliases");
+  // The same line is over both limits, only the message differs.
+  strict.Add(ErrorCode::kLineLimit, 2, 121, "Lines should be <= 80 long.");
+  strict.Add(ErrorCode::kLineLimit, 3, 81, "Lines should be <= 80 long.");
+  comparison.Add({current, strict, current});
+  comparison.Add({LinterResult(), strict, LinterResult()});
+
+  EXPECT_EQ(comparison.Summary(),
+            "current: 2 findings\n"
+            "strict: 6 findings (+4 -0 compared to current)\n"
+            "  alias: +1 -0\n"
+            "  line-limit-exceed: +3 -0\n"
+            "same: 2 findings (+0 -0 compared to current)\n");
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
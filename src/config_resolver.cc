@@ -0,0 +1,251 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/config_resolver.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/text_format.h"
+#include "src/ast_rules.h"
+#include "src/config.pb.h"
+#include "src/custom_rules.h"
+#include "src/file_utils.h"
+#include "src/hash_util.h"
+#include "src/linter.h"
+#include "src/linter_options.h"
+#include "src/schema_catalog.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns the absolute path of the directory containing 'filename', without
+// '.' and '..' components. The root directory is returned as "/".
+std::string DirectoryOf(absl::string_view filename) {
+  std::string path;
+  if (filename.empty() || filename[0] != '/') {
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) != nullptr) path = cwd;
+    path += '/';
+  }
+  absl::StrAppend(&path, filename);
+
+  std::vector<absl::string_view> parts;
+  for (absl::string_view part : absl::StrSplit(path, '/')) {
+    if (part.empty() || part == ".") continue;
+    if (part == "..") {
+      if (!parts.empty()) parts.pop_back();
+      continue;
+    }
+    parts.push_back(part);
+  }
+  // The last part is the file name.
+  if (!parts.empty()) parts.pop_back();
+  return absl::StrCat("/", absl::StrJoin(parts, "/"));
+}
+
+std::string ParentOf(const std::string &dir) {
+  size_t slash = dir.rfind('/');
+  if (slash == 0) return "/";
+  return dir.substr(0, slash);
+}
+
+bool FileExists(const std::string &filename) {
+  struct stat st;
+  return stat(filename.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+}  // namespace
+
+absl::Status ReadConfigFile(absl::string_view filename, Config *config) {
+  std::string str = ReadFile(filename);
+  if (!google::protobuf::TextFormat::ParseFromString(str, config))
+    return absl::InvalidArgumentError(
+        absl::StrCat("Configuration file couldn't be parsed: ", filename));
+  absl::Status status = ValidateConfig(*config);
+  if (!status.ok())
+    return absl::InvalidArgumentError(
+        absl::StrCat(filename, ": ", status.message()));
+  return absl::OkStatus();
+}
+
+absl::Status ValidateConfig(const Config &config) {
+  // Invalid rules are reported once, instead of for every file.
+  if (config.custom_rule_size() > 0) {
+    std::unique_ptr<CustomRuleSet> rules;
+    absl::Status status = CustomRuleSet::Compile(config, &rules);
+    if (!status.ok()) return status;
+  }
+  if (config.ast_rule_size() > 0) {
+    std::unique_ptr<AstRuleSet> rules;
+    absl::Status status = AstRuleSet::Compile(config, &rules);
+    if (!status.ok()) return status;
+  }
+  if (config.has_schema()) {
+    std::shared_ptr<SchemaCatalog> catalog;
+    absl::Status status = SchemaCatalog::Shared(config.schema(), &catalog);
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+uint64_t ConfigFingerprint(const Config &config) {
+  // Config doesn't have map fields, so its serialization is deterministic.
+  uint64_t fingerprint = Fingerprint64(config.SerializeAsString());
+  // A schema can be rewritten without changing the configuration.
+  if (config.has_schema()) {
+    std::shared_ptr<SchemaCatalog> catalog;
+    if (SchemaCatalog::Shared(config.schema(), &catalog).ok())
+      fingerprint = CombineFingerprints(fingerprint, catalog->Fingerprint());
+  }
+  return fingerprint;
+}
+
+ResolvedConfig::ResolvedConfig(std::shared_ptr<const Config> config)
+    : config(std::move(config)) {
+  GetOptionsFromConfig(*this->config, &options);
+  fingerprint = ConfigFingerprint(*this->config);
+}
+
+bool ResolvedConfig::IsCurrent() const {
+  return options.Catalog() == nullptr || options.Catalog()->IsCurrent();
+}
+
+ConfigResolver::ConfigResolver(const Config &base,
+                               absl::string_view config_name)
+    : base_(std::make_shared<const Config>(base)), config_name_(config_name) {}
+
+std::shared_ptr<const Config> ConfigResolver::ConfigForFile(
+    absl::string_view filename) {
+  if (config_name_.empty()) return base_;
+  return ConfigForDirectory(DirectoryOf(filename));
+}
+
+std::shared_ptr<const ResolvedConfig> ConfigResolver::Resolve(
+    absl::string_view filename) {
+  std::shared_ptr<const Config> config = ConfigForFile(filename);
+  std::shared_ptr<const ResolvedConfig> resolved;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = resolved_.find(config.get());
+    if (it != resolved_.end()) resolved = it->second;
+  }
+  // The schema is checked without the lock, it stats the schema file.
+  if (resolved != nullptr && resolved->IsCurrent()) return resolved;
+
+  auto result = std::make_shared<const ResolvedConfig>(std::move(config));
+  absl::MutexLock lock(&mutex_);
+  // Options of merged configurations that were replaced, e.g. after their
+  // files changed, are only referenced from here.
+  for (auto it = resolved_.begin(); it != resolved_.end();) {
+    if (it->second->config.use_count() == 1)
+      resolved_.erase(it++);
+    else
+      ++it;
+  }
+  std::shared_ptr<const ResolvedConfig> &entry =
+      resolved_[result->config.get()];
+  // Same with 'ConfigForDirectory', the first current result is kept.
+  if (entry == nullptr || entry == resolved) entry = std::move(result);
+  return entry;
+}
+
+void ConfigResolver::Clear() {
+  absl::MutexLock lock(&mutex_);
+  cache_.clear();
+  resolved_.clear();
+}
+
+int ConfigResolver::LoadedConfigCount() {
+  absl::MutexLock lock(&mutex_);
+  return loaded_count_;
+}
+
+std::shared_ptr<const Config> ConfigResolver::ConfigForDirectory(
+    const std::string &dir) {
+  std::string config_file =
+      absl::StrCat(dir == "/" ? "" : dir, "/", config_name_);
+  // The file is stated before it is read, so a write in between is noticed
+  // by the next call.
+  const std::string stamp = FileStamp(config_file);
+  DirectoryConfig cached;
+  bool has_cached = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_.find(dir);
+    if (it != cache_.end()) {
+      cached = it->second;
+      has_cached = true;
+    }
+  }
+
+  std::shared_ptr<const Config> local;
+  bool loaded = false;
+  if (has_cached && cached.stamp == stamp) {
+    local = cached.local;
+  } else if (!stamp.empty() && FileExists(config_file)) {
+    auto config = std::make_shared<Config>();
+    absl::Status status = ReadConfigFile(config_file, config.get());
+    if (status.ok())
+      local = std::move(config);
+    else
+      std::cerr << status.message() << std::endl;
+    loaded = status.ok();
+  }
+
+  std::shared_ptr<const Config> parent;
+  if ((local != nullptr && local->root()) || dir == "/") {
+    parent = base_;
+  } else {
+    parent = ConfigForDirectory(ParentOf(dir));
+  }
+  if (has_cached && cached.stamp == stamp && cached.parent == parent)
+    return cached.merged;
+
+  DirectoryConfig entry{stamp, local, parent, parent};
+  if (local != nullptr) {
+    auto merged = std::make_shared<Config>(*parent);
+    merged->MergeFrom(*local);
+    merged->clear_root();
+    entry.merged = std::move(merged);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (loaded) ++loaded_count_;
+  // Another thread could resolve the same directory meanwhile, the first
+  // current result is kept so that all files share the same object.
+  DirectoryConfig &current = cache_[dir];
+  if (current.merged == nullptr || current.stamp != stamp ||
+      current.parent != parent)
+    current = std::move(entry);
+  return current.merged;
+}
+
+}  // namespace zetasql::linter
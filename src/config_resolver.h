@@ -0,0 +1,132 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_CONFIG_RESOLVER_H_
+#define SRC_CONFIG_RESOLVER_H_
+
+// Resolution of per directory configuration files.
+//
+// For a sql file, configuration files named <config_name> are searched in its
+// directory and all of its parent directories. The base configuration is
+// applied first, then the files from the outermost directory to the innermost
+// one. Later files override single valued options and add to 'nolint'.
+// A configuration file with 'root: true' stops the search.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/config.pb.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+// Default name of per directory configuration files.
+constexpr absl::string_view kDirectoryConfigName = ".zetasql-lint.textproto";
+
+// Reads a configuration file in text proto format, and validates it with
+// 'ValidateConfig'.
+absl::Status ReadConfigFile(absl::string_view filename, Config *config);
+
+// Returns an error if custom rules, syntax tree rules or the schema of
+// <config> are invalid. Checks would skip them for every file otherwise.
+absl::Status ValidateConfig(const Config &config);
+
+// Returns a fingerprint of all options in <config> and of the content of its
+// schema file. It is a part of the keys of cached lint results, so they are
+// not shared between configurations or versions of a schema.
+uint64_t ConfigFingerprint(const Config &config);
+
+// A merged configuration, with the options and the fingerprint of its checks.
+// They are computed once and shared by all files the configuration applies
+// to, each file copies the options and sets its filename.
+struct ResolvedConfig {
+  explicit ResolvedConfig(std::shared_ptr<const Config> config);
+
+  // Returns false if the schema of the configuration was rewritten since the
+  // options were computed.
+  bool IsCurrent() const;
+
+  const std::shared_ptr<const Config> config;
+  LinterOptions options;
+  uint64_t fingerprint;
+};
+
+class ConfigResolver {
+ public:
+  // If <config_name> is empty, every file gets the base configuration.
+  explicit ConfigResolver(
+      const Config &base,
+      absl::string_view config_name = kDirectoryConfigName);
+
+  // Returns the merged configuration for a sql file. Results are cached per
+  // directory. Each call only stats the configuration files of the directory
+  // and its parents, a configuration file is parsed again only if it was
+  // created, rewritten or removed since it was read. It is safe to call from
+  // multiple threads.
+  std::shared_ptr<const Config> ConfigForFile(absl::string_view filename);
+
+  // Returns the merged configuration for a sql file with its options and
+  // fingerprint. Results are cached per merged configuration, so directories
+  // without their own configuration file share the options of their parent.
+  // They are recomputed when one of the configuration files or the schema
+  // changes.
+  std::shared_ptr<const ResolvedConfig> Resolve(absl::string_view filename);
+
+  // Forgets all merged configurations, so configuration files are read
+  // again.
+  void Clear();
+
+  // Returns the number of configuration files parsed so far.
+  int LoadedConfigCount();
+
+ private:
+  // The configuration of a directory, and what it was merged from.
+  struct DirectoryConfig {
+    // Stamp of the configuration file of the directory, empty if it doesn't
+    // have one.
+    std::string stamp;
+    // The configuration file of the directory, null if it doesn't have a
+    // valid one.
+    std::shared_ptr<const Config> local;
+    // The merged configuration of the parent directory, or the base one.
+    std::shared_ptr<const Config> parent;
+    std::shared_ptr<const Config> merged;
+  };
+
+  // Returns the merged configuration for an absolute, normalized directory.
+  std::shared_ptr<const Config> ConfigForDirectory(const std::string &dir);
+
+  const std::shared_ptr<const Config> base_;
+  const std::string config_name_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, DirectoryConfig> cache_
+      ABSL_GUARDED_BY(mutex_);
+  // Keyed by the merged configuration, which the value keeps alive.
+  absl::flat_hash_map<const Config *, std::shared_ptr<const ResolvedConfig>>
+      resolved_ ABSL_GUARDED_BY(mutex_);
+  int loaded_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_CONFIG_RESOLVER_H_
@@ -0,0 +1,175 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/config_resolver.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/disk_cache.h"
+#include "src/lint_error.h"
+#include "src/schema_catalog.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(ConfigResolverTest, MergesParentDirectories) {
+  std::string root = testing::TempDir() + "/resolver";
+  for (const std::string dir : {"", "/team", "/team/a", "/team/b", "/other"})
+    mkdir((root + dir).c_str(), 0755);
+  std::ofstream(root + "/.zetasql-lint.textproto")
+      << "line_limit: 120 nolint: \"alias\"";
+  std::ofstream(root + "/team/.zetasql-lint.textproto")
+      << "line_limit: 80 nolint: \"join\"";
+  std::ofstream(root + "/team/b/.zetasql-lint.textproto")
+      << "root: true upper_keyword: false";
+
+  Config base;
+  base.set_tab_size(2);
+  ConfigResolver resolver(base);
+
+  std::shared_ptr<const Config> config =
+      resolver.ConfigForFile(root + "/team/a/x.sql");
+  EXPECT_EQ(config->tab_size(), 2);
+  EXPECT_EQ(config->line_limit(), 80);
+  EXPECT_EQ(config->nolint_size(), 2);
+
+  // 'root' ignores configurations of parent directories.
+  config = resolver.ConfigForFile(root + "/team/b/../b/y.sql");
+  EXPECT_EQ(config->tab_size(), 2);
+  EXPECT_FALSE(config->has_line_limit());
+  EXPECT_FALSE(config->upper_keyword());
+  EXPECT_EQ(config->nolint_size(), 0);
+
+  config = resolver.ConfigForFile(root + "/other/z.sql");
+  EXPECT_EQ(config->line_limit(), 120);
+
+  // Files in the same directory share the resolved configuration, and
+  // every configuration file is read only once.
+  EXPECT_EQ(resolver.ConfigForFile(root + "/team/a/x.sql"),
+            resolver.ConfigForFile(root + "/team/a/./w.sql"));
+  EXPECT_EQ(resolver.LoadedConfigCount(), 3);
+}
+
+TEST(ConfigResolverTest, RereadsChangedConfigs) {
+  std::string root = testing::TempDir() + "/changed";
+  mkdir(root.c_str(), 0755);
+  mkdir((root + "/sub").c_str(), 0755);
+  std::ofstream(root + "/.zetasql-lint.textproto") << "line_limit: 90";
+  ConfigResolver resolver(Config{});
+  std::shared_ptr<const ResolvedConfig> resolved =
+      resolver.Resolve(root + "/sub/x.sql");
+  EXPECT_EQ(resolved->options.LineLimit(), 90);
+  EXPECT_EQ(resolver.Resolve(root + "/sub/x.sql"), resolved);
+  EXPECT_EQ(resolver.LoadedConfigCount(), 1);
+
+  // Rewritten files are read again, without clearing the resolver. Sizes of
+  // the files differ, as modification times can be too coarse for a test.
+  std::ofstream(root + "/.zetasql-lint.textproto") << "line_limit: 100";
+  EXPECT_EQ(resolver.ConfigForFile(root + "/sub/x.sql")->line_limit(), 100);
+  std::shared_ptr<const ResolvedConfig> rewritten =
+      resolver.Resolve(root + "/sub/x.sql");
+  EXPECT_EQ(rewritten->options.LineLimit(), 100);
+  EXPECT_NE(rewritten->fingerprint, resolved->fingerprint);
+
+  // So are created and removed ones.
+  const std::string created = root + "/sub/.zetasql-lint.textproto";
+  std::ofstream(created) << "line_limit: 70";
+  EXPECT_EQ(resolver.Resolve(root + "/sub/x.sql")->options.LineLimit(), 70);
+  unlink(created.c_str());
+  EXPECT_EQ(resolver.Resolve(root + "/sub/x.sql")->options.LineLimit(), 100);
+  EXPECT_EQ(resolver.LoadedConfigCount(), 3);
+
+  // Unchanged files are read again only after clearing.
+  resolver.Clear();
+  EXPECT_EQ(resolver.Resolve(root + "/sub/x.sql")->options.LineLimit(), 100);
+  EXPECT_EQ(resolver.LoadedConfigCount(), 4);
+}
+
+TEST(ConfigResolverTest, DisabledSearch) {
+  Config base;
+  base.set_line_limit(10);
+  ConfigResolver resolver(base, "");
+  EXPECT_EQ(resolver.ConfigForFile("a.sql")->line_limit(), 10);
+  EXPECT_EQ(resolver.LoadedConfigCount(), 0);
+}
+
+TEST(ConfigResolverTest, FingerprintOfSchema) {
+  std::string schema = testing::TempDir() + "/fingerprint_schema.bin";
+  ASSERT_TRUE(WriteSchema("t,a,INT64\n", schema).ok());
+  Config config;
+  config.set_schema(schema);
+  const uint64_t fingerprint = ConfigFingerprint(config);
+  EXPECT_EQ(ConfigFingerprint(config), fingerprint);
+
+  DiskCache cache(testing::TempDir() + "/fingerprint_cache", 1 << 20);
+  const std::string sql = "SELECT a FROM t;\n";
+  cache.Store(DiskCache::Key(sql, fingerprint), LinterResult());
+  LinterResult result;
+  EXPECT_TRUE(cache.Lookup(DiskCache::Key(sql, fingerprint), &result));
+
+  // Results of an earlier version of the schema are not used.
+  ASSERT_TRUE(WriteSchema("t,b,INT64\n", schema).ok());
+  EXPECT_NE(ConfigFingerprint(config), fingerprint);
+  EXPECT_FALSE(
+      cache.Lookup(DiskCache::Key(sql, ConfigFingerprint(config)), &result));
+}
+
+TEST(ConfigResolverTest, ResolvedOptions) {
+  std::string root = testing::TempDir() + "/resolved";
+  mkdir(root.c_str(), 0755);
+  std::string schema = root + "/schema.bin";
+  ASSERT_TRUE(WriteSchema("t,a,INT64\n", schema).ok());
+  std::ofstream(root + "/.zetasql-lint.textproto")
+      << "line_limit: 90 schema: \"" << schema << "\"";
+
+  ConfigResolver resolver(Config{});
+  std::shared_ptr<const ResolvedConfig> resolved =
+      resolver.Resolve(root + "/x.sql");
+  EXPECT_EQ(resolved->config, resolver.ConfigForFile(root + "/x.sql"));
+  EXPECT_EQ(resolved->options.LineLimit(), 90);
+  EXPECT_NE(resolved->options.Catalog(), nullptr);
+  EXPECT_EQ(resolved->fingerprint, ConfigFingerprint(*resolved->config));
+
+  // Options are computed once for all files of a directory, and of its
+  // subdirectories without their own configuration files.
+  EXPECT_EQ(resolver.Resolve(root + "/y.sql"), resolved);
+  mkdir((root + "/sub").c_str(), 0755);
+  EXPECT_EQ(resolver.Resolve(root + "/sub/z.sql"), resolved);
+
+  // And again when the schema is rewritten.
+  ASSERT_TRUE(WriteSchema("t,b,INT64\n", schema).ok());
+  EXPECT_FALSE(resolved->IsCurrent());
+  std::shared_ptr<const ResolvedConfig> rewritten =
+      resolver.Resolve(root + "/x.sql");
+  EXPECT_NE(rewritten, resolved);
+  EXPECT_TRUE(rewritten->IsCurrent());
+  EXPECT_NE(rewritten->fingerprint, resolved->fingerprint);
+  EXPECT_EQ(resolver.Resolve(root + "/y.sql"), rewritten);
+  EXPECT_EQ(resolver.Resolve(root + "/sub/z.sql"), rewritten);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,175 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/custom_rules.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+#include "src/byte_scan.h"
+#include "src/checks_util.h"
+#include "src/config.pb.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns a fingerprint of the custom rules of <config>.
+uint64_t RulesFingerprint(const Config &config) {
+  uint64_t fingerprint = config.custom_rule_size();
+  for (const CustomRule &rule : config.custom_rule())
+    fingerprint = CombineFingerprints(fingerprint,
+                                      Fingerprint64(rule.SerializeAsString()));
+  return fingerprint;
+}
+
+}  // namespace
+
+absl::Status CustomRuleSet::Compile(const Config &config,
+                                    std::unique_ptr<CustomRuleSet> *rules) {
+  std::unique_ptr<CustomRuleSet> compiled(new CustomRuleSet());
+  for (ScopeSet &scope : compiled->scopes_)
+    scope.set.reset(new RE2::Set(RE2::Options(), RE2::UNANCHORED));
+
+  for (const CustomRule &rule : config.custom_rule()) {
+    if (rule.name().empty())
+      return absl::InvalidArgumentError(
+          absl::StrCat("Custom rule with pattern '", rule.pattern(),
+                       "' doesn't have a name."));
+    auto pattern = std::make_unique<RE2>(rule.pattern(), RE2::Quiet);
+    if (rule.pattern().empty() || !pattern->ok())
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid pattern of custom rule '", rule.name(),
+                       "': ", pattern->error()));
+
+    int index = compiled->rules_.size();
+    compiled->rules_.push_back(rule);
+    compiled->patterns_.push_back(std::move(pattern));
+
+    std::vector<int> scopes(rule.scope().begin(), rule.scope().end());
+    if (scopes.empty()) scopes.push_back(CustomRule::CODE);
+    for (int scope : scopes) {
+      ScopeSet &set = compiled->scopes_[scope];
+      // A rule is added to a set once even if its scope is repeated.
+      if (!set.rules.empty() && set.rules.back() == index) continue;
+      std::string error;
+      if (set.set->Add(rule.pattern(), &error) < 0)
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Invalid pattern of custom rule '", rule.name(), "': ", error));
+      set.rules.push_back(index);
+    }
+  }
+
+  for (ScopeSet &scope : compiled->scopes_) {
+    if (!scope.rules.empty() && !scope.set->Compile())
+      return absl::ResourceExhaustedError("Custom rules are too large.");
+  }
+  *rules = std::move(compiled);
+  return absl::OkStatus();
+}
+
+std::shared_ptr<const CustomRuleSet> CustomRuleSet::ForConfig(
+    const Config &config) {
+  if (config.custom_rule_size() == 0) return nullptr;
+
+  static absl::Mutex mutex(absl::kConstInit);
+  static auto *cache =
+      new std::map<uint64_t, std::shared_ptr<const CustomRuleSet>>();
+  const uint64_t fingerprint = RulesFingerprint(config);
+  absl::MutexLock lock(&mutex);
+  auto it = cache->find(fingerprint);
+  if (it != cache->end()) return it->second;
+
+  std::unique_ptr<CustomRuleSet> rules;
+  std::shared_ptr<const CustomRuleSet> shared;
+  if (Compile(config, &rules).ok()) shared = std::move(rules);
+  (*cache)[fingerprint] = shared;
+  return shared;
+}
+
+LinterResult CustomRuleSet::Check(absl::string_view sql,
+                                  const LinterOptions &options) const {
+  LinterResult result;
+  static const ByteSet *kPartStarts = new ByteSet({'\'', '"', '-', '/', '#'});
+  ByteScanner scanner(sql, *kPartStarts);
+  const int size = sql.size();
+  int code_start = 0;
+  for (int i = scanner.Next(0); i < size; i = scanner.Next(i)) {
+    int end = i;
+    const ScopeSet *scope = nullptr;
+    if (IgnoreComments(sql, options, &end, /*ignore_single_line=*/true)) {
+      scope = &scopes_[CustomRule::COMMENTS];
+    } else if (IgnoreStrings(sql, &end)) {
+      scope = &scopes_[CustomRule::STRINGS];
+    } else {
+      ++i;
+      continue;
+    }
+    // 'end' is at the last character of the comment or the string.
+    end = std::min(end + 1, size);
+    CheckPart(scopes_[CustomRule::CODE], sql, code_start, i, options, &result);
+    CheckPart(*scope, sql, i, end, options, &result);
+    code_start = i = end;
+  }
+  CheckPart(scopes_[CustomRule::CODE], sql, code_start, size, options,
+            &result);
+  return result;
+}
+
+void CustomRuleSet::CheckPart(const ScopeSet &scope, absl::string_view sql,
+                              int start, int end,
+                              const LinterOptions &options,
+                              LinterResult *result) const {
+  if (scope.rules.empty() || start >= end) return;
+  const re2::StringPiece part(sql.data() + start, end - start);
+  std::vector<int> matched;
+  if (!scope.set->Match(part, &matched)) return;
+
+  for (int match : matched) {
+    const int index = scope.rules[match];
+    const CustomRule &rule = rules_[index];
+    re2::StringPiece found;
+    size_t from = 0;
+    while (from <= part.size() &&
+           patterns_[index]->Match(part, from, part.size(), RE2::UNANCHORED,
+                                   &found, 1)) {
+      const int offset = found.data() - part.data();
+      if (options.IsActive(ErrorCode::kCustomRule, start + offset)) {
+        result->Add(ErrorCode::kCustomRule, sql, start + offset,
+                    absl::StrCat(rule.name(), ": ", rule.message()));
+      }
+      // Empty matches move forward, so they are reported once.
+      from = offset + std::max<size_t>(found.size(), 1);
+    }
+  }
+}
+
+}  // namespace zetasql::linter
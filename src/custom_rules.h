@@ -0,0 +1,82 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_CUSTOM_RULES_H_
+#define SRC_CUSTOM_RULES_H_
+
+// Rules defined in configuration files as regular expressions, like banned
+// functions or hardcoded project names. The rules of each scope are compiled
+// into a single RE2::Set, so a part of the sql is read once no matter how many
+// rules there are. Only the rules that match a part are run again on it to
+// find the positions of their matches.
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+#include "src/config.pb.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+class CustomRuleSet {
+ public:
+  CustomRuleSet(const CustomRuleSet &) = delete;
+  CustomRuleSet &operator=(const CustomRuleSet &) = delete;
+
+  // Compiles the custom rules of <config> into <rules>. Returns an error if
+  // a rule doesn't have a name or a valid pattern.
+  static absl::Status Compile(const Config &config,
+                              std::unique_ptr<CustomRuleSet> *rules);
+
+  // Returns the compiled custom rules of <config>, or null if it doesn't have
+  // any or they are invalid. Configurations with the same rules share them,
+  // so they are compiled once per process.
+  static std::shared_ptr<const CustomRuleSet> ForConfig(const Config &config);
+
+  // Returns the findings of all rules in <sql>. A match of a code rule doesn't
+  // continue over strings and comments, and '^' and '$' match at the start
+  // and the end of every part.
+  LinterResult Check(absl::string_view sql, const LinterOptions &options) const;
+
+ private:
+  CustomRuleSet() = default;
+
+  // Rules of a single scope.
+  struct ScopeSet {
+    std::unique_ptr<RE2::Set> set;
+    // Indices in 'rules_', in the order they are added to 'set'.
+    std::vector<int> rules;
+  };
+
+  // Reports matches of the rules of <scope> in [<start>, <end>) of <sql>.
+  void CheckPart(const ScopeSet &scope, absl::string_view sql, int start,
+                 int end, const LinterOptions &options,
+                 LinterResult *result) const;
+
+  std::vector<CustomRule> rules_;
+  std::vector<std::unique_ptr<RE2>> patterns_;
+  ScopeSet scopes_[CustomRule::Scope_ARRAYSIZE];
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_CUSTOM_RULES_H_
@@ -0,0 +1,120 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/custom_rules.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+void AddRule(Config *config, const std::string &name,
+             const std::string &pattern,
+             std::vector<CustomRule::Scope> scopes = {}) {
+  CustomRule *rule = config->add_custom_rule();
+  rule->set_name(name);
+  rule->set_pattern(pattern);
+  rule->set_message("Don't do that");
+  for (CustomRule::Scope scope : scopes) rule->add_scope(scope);
+}
+
+// Returns the offsets of the findings of <config> in <sql>.
+std::vector<int> Offsets(const Config &config, absl::string_view sql,
+                         const LinterOptions &options = LinterOptions()) {
+  std::unique_ptr<CustomRuleSet> rules;
+  EXPECT_TRUE(CustomRuleSet::Compile(config, &rules).ok());
+  std::vector<int> offsets;
+  for (const LintError &error : rules->Check(sql, options).GetErrors()) {
+    EXPECT_EQ(error.GetType(), ErrorCode::kCustomRule);
+    offsets.push_back(error.GetOffset());
+  }
+  std::sort(offsets.begin(), offsets.end());
+  return offsets;
+}
+
+TEST(CustomRulesTest, Scopes) {
+  Config config;
+  AddRule(&config, "no-legacy", "(?i)legacy_\\w+");
+  absl::string_view sql =
+      "SELECT legacy_a, 'legacy_b' FROM T; -- legacy_c\n"
+      "/* legacy_d */ SELECT LEGACY_E;";
+  EXPECT_EQ(Offsets(config, sql), std::vector<int>({7, 70}));
+
+  // Listing scopes replaces the default one.
+  config.mutable_custom_rule(0)->add_scope(CustomRule::STRINGS);
+  config.mutable_custom_rule(0)->add_scope(CustomRule::COMMENTS);
+  EXPECT_EQ(Offsets(config, sql), std::vector<int>({18, 39, 51}));
+
+  config.mutable_custom_rule(0)->add_scope(CustomRule::CODE);
+  EXPECT_EQ(Offsets(config, sql), std::vector<int>({7, 18, 39, 51, 70}));
+}
+
+TEST(CustomRulesTest, ManyRules) {
+  Config config;
+  AddRule(&config, "no-project", "my-project", {CustomRule::STRINGS});
+  AddRule(&config, "no-todo", "TODO", {CustomRule::COMMENTS});
+  AddRule(&config, "no-random", "\\bRAND\\(");
+  absl::string_view sql =
+      "SELECT RAND() FROM `my-project.d.t`\n"
+      "WHERE x = 'my-project';  -- TODO: fix\n";
+  EXPECT_EQ(Offsets(config, sql), std::vector<int>({7, 47, 64}));
+}
+
+TEST(CustomRulesTest, NoLint) {
+  Config config;
+  AddRule(&config, "no-star", "\\*");
+  LinterOptions options;
+  options.Disable(ErrorCode::kCustomRule, 10);
+  EXPECT_EQ(Offsets(config, "SELECT * FROM T; SELECT * FROM U;", options),
+            std::vector<int>({7}));
+}
+
+TEST(CustomRulesTest, InvalidRules) {
+  std::unique_ptr<CustomRuleSet> rules;
+  Config invalid_pattern;
+  AddRule(&invalid_pattern, "broken", "(a");
+  EXPECT_FALSE(CustomRuleSet::Compile(invalid_pattern, &rules).ok());
+  EXPECT_EQ(CustomRuleSet::ForConfig(invalid_pattern), nullptr);
+
+  Config no_name;
+  AddRule(&no_name, "", "a");
+  EXPECT_FALSE(CustomRuleSet::Compile(no_name, &rules).ok());
+
+  EXPECT_EQ(CustomRuleSet::ForConfig(Config()), nullptr);
+}
+
+TEST(CustomRulesTest, SharedBetweenConfigs) {
+  Config first;
+  AddRule(&first, "rule", "a");
+  Config second = first;
+  second.set_line_limit(80);
+  EXPECT_NE(CustomRuleSet::ForConfig(first), nullptr);
+  EXPECT_EQ(CustomRuleSet::ForConfig(first), CustomRuleSet::ForConfig(second));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
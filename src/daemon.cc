@@ -0,0 +1,86 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <signal.h>
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "src/config_resolver.h"
+#include "src/lint_daemon.h"
+#include "src/thread_pool.h"
+
+ABSL_FLAG(std::string, socket, "",
+          "Path of the Unix domain socket to listen on.");
+
+ABSL_FLAG(int, threads, 0,
+          "Number of requests served at the same time. Uses the number of "
+          "cores if it is not positive.");
+
+ABSL_FLAG(int, max_pending, 64,
+          "Number of accepted connections waiting for a free worker. Later "
+          "clients wait until the daemon catches up.");
+
+ABSL_FLAG(int, cache_size, 10000,
+          "Number of file contents whose results are kept in memory.");
+
+ABSL_FLAG(std::string, config_name,
+          std::string(zetasql::linter::kDirectoryConfigName),
+          "Name of per directory configuration files. They are read once "
+          "per directory, restart the daemon after changing them. An empty "
+          "name disables the search.");
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  std::string socket_path = absl::GetFlag(FLAGS_socket);
+  if (socket_path.empty()) {
+    std::cerr << "Usage: ./daemon --socket=<socket_path>" << std::endl;
+    return 1;
+  }
+  int threads = absl::GetFlag(FLAGS_threads);
+  if (threads <= 0) threads = zetasql::linter::ThreadPool::DefaultThreadCount();
+
+  // Termination signals are handled by a thread that stops the daemon, so
+  // the socket file is removed.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  zetasql::linter::LintDaemon daemon(
+      socket_path, threads, absl::GetFlag(FLAGS_max_pending),
+      absl::GetFlag(FLAGS_cache_size), absl::GetFlag(FLAGS_config_name));
+  absl::Status status = daemon.Listen();
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
+    return 1;
+  }
+  std::thread signal_thread([&daemon, &signals]() {
+    int signal = 0;
+    sigwait(&signals, &signal);
+    daemon.Shutdown();
+  });
+  signal_thread.detach();
+
+  std::cerr << "Listening on " << socket_path << std::endl;
+  daemon.Serve();
+  return 0;
+}
@@ -0,0 +1,139 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/diff_parser.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Parses a range of a hunk header, like '12,3' or '12'.
+bool ParseHunkRange(absl::string_view text, int *start, int *count) {
+  std::pair<absl::string_view, absl::string_view> parts =
+      absl::StrSplit(text, absl::MaxSplits(',', 1));
+  *count = 1;
+  return absl::SimpleAtoi(parts.first, start) &&
+         (parts.second.empty() || absl::SimpleAtoi(parts.second, count));
+}
+
+// Sorts and merges overlapping or adjacent ranges.
+void Normalize(LineRanges *ranges) {
+  std::sort(ranges->begin(), ranges->end());
+  LineRanges merged;
+  for (const auto &range : *ranges) {
+    if (!merged.empty() && range.first <= merged.back().second + 1)
+      merged.back().second = std::max(merged.back().second, range.second);
+    else
+      merged.push_back(range);
+  }
+  *ranges = std::move(merged);
+}
+
+}  // namespace
+
+bool ContainsLine(const LineRanges &ranges, int line) {
+  return OverlapsLines(ranges, line, line);
+}
+
+bool OverlapsLines(const LineRanges &ranges, int first, int last) {
+  // The first range that ends at or after <first>.
+  auto it = std::lower_bound(
+      ranges.begin(), ranges.end(), first,
+      [](const std::pair<int, int> &range, int line) {
+        return range.second < line;
+      });
+  return it != ranges.end() && it->first <= last;
+}
+
+absl::Status ParseUnifiedDiff(absl::string_view diff,
+                              std::map<std::string, LineRanges> *changes) {
+  changes->clear();
+  LineRanges *current = nullptr;
+  bool git_prefix = false;
+  int new_line = 0;
+  int old_remaining = 0;
+  int new_remaining = 0;
+
+  for (absl::string_view line : absl::StrSplit(diff, '\n')) {
+    absl::ConsumeSuffix(&line, "\r");
+    if (old_remaining > 0 || new_remaining > 0) {
+      // Some tools strip the space of empty context lines.
+      char type = line.empty() ? ' ' : line[0];
+      if (type == ' ') {
+        --old_remaining;
+        --new_remaining;
+        ++new_line;
+      } else if (type == '+') {
+        --new_remaining;
+        current->emplace_back(new_line, new_line);
+        ++new_line;
+      } else if (type == '-') {
+        --old_remaining;
+        current->emplace_back(std::max(new_line - 1, 1), new_line);
+      } else if (type != '\\') {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid line in a diff hunk: ", line));
+      }
+      continue;
+    }
+
+    if (absl::StartsWith(line, "diff --git ")) {
+      git_prefix = absl::StartsWith(line, "diff --git a/");
+    } else if (absl::ConsumePrefix(&line, "+++ ")) {
+      // Some tools add a timestamp after a tab.
+      absl::string_view name = line.substr(0, line.find('\t'));
+      if (name == "/dev/null") {
+        current = nullptr;
+        continue;
+      }
+      if (git_prefix) absl::ConsumePrefix(&name, "b/");
+      current = &(*changes)[std::string(name)];
+    } else if (absl::ConsumePrefix(&line, "@@ -")) {
+      // '@@ -<old start>,<old count> +<new start>,<new count> @@'
+      std::vector<absl::string_view> fields =
+          absl::StrSplit(line, absl::MaxSplits(' ', 2));
+      int old_start = 0;
+      if (fields.size() < 2 || !absl::ConsumePrefix(&fields[1], "+") ||
+          !ParseHunkRange(fields[0], &old_start, &old_remaining) ||
+          !ParseHunkRange(fields[1], &new_line, &new_remaining))
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid diff hunk header: @@ -", line));
+      // Hunks of removed files are skipped.
+      if (current == nullptr) {
+        old_remaining = 0;
+        new_remaining = 0;
+      }
+    }
+  }
+  for (auto &[name, ranges] : *changes) Normalize(&ranges);
+  return absl::OkStatus();
+}
+
+}  // namespace zetasql::linter
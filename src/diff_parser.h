@@ -0,0 +1,52 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_DIFF_PARSER_H_
+#define SRC_DIFF_PARSER_H_
+
+// Reading of unified diffs, like the output of 'git diff' or 'diff -u', to
+// find the lines a change touched.
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Ranges of line numbers, starting from 1, with both ends included. Ranges
+// are sorted and don't overlap.
+using LineRanges = std::vector<std::pair<int, int>>;
+
+// Returns if <line> is in one of <ranges>.
+bool ContainsLine(const LineRanges &ranges, int line);
+
+// Returns if any line in [<first>, <last>] is in one of <ranges>.
+bool OverlapsLines(const LineRanges &ranges, int first, int last);
+
+// Sets <changes> to the changed lines of each file in <diff>, in the new
+// version of the file. Added lines are changed, and a removal changes the
+// lines before and after it. Files are named like in the new version
+// without the 'b/' prefix of git. Removed files are not included.
+absl::Status ParseUnifiedDiff(absl::string_view diff,
+                              std::map<std::string, LineRanges> *changes);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_DIFF_PARSER_H_
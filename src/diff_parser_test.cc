@@ -0,0 +1,92 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/diff_parser.h"
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(DiffParserTest, GitDiff) {
+  std::map<std::string, LineRanges> changes;
+  ASSERT_TRUE(ParseUnifiedDiff("diff --git a/q.sql b/q.sql\n"
+                               "index 1234567..89abcde 100644\n"
+                               "--- a/q.sql\n"
+                               "+++ b/q.sql\n"
+                               "@@ -1,4 +1,5 @@\n"
+                               " SELECT 1;\n"
+                               "+SELECT 2;\n"
+                               "+SELECT 3;\n"
+                               " SELECT 4;\n"
+                               "-SELECT 5;\n"
+                               " SELECT 6;\n"
+                               "\n"
+                               "@@ -20 +21,0 @@ SELECT 7;\n"
+                               "-SELECT 8;\n"
+                               "diff --git a/old.sql b/old.sql\n"
+                               "deleted file mode 100644\n"
+                               "--- a/old.sql\n"
+                               "+++ /dev/null\n"
+                               "@@ -1 +0,0 @@\n"
+                               "-SELECT 1;\n",
+                               &changes)
+                  .ok());
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes["q.sql"], LineRanges({{2, 5}, {20, 21}}));
+}
+
+TEST(DiffParserTest, PlainDiff) {
+  std::map<std::string, LineRanges> changes;
+  ASSERT_TRUE(ParseUnifiedDiff("--- b/q.sql\t2020-07-01 10:00:00\n"
+                               "+++ b/q.sql\t2020-07-02 10:00:00\n"
+                               "@@ -1 +1 @@\n"
+                               "-SELECT 1;\n"
+                               "+SELECT 2;\n"
+                               "\\ No newline at end of file\n",
+                               &changes)
+                  .ok());
+  // Without 'diff --git', the 'b/' is part of the name.
+  EXPECT_EQ(changes["b/q.sql"], LineRanges({{1, 1}}));
+}
+
+TEST(DiffParserTest, InvalidDiffs) {
+  std::map<std::string, LineRanges> changes;
+  EXPECT_FALSE(ParseUnifiedDiff("+++ q.sql\n@@ -1 +x @@\n", &changes).ok());
+  EXPECT_FALSE(
+      ParseUnifiedDiff("+++ q.sql\n@@ -1 +1 @@\n?SELECT 1;\n", &changes).ok());
+  EXPECT_TRUE(ParseUnifiedDiff("", &changes).ok());
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST(DiffParserTest, OverlapsLines) {
+  LineRanges ranges = {{2, 3}, {7, 7}};
+  EXPECT_FALSE(ContainsLine(ranges, 1));
+  EXPECT_TRUE(ContainsLine(ranges, 3));
+  EXPECT_FALSE(ContainsLine(ranges, 5));
+  EXPECT_TRUE(ContainsLine(ranges, 7));
+  EXPECT_TRUE(OverlapsLines(ranges, 4, 8));
+  EXPECT_FALSE(OverlapsLines(ranges, 4, 6));
+  EXPECT_FALSE(OverlapsLines({}, 1, 100));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
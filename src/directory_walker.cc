@@ -0,0 +1,268 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/directory_walker.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+#include "src/file_utils.h"
+#include "src/thread_pool.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Type of a directory entry, as much as it is known without calling stat.
+enum class EntryType { kFile, kDirectory, kOther };
+
+// Calls 'callback(name, type)' for each entry of an open directory. On Linux
+// entries are read with getdents64 in large batches, which needs far fewer
+// system calls than readdir on huge directories.
+template <typename Callback>
+void ForEachEntry(int fd, Callback callback) {
+#ifdef __linux__
+  struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;  // NOLINT(runtime/int)
+    unsigned char d_type;
+    char d_name[1];
+  };
+  constexpr int kBufferSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  while (true) {
+    long bytes = syscall(SYS_getdents64, fd, buffer.get(),  // NOLINT
+                         kBufferSize);
+    if (bytes <= 0) return;
+    for (long offset = 0; offset < bytes;) {  // NOLINT(runtime/int)
+      auto *entry = reinterpret_cast<LinuxDirent64 *>(buffer.get() + offset);
+      offset += entry->d_reclen;
+      callback(entry->d_name, entry->d_type);
+    }
+  }
+#else
+  DIR *dir = fdopendir(dup(fd));
+  if (dir == nullptr) return;
+  while (struct dirent *entry = readdir(dir))
+    callback(entry->d_name, entry->d_type);
+  closedir(dir);
+#endif
+}
+
+class DirectoryWalker {
+ public:
+  DirectoryWalker(const ExcludeMatcher &matcher, int num_threads)
+      : matcher_(matcher), pool_(num_threads) {}
+
+  void Walk(const std::string &directory) {
+    std::string root = std::string(absl::StripSuffix(directory, "/"));
+    if (root.empty()) root = "/";
+    pool_.Schedule([this, root]() { WalkDirectory(root, ""); });
+  }
+
+  std::vector<std::string> Finish() {
+    pool_.Wait();
+    absl::MutexLock lock(&mutex_);
+    std::sort(files_.begin(), files_.end());
+    return std::move(files_);
+  }
+
+ private:
+  // <relative> is the path of the directory relative to the walked root,
+  // it is empty for the root itself, and otherwise ends with '/'.
+  void WalkDirectory(const std::string &path, const std::string &relative) {
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    std::vector<std::string> files;
+    std::string prefix = path == "/" ? path : absl::StrCat(path, "/");
+    ForEachEntry(fd, [&](absl::string_view name, unsigned char d_type) {
+      if (name == "." || name == "..") return;
+      EntryType type = GetEntryType(fd, name, d_type);
+      std::string relative_name = absl::StrCat(relative, name);
+
+      if (type == EntryType::kDirectory) {
+        if (matcher_.IsExcluded(relative_name, true)) return;
+        std::string child = absl::StrCat(prefix, name);
+        std::string child_relative = absl::StrCat(relative_name, "/");
+        pool_.Schedule([this, child, child_relative]() {
+          WalkDirectory(child, child_relative);
+        });
+      } else if (type == EntryType::kFile && HasSqlExtension(name) &&
+                 !matcher_.IsExcluded(relative_name, false)) {
+        files.push_back(absl::StrCat(prefix, name));
+      }
+    });
+    close(fd);
+
+    if (files.empty()) return;
+    absl::MutexLock lock(&mutex_);
+    for (std::string &file : files) files_.push_back(std::move(file));
+  }
+
+  // Only symbolic links and file systems without type information
+  // need an extra stat call.
+  static EntryType GetEntryType(int fd, absl::string_view name,
+                                unsigned char d_type) {
+    if (d_type == DT_DIR) return EntryType::kDirectory;
+    if (d_type == DT_REG) return EntryType::kFile;
+    if (d_type != DT_LNK && d_type != DT_UNKNOWN) return EntryType::kOther;
+
+    struct stat st;
+    std::string name_str(name);
+    if (fstatat(fd, name_str.c_str(), &st, 0) != 0) return EntryType::kOther;
+    if (S_ISREG(st.st_mode)) return EntryType::kFile;
+    // Following links to directories could visit the same files
+    // twice, or never end.
+    if (S_ISDIR(st.st_mode) && d_type == DT_UNKNOWN)
+      return EntryType::kDirectory;
+    return EntryType::kOther;
+  }
+
+  const ExcludeMatcher &matcher_;
+  absl::Mutex mutex_;
+  std::vector<std::string> files_ ABSL_GUARDED_BY(mutex_);
+  // Declared last, so that the workers stop before other members
+  // are destroyed.
+  ThreadPool pool_;
+};
+
+}  // namespace
+
+ExcludeMatcher::ExcludeMatcher()
+    : set_(new RE2::Set(RE2::Options(), RE2::ANCHOR_BOTH)) {}
+
+std::string GlobToRegex(absl::string_view pattern) {
+  bool directory_only = absl::ConsumeSuffix(&pattern, "/");
+  // A leading or middle slash makes the pattern relative to the root.
+  bool anchored = absl::StrContains(pattern, '/');
+  absl::ConsumePrefix(&pattern, "/");
+
+  std::string regex = anchored ? "" : "(?:.*/)?";
+  for (int i = 0; i < static_cast<int>(pattern.size()); ++i) {
+    char c = pattern[i];
+    if (c == '*' && i + 1 < static_cast<int>(pattern.size()) &&
+        pattern[i + 1] == '*') {
+      ++i;
+      if (i + 1 < static_cast<int>(pattern.size()) && pattern[i + 1] == '/') {
+        // '**/' matches zero or more directories.
+        ++i;
+        absl::StrAppend(&regex, "(?:.*/)?");
+      } else {
+        absl::StrAppend(&regex, ".*");
+      }
+    } else if (c == '*') {
+      absl::StrAppend(&regex, "[^/]*");
+    } else if (c == '?') {
+      absl::StrAppend(&regex, "[^/]");
+    } else if (c == '[' &&
+               pattern.find(']', i + 1) != absl::string_view::npos) {
+      int end = pattern.find(']', i + 1);
+      absl::string_view body = pattern.substr(i + 1, end - i - 1);
+      absl::StrAppend(&regex, "[");
+      if (absl::ConsumePrefix(&body, "!")) absl::StrAppend(&regex, "^");
+      for (char b : body) {
+        if (b == '\\' || b == '[' || b == ']') absl::StrAppend(&regex, "\\");
+        regex += b;
+      }
+      absl::StrAppend(&regex, "]");
+      i = end;
+    } else if (c == '\\' && i + 1 < static_cast<int>(pattern.size())) {
+      ++i;
+      absl::StrAppend(&regex, RE2::QuoteMeta(re2::StringPiece(&pattern[i], 1)));
+    } else {
+      absl::StrAppend(&regex, RE2::QuoteMeta(re2::StringPiece(&pattern[i], 1)));
+    }
+  }
+  // Directories are matched with a trailing '/'.
+  absl::StrAppend(&regex, directory_only ? "/" : "/?");
+  return regex;
+}
+
+absl::Status ExcludeMatcher::AddPattern(absl::string_view pattern) {
+  pattern = absl::StripTrailingAsciiWhitespace(pattern);
+  if (pattern.empty() || pattern[0] == '#') return absl::OkStatus();
+  bool negated = absl::ConsumePrefix(&pattern, "!");
+  if (pattern.empty() || pattern == "/") return absl::OkStatus();
+
+  std::string error;
+  if (set_->Add(GlobToRegex(pattern), &error) < 0)
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid exclude pattern '", pattern, "': ", error));
+  negated_.push_back(negated);
+  return absl::OkStatus();
+}
+
+absl::Status ExcludeMatcher::AddPatterns(absl::string_view content) {
+  for (absl::string_view line : absl::StrSplit(content, '\n')) {
+    absl::Status status = AddPattern(line);
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ExcludeMatcher::Compile() {
+  if (negated_.empty()) return absl::OkStatus();
+  if (!set_->Compile())
+    return absl::ResourceExhaustedError("Exclude patterns are too large.");
+  compiled_ = true;
+  return absl::OkStatus();
+}
+
+bool ExcludeMatcher::IsExcluded(absl::string_view path,
+                                bool is_directory) const {
+  if (!compiled_) return false;
+  std::vector<int> matches;
+  std::string text =
+      is_directory ? absl::StrCat(path, "/") : std::string(path);
+  if (!set_->Match(text, &matches)) return false;
+  return !negated_[*std::max_element(matches.begin(), matches.end())];
+}
+
+std::vector<std::string> FindSqlFiles(
+    const std::vector<std::string> &directories, const ExcludeMatcher &matcher,
+    int num_threads) {
+  DirectoryWalker walker(matcher, num_threads);
+  for (const std::string &directory : directories) walker.Walk(directory);
+  return walker.Finish();
+}
+
+bool IsDirectory(absl::string_view path) {
+  struct stat st;
+  return stat(std::string(path).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,85 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_DIRECTORY_WALKER_H_
+#define SRC_DIRECTORY_WALKER_H_
+
+// Recursive discovery of sql files inside directories.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace zetasql::linter {
+
+// Matches paths against '.gitignore' style patterns. All patterns are
+// compiled into a single RE2::Set, so a path is matched against all of them
+// in one pass.
+//
+// Supported syntax:
+//    '*' matches anything except '/', '?' matches a single character,
+//    '**' matches any number of directories, '[...]' is a character class.
+//    A pattern ending with '/' only matches directories.
+//    A pattern containing '/' (except at the end) is relative to the root,
+//    otherwise it matches at any level.
+//    A pattern starting with '!' re-includes paths excluded by previous
+//    patterns. The last matching pattern wins.
+//    Empty lines and lines starting with '#' are ignored.
+class ExcludeMatcher {
+ public:
+  ExcludeMatcher();
+
+  // Adds a single pattern. It won't be effective until 'Compile' is called.
+  absl::Status AddPattern(absl::string_view pattern);
+
+  // Adds every line of 'content' as a pattern.
+  absl::Status AddPatterns(absl::string_view content);
+
+  // Compiles all added patterns into a single matcher.
+  absl::Status Compile();
+
+  // Returns if a path, relative to the walked directory and separated
+  // by '/', is excluded.
+  bool IsExcluded(absl::string_view path, bool is_directory) const;
+
+ private:
+  std::unique_ptr<RE2::Set> set_;
+  std::vector<bool> negated_;
+  bool compiled_ = false;
+};
+
+// Converts a single '.gitignore' style pattern into an RE2 regular
+// expression. Negation('!') should be removed before calling this.
+std::string GlobToRegex(absl::string_view pattern);
+
+// Recursively finds all files with sql extensions inside 'directories'.
+// Directories are read in parallel by <num_threads> workers. Excluded
+// directories are not entered at all. Symbolic links to directories are not
+// followed. The result is sorted.
+std::vector<std::string> FindSqlFiles(
+    const std::vector<std::string> &directories, const ExcludeMatcher &matcher,
+    int num_threads);
+
+// Checks if a path refers to a directory.
+bool IsDirectory(absl::string_view path);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_DIRECTORY_WALKER_H_
@@ -0,0 +1,100 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/directory_walker.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/file_utils.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(DirectoryWalkerTest, SqlExtensions) {
+  EXPECT_TRUE(HasSqlExtension("a.sql"));
+  EXPECT_TRUE(HasSqlExtension("dir.x/a.gsql"));
+  EXPECT_FALSE(HasSqlExtension("a.sql.txt"));
+  EXPECT_FALSE(HasSqlExtension("sql"));
+  EXPECT_FALSE(HasSqlExtension("a.SQL"));
+}
+
+TEST(DirectoryWalkerTest, ExcludePatterns) {
+  ExcludeMatcher matcher;
+  EXPECT_TRUE(matcher
+                  .AddPatterns("# generated files\n"
+                               "*.gen.sql\n"
+                               "build/\n"
+                               "/third_party\n"
+                               "docs/**/draft_?.sql\n"
+                               "!keep.gen.sql\n")
+                  .ok());
+  EXPECT_TRUE(matcher.Compile().ok());
+
+  EXPECT_TRUE(matcher.IsExcluded("a.gen.sql", false));
+  EXPECT_TRUE(matcher.IsExcluded("x/y/a.gen.sql", false));
+  EXPECT_FALSE(matcher.IsExcluded("x/keep.gen.sql", false));
+  EXPECT_FALSE(matcher.IsExcluded("a.sql", false));
+
+  // 'build/' only matches directories.
+  EXPECT_TRUE(matcher.IsExcluded("src/build", true));
+  EXPECT_FALSE(matcher.IsExcluded("src/build", false));
+
+  // Anchored patterns only match relative to the root.
+  EXPECT_TRUE(matcher.IsExcluded("third_party", true));
+  EXPECT_FALSE(matcher.IsExcluded("src/third_party", true));
+
+  EXPECT_TRUE(matcher.IsExcluded("docs/draft_1.sql", false));
+  EXPECT_TRUE(matcher.IsExcluded("docs/a/b/draft_2.sql", false));
+  EXPECT_FALSE(matcher.IsExcluded("docs/a/draft_10.sql", false));
+
+  ExcludeMatcher empty;
+  EXPECT_TRUE(empty.Compile().ok());
+  EXPECT_FALSE(empty.IsExcluded("a.sql", false));
+}
+
+TEST(DirectoryWalkerTest, FindSqlFiles) {
+  std::string root = testing::TempDir() + "/walker";
+  for (const std::string dir :
+       {"", "/a", "/a/b", "/a/build", "/c", "/c/d", "/c/d/e"})
+    mkdir((root + dir).c_str(), 0755);
+  for (const std::string file :
+       {"/x.sql", "/x.txt", "/a/y.sqlm", "/a/b/z.gen.sql", "/a/build/w.sql",
+        "/c/d/e/deep.gsql"})
+    std::ofstream(root + file) << "SELECT 1;\n";
+
+  ExcludeMatcher matcher;
+  EXPECT_TRUE(matcher.AddPatterns("build/\n*.gen.sql\n").ok());
+  EXPECT_TRUE(matcher.Compile().ok());
+
+  EXPECT_TRUE(IsDirectory(root));
+  EXPECT_FALSE(IsDirectory(root + "/x.sql"));
+  EXPECT_EQ(FindSqlFiles({root}, matcher, 4),
+            std::vector<std::string>({root + "/a/y.sqlm",
+                                      root + "/c/d/e/deep.gsql",
+                                      root + "/x.sql"}));
+  EXPECT_EQ(FindSqlFiles({root + "/c/"}, ExcludeMatcher(), 1),
+            std::vector<std::string>({root + "/c/d/e/deep.gsql"}));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
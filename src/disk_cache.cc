@@ -0,0 +1,237 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/disk_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "src/file_utils.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter_version.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// A part of every key, so that entries of other linter versions are not used.
+// 'kSourcesVersion' is a hash of the sources of the checks and of this file,
+// generated by the 'linter_version' rule.
+constexpr absl::string_view kLinterVersion = kSourcesVersion;
+
+// Entries start with this, followed by the checksum of the rest.
+constexpr absl::string_view kMagic = "ZLC1";
+constexpr int kHeaderSize = 12;
+
+// Entries used this recently are not touched again, which saves a write
+// for each hit of a busy entry.
+constexpr int kTouchInterval = 3600;
+
+// Temporary files older than this are left by writers that died.
+constexpr int kStaleTempAge = 3600;
+
+void AppendUint32(uint32_t value, std::string *out) {
+  for (int i = 0; i < 4; ++i)
+    out->push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void AppendUint64(uint64_t value, std::string *out) {
+  AppendUint32(static_cast<uint32_t>(value), out);
+  AppendUint32(static_cast<uint32_t>(value >> 32), out);
+}
+
+bool ReadUint32(absl::string_view *data, uint32_t *value) {
+  if (data->size() < 4) return false;
+  *value = 0;
+  for (int i = 3; i >= 0; --i)
+    *value = (*value << 8) | static_cast<unsigned char>((*data)[i]);
+  data->remove_prefix(4);
+  return true;
+}
+
+std::string Serialize(const LinterResult &result) {
+  std::string payload;
+  std::vector<LintError> errors = result.GetErrors();
+  AppendUint32(errors.size(), &payload);
+  for (LintError &error : errors) {
+    auto [line, column] = error.GetPosition();
+    std::string message = error.GetErrorMessage();
+    AppendUint32(static_cast<uint32_t>(error.GetType()), &payload);
+    AppendUint32(line, &payload);
+    AppendUint32(column, &payload);
+    AppendUint32(error.GetOffset(), &payload);
+    AppendUint32(message.size(), &payload);
+    payload += message;
+  }
+  std::string entry(kMagic);
+  AppendUint64(Fingerprint64(payload), &entry);
+  return entry + payload;
+}
+
+// Adds findings in <entry> to <result>. Returns false, without changing
+// <result>, if the entry is not valid.
+bool Deserialize(absl::string_view entry, LinterResult *result) {
+  if (entry.size() < kHeaderSize || !absl::StartsWith(entry, kMagic))
+    return false;
+  absl::string_view header = entry.substr(kMagic.size());
+  uint32_t low = 0, high = 0;
+  ReadUint32(&header, &low);
+  ReadUint32(&header, &high);
+  absl::string_view payload = entry.substr(kHeaderSize);
+  if (Fingerprint64(payload) != ((uint64_t{high} << 32) | low)) return false;
+
+  struct Finding {
+    ErrorCode type;
+    int line, column, offset;
+    absl::string_view message;
+  };
+  std::vector<Finding> findings;
+  uint32_t count = 0;
+  if (!ReadUint32(&payload, &count)) return false;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t type, line, column, offset, size;
+    if (!ReadUint32(&payload, &type) || !ReadUint32(&payload, &line) ||
+        !ReadUint32(&payload, &column) || !ReadUint32(&payload, &offset) ||
+        !ReadUint32(&payload, &size) || size > payload.size() ||
+        type >= static_cast<uint32_t>(ErrorCode::COUNT))
+      return false;
+    findings.push_back({static_cast<ErrorCode>(type), static_cast<int>(line),
+                        static_cast<int>(column), static_cast<int>(offset),
+                        payload.substr(0, size)});
+    payload.remove_prefix(size);
+  }
+  for (const Finding &finding : findings)
+    result->Add(finding.type, finding.line, finding.column, finding.message,
+                finding.offset);
+  return true;
+}
+
+void MakeDirectories(const std::string &path) {
+  for (size_t slash = path.find('/', 1); slash != std::string::npos;
+       slash = path.find('/', slash + 1))
+    mkdir(path.substr(0, slash).c_str(), 0755);
+  mkdir(path.c_str(), 0755);
+}
+
+}  // namespace
+
+DiskCache::DiskCache(absl::string_view directory, int64_t max_size)
+    : directory_(directory), max_size_(max_size) {
+  MakeDirectories(directory_);
+}
+
+uint64_t DiskCache::Key(absl::string_view content,
+                        uint64_t config_fingerprint) {
+  return CombineFingerprints(
+      CombineFingerprints(Fingerprint64(kLinterVersion), config_fingerprint),
+      Fingerprint64(content));
+}
+
+std::string DiskCache::EntryPath(uint64_t key) const {
+  // Entries are spread to 256 directories, to keep directories small.
+  std::string name = absl::StrFormat("%016x", key);
+  return absl::StrCat(directory_, "/", name.substr(0, 2), "/",
+                      name.substr(2));
+}
+
+bool DiskCache::Lookup(uint64_t key, LinterResult *result) {
+  std::string path = EntryPath(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  std::string entry((std::istreambuf_iterator<char>(file)),
+                    std::istreambuf_iterator<char>());
+  if (!Deserialize(entry, result)) return false;
+
+  struct stat info;
+  if (stat(path.c_str(), &info) == 0 &&
+      info.st_mtime + kTouchInterval < time(nullptr))
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  return true;
+}
+
+void DiskCache::Store(uint64_t key, const LinterResult &result) {
+  if (!result.GetStatus().empty()) return;
+  std::string path = EntryPath(key);
+  mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+  if (WriteFileAtomically(path, Serialize(result)).ok()) ++stored_;
+}
+
+void DiskCache::Evict() {
+  if (stored_ == 0) return;
+
+  struct Entry {
+    time_t used;
+    int64_t size;
+    std::string path;
+  };
+  std::vector<Entry> entries;
+  int64_t total = 0;
+  const time_t now = time(nullptr);
+
+  DIR *top = opendir(directory_.c_str());
+  if (top == nullptr) return;
+  while (dirent *shard = readdir(top)) {
+    if (shard->d_name[0] == '.') continue;
+    std::string shard_path = absl::StrCat(directory_, "/", shard->d_name);
+    DIR *dir = opendir(shard_path.c_str());
+    if (dir == nullptr) continue;
+    while (dirent *file = readdir(dir)) {
+      if (file->d_name[0] == '.') continue;
+      std::string path = absl::StrCat(shard_path, "/", file->d_name);
+      struct stat info;
+      if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+      if (absl::StrContains(file->d_name, ".tmp.")) {
+        if (info.st_mtime + kStaleTempAge < now) unlink(path.c_str());
+        continue;
+      }
+      entries.push_back({info.st_mtime, info.st_size, std::move(path)});
+      total += info.st_size;
+    }
+    closedir(dir);
+  }
+  closedir(top);
+  if (total <= max_size_) return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.used < b.used; });
+  // Removing more than needed leaves room for the next runs, so they don't
+  // all list the directory again.
+  const int64_t target = max_size_ / 10 * 9;
+  for (const Entry &entry : entries) {
+    if (total <= target) break;
+    // Another process can remove the same entry at the same time.
+    if (unlink(entry.path.c_str()) == 0 || errno == ENOENT)
+      total -= entry.size;
+  }
+}
+
+}  // namespace zetasql::linter
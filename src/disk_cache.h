@@ -0,0 +1,72 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_DISK_CACHE_H_
+#define SRC_DISK_CACHE_H_
+
+// A persistent cache of lint results, shared by linter runs and by parallel
+// linter processes.
+//
+// Entries are files named by their key, the hash of the linted content, the
+// configuration and the version of the linter. Writers create an entry in a
+// temporary file and rename it, so readers never need locks. Readers touch
+// the entries they use, and the least recently used entries are removed when
+// the cache grows larger than its maximum size.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+class DiskCache {
+ public:
+  // Uses <directory> for the entries, it is created if it doesn't exist.
+  // 'Evict' keeps the total size of entries below <max_size> bytes.
+  DiskCache(absl::string_view directory, int64_t max_size);
+
+  // Returns the key of lint results of <content> with the configuration
+  // whose fingerprint is <config_fingerprint>.
+  static uint64_t Key(absl::string_view content, uint64_t config_fingerprint);
+
+  // Adds the stored findings of <key> to <result>. Returns false if there
+  // is no valid entry.
+  bool Lookup(uint64_t key, LinterResult *result);
+
+  // Stores findings of <result> for <key>. Results with status messages are
+  // not stored. Errors are ignored, as the cache is only an optimization.
+  void Store(uint64_t key, const LinterResult &result);
+
+  // Removes least recently used entries if the cache is larger than its
+  // maximum size. Does nothing if this object didn't store anything, so a
+  // run with a warm cache doesn't list the directory.
+  void Evict();
+
+ private:
+  // Returns the path of the entry of <key>.
+  std::string EntryPath(uint64_t key) const;
+
+  const std::string directory_;
+  const int64_t max_size_;
+  std::atomic<int> stored_{0};
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_DISK_CACHE_H_
@@ -0,0 +1,120 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/disk_cache.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+LinterResult SampleResult() {
+  LinterResult result;
+  result.Add(ErrorCode::kAlias, 1, 10, "Always use AS keyword before aliases",
+             9);
+  result.Add(ErrorCode::kLineLimit, 3, 101, "Lines should be <= 100", 150);
+  return result;
+}
+
+TEST(DiskCacheTest, StoreAndLookup) {
+  std::string directory = testing::TempDir() + "/disk_cache/store";
+  DiskCache cache(directory, 1 << 20);
+  uint64_t key = DiskCache::Key("SELECT a b;\n", 1);
+  EXPECT_NE(key, DiskCache::Key("SELECT a b;\n", 2));
+
+  LinterResult result;
+  EXPECT_FALSE(cache.Lookup(key, &result));
+  cache.Store(key, SampleResult());
+
+  // Another process sees the same entry.
+  DiskCache other(directory, 1 << 20);
+  LinterResult found("file.sql");
+  ASSERT_TRUE(other.Lookup(key, &found));
+  std::vector<LintError> errors = found.GetErrors();
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors[0].GetType(), ErrorCode::kAlias);
+  EXPECT_EQ(errors[0].GetPosition(), std::make_pair(1, 10));
+  EXPECT_EQ(errors[0].GetOffset(), 9);
+  EXPECT_EQ(errors[1].GetErrorMessage(), "Lines should be <= 100");
+
+  // Results without findings are cached too.
+  uint64_t clean_key = DiskCache::Key("SELECT 1;\n", 1);
+  cache.Store(clean_key, LinterResult());
+  EXPECT_TRUE(other.Lookup(clean_key, &result));
+  EXPECT_TRUE(result.ok());
+}
+
+TEST(DiskCacheTest, CorruptEntriesAreMisses) {
+  std::string directory = testing::TempDir() + "/disk_cache/corrupt";
+  DiskCache cache(directory, 1 << 20);
+  uint64_t key = DiskCache::Key("SELECT a b;\n", 1);
+  cache.Store(key, SampleResult());
+
+  // Overwrite one byte of the message.
+  std::string path = absl::StrCat(directory, "/",
+                                  absl::StrFormat("%016x", key).substr(0, 2),
+                                  "/", absl::StrFormat("%016x", key).substr(2));
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(file.good());
+  file.seekp(-3, std::ios::end);
+  file.put('#');
+  file.close();
+
+  LinterResult result;
+  EXPECT_FALSE(cache.Lookup(key, &result));
+  EXPECT_TRUE(result.ok());
+}
+
+TEST(DiskCacheTest, EvictsLeastRecentlyUsed) {
+  std::string directory = testing::TempDir() + "/disk_cache/evict";
+  DiskCache cache(directory, 1000);
+  std::vector<uint64_t> keys;
+  for (int i = 0; i < 20; ++i) {
+    keys.push_back(DiskCache::Key(absl::StrCat("SELECT ", i, ";\n"), 1));
+    cache.Store(keys.back(), SampleResult());
+  }
+  // Make entries older in the order they were stored, the first one is the
+  // least recently used.
+  for (int i = 0; i < 20; ++i) {
+    std::string name = absl::StrFormat("%016x", keys[i]);
+    std::string path =
+        absl::StrCat(directory, "/", name.substr(0, 2), "/", name.substr(2));
+    struct timespec times[2];
+    times[0].tv_sec = times[1].tv_sec = 1000000 + i;
+    times[0].tv_nsec = times[1].tv_nsec = 0;
+    utimensat(AT_FDCWD, path.c_str(), times, 0);
+  }
+  cache.Evict();
+
+  LinterResult result;
+  EXPECT_FALSE(cache.Lookup(keys.front(), &result));
+  EXPECT_TRUE(cache.Lookup(keys.back(), &result));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,173 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/file_utils.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Response files can include each other, this limit protects
+// against cycles.
+constexpr int kMaxResponseFileDepth = 16;
+
+absl::Status ExpandResponseFiles(const std::vector<std::string> &args,
+                                 int depth, std::vector<std::string> *files) {
+  for (const std::string &arg : args) {
+    if (arg.size() < 2 || arg[0] != '@') {
+      files->push_back(arg);
+      continue;
+    }
+    if (depth >= kMaxResponseFileDepth)
+      return absl::InvalidArgumentError(
+          absl::StrCat("Response files are nested too deep: ", arg));
+
+    std::ifstream file(arg.substr(1), std::ios::binary);
+    if (!file)
+      return absl::NotFoundError(
+          absl::StrCat("Response file couldn't be opened: ", arg.substr(1)));
+    absl::Status status =
+        ExpandResponseFiles(ReadFileList(file), depth + 1, files);
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+bool HasSqlExtension(absl::string_view filename) {
+  static const auto *kSqlExtensions =
+      new absl::flat_hash_set<absl::string_view>(
+          {".sql", ".sqlm", ".sqlp", ".sqlt", ".gsql"});
+  size_t dot = filename.rfind('.');
+  if (dot == absl::string_view::npos) return false;
+  return kSqlExtensions->contains(filename.substr(dot));
+}
+
+absl::string_view SqlExtensionList() {
+  return ".sql, .sqlm, .sqlp, .sqlt, .gsql";
+}
+
+std::string ReadFile(absl::string_view filename) {
+  std::ifstream file(std::string(filename), std::ios::binary);
+  std::string str((std::istreambuf_iterator<char>(file)),
+                  std::istreambuf_iterator<char>());
+  if (!str.empty() && str.back() != '\n') str += '\n';
+  return str;
+}
+
+std::string StampOf(const struct stat &info) {
+  return absl::StrCat(info.st_dev, ":", info.st_ino, ":", info.st_size, ":",
+                      info.st_mtim.tv_sec, ".", info.st_mtim.tv_nsec);
+}
+
+std::string FileStamp(absl::string_view filename) {
+  struct stat info;
+  if (stat(std::string(filename).c_str(), &info) != 0) return "";
+  return StampOf(info);
+}
+
+absl::Status WriteFileAtomically(absl::string_view filename,
+                                 absl::string_view content) {
+  // A symbolic link is kept, and the file it points to is replaced.
+  std::string target(filename);
+  struct stat info;
+  if (char *resolved = realpath(target.c_str(), nullptr)) {
+    target = resolved;
+    free(resolved);
+  } else if (errno != ENOENT ||
+             (lstat(target.c_str(), &info) == 0 && S_ISLNK(info.st_mode))) {
+    // Dangling links are not replaced with regular files either.
+    return absl::InternalError(absl::StrCat(
+        "File couldn't be resolved: ", filename, ": ", std::strerror(errno)));
+  }
+  const bool exists = stat(target.c_str(), &info) == 0;
+
+  // Names of temporary files are unique among processes and threads.
+  static std::atomic<int> counter(0);
+  std::string temp = absl::StrCat(target, ".tmp.", getpid(), ".", counter++);
+  int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    return absl::InternalError(absl::StrCat(
+        "File couldn't be created: ", temp, ": ", std::strerror(errno)));
+  // The new file gets the permissions of the file it replaces, the mode of
+  // 'open' is reduced by the umask.
+  bool ok = !exists || fchmod(fd, info.st_mode & 07777) == 0;
+  size_t written = 0;
+  while (written < content.size()) {
+    ssize_t count =
+        write(fd, content.data() + written, content.size() - written);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) break;
+    written += count;
+  }
+  if (written != content.size()) ok = false;
+  if (close(fd) != 0) ok = false;
+  if (ok && rename(temp.c_str(), target.c_str()) == 0)
+    return absl::OkStatus();
+  absl::Status status = absl::InternalError(absl::StrCat(
+      "File couldn't be written: ", filename, ": ", std::strerror(errno)));
+  unlink(temp.c_str());
+  return status;
+}
+
+std::vector<std::string> ReadFileList(std::istream &input) {
+  std::string content((std::istreambuf_iterator<char>(input)),
+                      std::istreambuf_iterator<char>());
+  return SplitFileList(content);
+}
+
+std::vector<std::string> SplitFileList(absl::string_view content) {
+  std::vector<std::string> files;
+  int start = 0;
+  for (int i = 0; i <= static_cast<int>(content.size()); ++i) {
+    if (i < static_cast<int>(content.size()) && content[i] != '\n' &&
+        content[i] != '\0')
+      continue;
+    int end = i;
+    if (end > start && content[end - 1] == '\r') --end;
+    if (end > start) files.emplace_back(content.substr(start, end - start));
+    start = i + 1;
+  }
+  return files;
+}
+
+absl::Status ExpandResponseFiles(const std::vector<std::string> &args,
+                                 std::vector<std::string> *files) {
+  return ExpandResponseFiles(args, 0, files);
+}
+
+}  // namespace zetasql::linter
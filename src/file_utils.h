@@ -0,0 +1,76 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_FILE_UTILS_H_
+#define SRC_FILE_UTILS_H_
+
+// Helper functions for reading sql files and lists of sql files.
+
+#include <sys/stat.h>
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Reads the whole content of a file. Every line in the result ends with
+// '\n', including the last one. Returns an empty string if the file
+// can't be read.
+std::string ReadFile(absl::string_view filename);
+
+// Writes <content> to a temporary file next to <filename> and renames it to
+// <filename>. Readers see either the old file or the whole new one, never a
+// partially written file, even if many processes write at the same time.
+// If <filename> is a symbolic link, the file it points to is replaced. The
+// new file keeps the permissions of the replaced one.
+absl::Status WriteFileAtomically(absl::string_view filename,
+                                 absl::string_view content);
+
+// Returns a string that changes when the file of <info> is rewritten or
+// replaced.
+std::string StampOf(const struct stat &info);
+
+// Returns the stamp of <filename>, or an empty string if it doesn't exist.
+std::string FileStamp(absl::string_view filename);
+
+// Checks if a file name ends with one of the supported sql extensions
+// (.sql, .sqlm, .sqlp, .sqlt, .gsql).
+bool HasSqlExtension(absl::string_view filename);
+
+// Returns supported sql extensions as a comma separated list.
+absl::string_view SqlExtensionList();
+
+// Reads a list of file names from 'input'. Names can be separated either by
+// newlines or by NUL characters (as in 'find -print0'). Empty names are
+// skipped and trailing '\r' characters are removed.
+std::vector<std::string> ReadFileList(std::istream &input);
+
+// Splits the content of a file list. Same format with 'ReadFileList'.
+std::vector<std::string> SplitFileList(absl::string_view content);
+
+// Expands response file arguments. Any argument of the form '@<file>' is
+// replaced with the file names listed in <file>, other arguments are copied
+// as they are. Response files can reference other response files.
+absl::Status ExpandResponseFiles(const std::vector<std::string> &args,
+                                 std::vector<std::string> *files);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_FILE_UTILS_H_
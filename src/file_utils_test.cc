@@ -0,0 +1,116 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/file_utils.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+void WriteFile(const std::string &filename, absl::string_view content) {
+  std::ofstream file(filename, std::ios::binary);
+  file << content;
+}
+
+TEST(FileUtilsTest, ReadFileList) {
+  std::istringstream newline_list("a.sql\nb.sql\r\n\n c.sql\n");
+  EXPECT_EQ(ReadFileList(newline_list),
+            std::vector<std::string>({"a.sql", "b.sql", " c.sql"}));
+
+  std::istringstream nul_list(std::string("a.sql\0dir/b.sql\0", 16));
+  EXPECT_EQ(ReadFileList(nul_list),
+            std::vector<std::string>({"a.sql", "dir/b.sql"}));
+
+  std::istringstream empty_list("");
+  EXPECT_TRUE(ReadFileList(empty_list).empty());
+}
+
+TEST(FileUtilsTest, ReadFile) {
+  std::string filename = testing::TempDir() + "/read_file.sql";
+  WriteFile(filename, "SELECT 1;\nSELECT 2;");
+  EXPECT_EQ(ReadFile(filename), "SELECT 1;\nSELECT 2;\n");
+  EXPECT_EQ(ReadFile(testing::TempDir() + "/missing.sql"), "");
+}
+
+TEST(FileUtilsTest, WriteFileAtomically) {
+  std::string filename = testing::TempDir() + "/atomic.sql";
+  WriteFile(filename, "SELECT 1;\n");
+  ASSERT_TRUE(WriteFileAtomically(filename, "SELECT 2;\n").ok());
+  EXPECT_EQ(ReadFile(filename), "SELECT 2;\n");
+
+  EXPECT_FALSE(
+      WriteFileAtomically(testing::TempDir() + "/missing/a.sql", "").ok());
+}
+
+TEST(FileUtilsTest, WriteFileAtomicallyKeepsModeAndLinks) {
+  std::string filename = testing::TempDir() + "/atomic_target.sql";
+  std::string link = testing::TempDir() + "/atomic_link.sql";
+  WriteFile(filename, "SELECT 1;\n");
+  ASSERT_EQ(chmod(filename.c_str(), 0755), 0);
+  unlink(link.c_str());
+  ASSERT_EQ(symlink(filename.c_str(), link.c_str()), 0);
+
+  ASSERT_TRUE(WriteFileAtomically(link, "SELECT 2;\n").ok());
+  EXPECT_EQ(ReadFile(filename), "SELECT 2;\n");
+  struct stat info;
+  ASSERT_EQ(lstat(link.c_str(), &info), 0);
+  EXPECT_TRUE(S_ISLNK(info.st_mode));
+  ASSERT_EQ(stat(filename.c_str(), &info), 0);
+  EXPECT_EQ(info.st_mode & 07777, 0755);
+
+  // A dangling link isn't replaced with a regular file.
+  unlink(filename.c_str());
+  EXPECT_FALSE(WriteFileAtomically(link, "SELECT 3;\n").ok());
+  ASSERT_EQ(lstat(link.c_str(), &info), 0);
+  EXPECT_TRUE(S_ISLNK(info.st_mode));
+}
+
+TEST(FileUtilsTest, ExpandResponseFiles) {
+  std::string inner = testing::TempDir() + "/inner.txt";
+  std::string outer = testing::TempDir() + "/outer.txt";
+  WriteFile(inner, "b.sql\nc.sql\n");
+  WriteFile(outer, "a.sql\n@" + inner + "\n");
+
+  std::vector<std::string> files;
+  EXPECT_TRUE(ExpandResponseFiles({"@" + outer, "d.sql", "@"}, &files).ok());
+  EXPECT_EQ(files, std::vector<std::string>(
+                       {"a.sql", "b.sql", "c.sql", "d.sql", "@"}));
+
+  files.clear();
+  EXPECT_FALSE(
+      ExpandResponseFiles({"@" + testing::TempDir() + "/missing.txt"}, &files)
+          .ok());
+
+  // A response file including itself shouldn't loop forever.
+  std::string cycle = testing::TempDir() + "/cycle.txt";
+  WriteFile(cycle, "@" + cycle + "\n");
+  files.clear();
+  EXPECT_FALSE(ExpandResponseFiles({"@" + cycle}, &files).ok());
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,209 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/file_watcher.h"
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/time/time.h"
+#include "src/directory_walker.h"
+#include "src/file_utils.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Saves are seen when the written file is closed, not on every write.
+// Editors that save by renaming a temporary file cause IN_MOVED_TO.
+constexpr uint32_t kEvents = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                             IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+int ToPollTimeout(absl::Duration timeout) {
+  if (timeout == absl::InfiniteDuration()) return -1;
+  return static_cast<int>(absl::ToInt64Milliseconds(timeout));
+}
+
+std::string JoinPath(const std::string &directory, absl::string_view name) {
+  if (directory == "/") return absl::StrCat(directory, name);
+  return absl::StrCat(directory, "/", name);
+}
+
+}  // namespace
+
+FileWatcher::FileWatcher(const ExcludeMatcher &matcher,
+                         absl::string_view config_name)
+    : matcher_(matcher),
+      config_name_(config_name),
+      fd_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {}
+
+FileWatcher::~FileWatcher() {
+  if (fd_ >= 0) close(fd_);
+}
+
+absl::Status FileWatcher::Watch(const std::string &directory,
+                                std::vector<std::string> *files) {
+  if (fd_ < 0)
+    return absl::InternalError(
+        absl::StrCat("inotify is not available: ", std::strerror(errno)));
+  std::string root = std::string(absl::StripSuffix(directory, "/"));
+  if (root.empty()) root = "/";
+  if (!IsDirectory(root))
+    return absl::InvalidArgumentError(
+        absl::StrCat("Not a directory: ", directory));
+  std::vector<std::string> found;
+  AddDirectory(root, "", &found);
+  for (std::string &file : found)
+    if (!IsConfigFile(file)) files->push_back(std::move(file));
+  return absl::OkStatus();
+}
+
+bool FileWatcher::IsConfigFile(absl::string_view path) const {
+  if (config_name_.empty()) return false;
+  size_t slash = path.rfind('/');
+  absl::string_view name =
+      slash == absl::string_view::npos ? path : path.substr(slash + 1);
+  return name == config_name_;
+}
+
+bool FileWatcher::IsWatchedFile(absl::string_view name,
+                                const std::string &relative) const {
+  // Configuration files apply to the sql files of their directory even if
+  // they are excluded themselves.
+  if (!config_name_.empty() && name == config_name_) return true;
+  return HasSqlExtension(name) && !matcher_.IsExcluded(relative, false);
+}
+
+void FileWatcher::AddDirectory(const std::string &path,
+                               const std::string &relative,
+                               std::vector<std::string> *files) {
+  // Watching the same directory again returns the same descriptor, its
+  // path is updated if it was moved.
+  int wd = inotify_add_watch(fd_, path.c_str(), kEvents);
+  if (wd < 0) return;
+  directories_[wd] = {path, relative};
+
+  DIR *dir = opendir(path.c_str());
+  if (dir == nullptr) return;
+  while (dirent *entry = readdir(dir)) {
+    absl::string_view name = entry->d_name;
+    if (name == "." || name == "..") continue;
+    std::string child = JoinPath(path, name);
+    std::string child_relative = absl::StrCat(relative, name);
+    struct stat info;
+    // Symbolic links to directories are not followed, like in
+    // 'FindSqlFiles'.
+    if (lstat(child.c_str(), &info) != 0) continue;
+    if (S_ISDIR(info.st_mode)) {
+      if (!matcher_.IsExcluded(child_relative, true))
+        AddDirectory(child, absl::StrCat(child_relative, "/"), files);
+    } else if (IsWatchedFile(name, child_relative)) {
+      files->push_back(child);
+    }
+  }
+  closedir(dir);
+}
+
+void FileWatcher::RemoveDirectory(const std::string &path) {
+  std::string prefix = JoinPath(path, "");
+  std::vector<int> removed;
+  for (const auto &[wd, directory] : directories_) {
+    if (directory.path == path || absl::StartsWith(directory.path, prefix))
+      removed.push_back(wd);
+  }
+  for (int wd : removed) {
+    inotify_rm_watch(fd_, wd);
+    directories_.erase(wd);
+  }
+}
+
+void FileWatcher::ReadEvents(std::vector<std::string> *paths) {
+  alignas(inotify_event) char buffer[64 * 1024];
+  while (true) {
+    ssize_t size = read(fd_, buffer, sizeof(buffer));
+    if (size <= 0) return;
+    for (ssize_t offset = 0; offset < size;) {
+      const auto *event = reinterpret_cast<inotify_event *>(buffer + offset);
+      offset += sizeof(inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW) {
+        overflowed_ = true;
+        continue;
+      }
+      // The directory was removed, or its watch was removed.
+      if (event->mask & IN_IGNORED) {
+        directories_.erase(event->wd);
+        continue;
+      }
+      auto it = directories_.find(event->wd);
+      if (it == directories_.end() || event->len == 0) continue;
+
+      // Adding directories can invalidate <it>.
+      const Directory directory = it->second;
+      absl::string_view name = event->name;
+      std::string path = JoinPath(directory.path, name);
+      std::string relative = absl::StrCat(directory.relative, name);
+      if (event->mask & IN_ISDIR) {
+        if (matcher_.IsExcluded(relative, true)) continue;
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+          // Files can be created before the directory is watched.
+          AddDirectory(path, absl::StrCat(relative, "/"), paths);
+        } else if (event->mask & IN_MOVED_FROM) {
+          RemoveDirectory(path);
+          paths->push_back(path);
+        }
+      } else if (IsWatchedFile(name, relative)) {
+        paths->push_back(path);
+      }
+    }
+  }
+}
+
+bool FileWatcher::WaitForChanges(absl::Duration timeout,
+                                 absl::Duration quiet_period,
+                                 std::vector<std::string> *paths) {
+  paths->clear();
+  if (fd_ < 0) return false;
+  pollfd poll_fd = {fd_, POLLIN, 0};
+  if (poll(&poll_fd, 1, ToPollTimeout(timeout)) <= 0) return false;
+  ReadEvents(paths);
+  while (poll(&poll_fd, 1, ToPollTimeout(quiet_period)) > 0)
+    ReadEvents(paths);
+
+  std::sort(paths->begin(), paths->end());
+  paths->erase(std::unique(paths->begin(), paths->end()), paths->end());
+  return !paths->empty() || overflowed_;
+}
+
+bool FileWatcher::Overflowed() {
+  bool overflowed = overflowed_;
+  overflowed_ = false;
+  return overflowed;
+}
+
+}  // namespace zetasql::linter
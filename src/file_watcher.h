@@ -0,0 +1,98 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_FILE_WATCHER_H_
+#define SRC_FILE_WATCHER_H_
+
+// Notifications of changed sql files in directory trees, with inotify.
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "src/directory_walker.h"
+
+namespace zetasql::linter {
+
+class FileWatcher {
+ public:
+  // Directories and files excluded by <matcher> are not watched. The
+  // matcher should outlive the watcher. If <config_name> isn't empty,
+  // configuration files with that name are watched too.
+  explicit FileWatcher(const ExcludeMatcher &matcher,
+                       absl::string_view config_name = "");
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher &) = delete;
+  FileWatcher &operator=(const FileWatcher &) = delete;
+
+  // Watches <directory> and all directories inside of it, and appends the
+  // sql files inside of them to <files>. Directories created later are
+  // watched too.
+  absl::Status Watch(const std::string &directory,
+                     std::vector<std::string> *files);
+
+  // Waits at most <timeout> for a change. After the first change, waits
+  // until no change arrives for <quiet_period>, so a burst of events, like
+  // an editor saving a file or a checkout, is returned at once. Sets <paths>
+  // to the sorted paths of sql files and configuration files that were
+  // written, created or removed, and of directories that were moved away.
+  // Returns false if nothing changed.
+  bool WaitForChanges(absl::Duration timeout, absl::Duration quiet_period,
+                      std::vector<std::string> *paths);
+
+  // Returns if events were lost since the last call, because too many
+  // arrived at once. All watched files should be checked again then.
+  bool Overflowed();
+
+  // Returns if <path> is a configuration file, see the constructor.
+  bool IsConfigFile(absl::string_view path) const;
+
+ private:
+  struct Directory {
+    std::string path;
+    // Relative to the watched root, empty or ending with '/'.
+    std::string relative;
+  };
+
+  // Returns if file <name>, at <relative> to the watched root, is reported.
+  bool IsWatchedFile(absl::string_view name,
+                     const std::string &relative) const;
+
+  // Watches <path> and the directories inside of it, and adds sql files and
+  // configuration files inside of them to <files>.
+  void AddDirectory(const std::string &path, const std::string &relative,
+                    std::vector<std::string> *files);
+
+  // Stops watching <path> and the directories inside of it.
+  void RemoveDirectory(const std::string &path);
+
+  // Reads available events and adds changed paths to <paths>.
+  void ReadEvents(std::vector<std::string> *paths);
+
+  const ExcludeMatcher &matcher_;
+  const std::string config_name_;
+  int fd_;
+  absl::flat_hash_map<int, Directory> directories_;
+  bool overflowed_ = false;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_FILE_WATCHER_H_
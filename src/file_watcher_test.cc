@@ -0,0 +1,115 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/file_watcher.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "src/directory_walker.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+void WriteFile(const std::string &filename, const std::string &content) {
+  std::ofstream file(filename, std::ios::binary);
+  file << content;
+}
+
+std::vector<std::string> Wait(FileWatcher *watcher) {
+  std::vector<std::string> paths;
+  watcher->WaitForChanges(absl::Seconds(5), absl::Milliseconds(50), &paths);
+  return paths;
+}
+
+TEST(FileWatcherTest, ReportsChangedSqlFiles) {
+  std::string root = testing::TempDir() + "/file_watcher";
+  mkdir(root.c_str(), 0755);
+  mkdir((root + "/old").c_str(), 0755);
+  mkdir((root + "/build").c_str(), 0755);
+  WriteFile(root + "/old/a.sql", "SELECT 1;\n");
+
+  ExcludeMatcher matcher;
+  ASSERT_TRUE(matcher.AddPattern("build/").ok());
+  ASSERT_TRUE(matcher.Compile().ok());
+  FileWatcher watcher(matcher);
+  std::vector<std::string> files;
+  ASSERT_TRUE(watcher.Watch(root + "/", &files).ok());
+  EXPECT_EQ(files, std::vector<std::string>({root + "/old/a.sql"}));
+  EXPECT_FALSE(watcher.Watch(root + "/old/a.sql", &files).ok());
+
+  // Several writes of the same file are reported once, other files and
+  // excluded directories are ignored.
+  WriteFile(root + "/old/a.sql", "SELECT 2;\n");
+  WriteFile(root + "/old/a.sql", "SELECT 3;\n");
+  WriteFile(root + "/notes.txt", "");
+  WriteFile(root + "/build/gen.sql", "");
+  EXPECT_EQ(Wait(&watcher), std::vector<std::string>({root + "/old/a.sql"}));
+
+  // Files of new directories are found, even if they are created before the
+  // directory is watched.
+  mkdir((root + "/new").c_str(), 0755);
+  WriteFile(root + "/new/b.sql", "SELECT 1;\n");
+  std::vector<std::string> paths = Wait(&watcher);
+  EXPECT_EQ(paths, std::vector<std::string>({root + "/new/b.sql"}));
+  WriteFile(root + "/new/b.sql", "SELECT 2;\n");
+  EXPECT_EQ(Wait(&watcher), std::vector<std::string>({root + "/new/b.sql"}));
+
+  // Removed files and moved directories.
+  std::remove((root + "/new/b.sql").c_str());
+  EXPECT_EQ(Wait(&watcher), std::vector<std::string>({root + "/new/b.sql"}));
+  rename((root + "/old").c_str(), (root + "/moved").c_str());
+  EXPECT_EQ(Wait(&watcher),
+            std::vector<std::string>({root + "/moved/a.sql", root + "/old"}));
+
+  EXPECT_FALSE(watcher.Overflowed());
+  std::vector<std::string> none;
+  EXPECT_FALSE(watcher.WaitForChanges(absl::Milliseconds(10),
+                                      absl::Milliseconds(10), &none));
+}
+
+TEST(FileWatcherTest, ReportsConfigFiles) {
+  std::string root = testing::TempDir() + "/file_watcher_config";
+  mkdir(root.c_str(), 0755);
+  WriteFile(root + "/a.sql", "SELECT 1;\n");
+  WriteFile(root + "/lint.textproto", "line_limit: 80");
+
+  ExcludeMatcher matcher;
+  ASSERT_TRUE(matcher.Compile().ok());
+  FileWatcher watcher(matcher, "lint.textproto");
+  std::vector<std::string> files;
+  ASSERT_TRUE(watcher.Watch(root, &files).ok());
+  EXPECT_EQ(files, std::vector<std::string>({root + "/a.sql"}));
+
+  WriteFile(root + "/lint.textproto", "line_limit: 100");
+  WriteFile(root + "/other.textproto", "");
+  std::vector<std::string> paths = Wait(&watcher);
+  EXPECT_EQ(paths, std::vector<std::string>({root + "/lint.textproto"}));
+  EXPECT_TRUE(watcher.IsConfigFile(paths[0]));
+  EXPECT_FALSE(watcher.IsConfigFile(root + "/a.sql"));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
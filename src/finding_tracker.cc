@@ -0,0 +1,92 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/finding_tracker.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+void FindingTracker::Update(const std::string &filename,
+                            absl::string_view content, LinterResult result,
+                            std::vector<std::string> *added,
+                            std::vector<std::string> *resolved) {
+  std::vector<absl::string_view> lines = absl::StrSplit(content, '\n');
+  result.Sort();
+  std::vector<Finding> findings;
+  for (LintError &error : result.GetErrors()) {
+    int line = error.GetLineNumber();
+    absl::string_view text =
+        line >= 1 && line <= static_cast<int>(lines.size())
+            ? absl::StripAsciiWhitespace(lines[line - 1])
+            : "";
+    findings.push_back({absl::StrCat(error.ErrorCodeToString(), "\n",
+                                     error.GetErrorMessage(), "\n", text),
+                        error.ToString()});
+  }
+
+  std::vector<Finding> &old_findings = files_[filename];
+  // Findings are matched as multisets, the same finding can be on many
+  // lines with the same text.
+  absl::flat_hash_map<std::string, int> old_count;
+  for (const Finding &finding : old_findings) ++old_count[finding.key];
+  absl::flat_hash_map<std::string, int> new_count;
+  for (const Finding &finding : findings) {
+    ++new_count[finding.key];
+    if (old_count[finding.key]-- <= 0) added->push_back(finding.text);
+  }
+  for (const Finding &finding : old_findings)
+    if (new_count[finding.key]-- <= 0) resolved->push_back(finding.text);
+
+  // Files without findings are kept, they are linted again when
+  // configurations change.
+  old_findings = std::move(findings);
+}
+
+void FindingTracker::Remove(const std::string &path,
+                            std::vector<std::string> *resolved) {
+  std::string prefix = absl::StrCat(path, "/");
+  for (auto it = files_.lower_bound(path); it != files_.end();) {
+    if (it->first != path && !absl::StartsWith(it->first, prefix)) {
+      // Other names can sort between <path> and its files, like
+      // 'a.sql' between 'a' and 'a/'.
+      if (it->first > prefix) break;
+      ++it;
+      continue;
+    }
+    for (const Finding &finding : it->second)
+      resolved->push_back(finding.text);
+    it = files_.erase(it);
+  }
+}
+
+std::vector<std::string> FindingTracker::Files() const {
+  std::vector<std::string> files;
+  for (const auto &[file, findings] : files_) files.push_back(file);
+  return files;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,64 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_FINDING_TRACKER_H_
+#define SRC_FINDING_TRACKER_H_
+
+// Findings of files that are linted again and again, like in watch mode,
+// reported as differences from the previous run of each file.
+//
+// A finding is identified by its check, its message and the text of its
+// line, not by its position. Editing a line doesn't report the findings of
+// all following lines as resolved and new again.
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+class FindingTracker {
+ public:
+  // Replaces the findings of <filename> with those of <result>, which was
+  // linted from <content>. Appends findings that are new to <added> and the
+  // ones that are gone to <resolved>, formatted like 'LintError::ToString'.
+  void Update(const std::string &filename, absl::string_view content,
+              LinterResult result, std::vector<std::string> *added,
+              std::vector<std::string> *resolved);
+
+  // Forgets the findings of file <path>, or of all files inside of it if it
+  // is a directory, and appends them to <resolved>.
+  void Remove(const std::string &path, std::vector<std::string> *resolved);
+
+  // Returns the files that were updated and not removed, with or without
+  // findings.
+  std::vector<std::string> Files() const;
+
+ private:
+  struct Finding {
+    std::string key;
+    std::string text;
+  };
+
+  std::map<std::string, std::vector<Finding>> files_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_FINDING_TRACKER_H_
@@ -0,0 +1,127 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/finding_tracker.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(FindingTrackerTest, ReportsDifferences) {
+  FindingTracker tracker;
+  std::vector<std::string> added, resolved;
+
+  LinterResult first("a.sql");
+  first.Add(ErrorCode::kAlias, 1, 10, "Use AS");
+  first.Add(ErrorCode::kAlias, 2, 10, "Use AS");
+  tracker.Update("a.sql", "SELECT a b;\nSELECT c d;\n", first, &added,
+                 &resolved);
+  EXPECT_EQ(added.size(), 2);
+  EXPECT_TRUE(resolved.empty());
+
+  // A new first line moves the findings, but they are not new.
+  added.clear();
+  LinterResult moved("a.sql");
+  moved.Add(ErrorCode::kAlias, 2, 10, "Use AS");
+  moved.Add(ErrorCode::kAlias, 3, 10, "Use AS");
+  tracker.Update("a.sql", "SELECT 1;\nSELECT a b;\nSELECT c d;\n", moved,
+                 &added, &resolved);
+  EXPECT_TRUE(added.empty());
+  EXPECT_TRUE(resolved.empty());
+
+  // Fixing one line resolves only its finding.
+  LinterResult fixed("a.sql");
+  fixed.Add(ErrorCode::kAlias, 3, 10, "Use AS");
+  fixed.Add(ErrorCode::kLineLimit, 1, 5, "Too long");
+  tracker.Update("a.sql", "SELECT 1;\nSELECT a AS b;\nSELECT c d;\n", fixed,
+                 &added, &resolved);
+  ASSERT_EQ(added.size(), 1);
+  EXPECT_EQ(added[0],
+            LintError(ErrorCode::kLineLimit, "a.sql", 1, 5, "Too long")
+                .ToString());
+  ASSERT_EQ(resolved.size(), 1);
+  EXPECT_EQ(resolved[0],
+            LintError(ErrorCode::kAlias, "a.sql", 2, 10, "Use AS").ToString());
+  EXPECT_EQ(tracker.Files(), std::vector<std::string>({"a.sql"}));
+}
+
+TEST(FindingTrackerTest, Remove) {
+  FindingTracker tracker;
+  std::vector<std::string> added, resolved;
+  for (const std::string filename :
+       {"dir/a.sql", "dir.sql", "dir/sub/b.sql", "other/c.sql"}) {
+    LinterResult result(filename);
+    result.Add(ErrorCode::kAlias, 1, 10, "Use AS");
+    tracker.Update(filename, "SELECT a b;\n", result, &added, &resolved);
+  }
+  tracker.Remove("dir", &resolved);
+  EXPECT_EQ(resolved.size(), 2);
+  EXPECT_EQ(tracker.Files(),
+            std::vector<std::string>({"dir.sql", "other/c.sql"}));
+
+  resolved.clear();
+  tracker.Remove("dir.sql", &resolved);
+  EXPECT_EQ(resolved.size(), 1);
+  EXPECT_EQ(tracker.Files(), std::vector<std::string>({"other/c.sql"}));
+}
+
+TEST(FindingTrackerTest, KeepsCleanFiles) {
+  // Same with '--watch', files are linted again when their configuration
+  // changes, including the ones without findings.
+  std::string root = testing::TempDir() + "/tracker";
+  mkdir(root.c_str(), 0755);
+  std::string config = root + "/.zetasql-lint.textproto";
+  std::string filename = root + "/a.sql";
+  std::string content = "SELECT column_with_a_long_name FROM t;\n";
+  std::ofstream(config) << "line_limit: 100";
+  std::ofstream(filename) << content;
+
+  ConfigResolver resolver(Config{});
+  FindingTracker tracker;
+  std::vector<std::string> added, resolved;
+  tracker.Update(filename, content,
+                 RunChecks(content, resolver.Resolve(filename)->options,
+                           filename),
+                 &added, &resolved);
+  EXPECT_TRUE(added.empty());
+  EXPECT_EQ(tracker.Files(), std::vector<std::string>({filename}));
+
+  std::ofstream(config) << "line_limit: 20";
+  resolver.Clear();
+  for (const std::string &file : tracker.Files())
+    tracker.Update(file, content,
+                   RunChecks(content, resolver.Resolve(file)->options, file),
+                   &added, &resolved);
+  ASSERT_EQ(added.size(), 1);
+  EXPECT_NE(added[0].find("line-limit-exceed"), std::string::npos);
+  EXPECT_TRUE(resolved.empty());
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
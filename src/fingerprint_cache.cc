@@ -0,0 +1,178 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/fingerprint_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/checks_list.h"
+#include "src/checks_util.h"
+#include "src/config.pb.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+#include "src/linter_options.h"
+#include "src/pattern_matcher.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "zetasql/public/parse_tokens.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns if findings of <type> are computed again for every query, instead
+// of being taken from the cache.
+bool IsRecomputed(ErrorCode type) {
+  switch (type) {
+    // Checks in 'GetLiteralSensitiveChecks'.
+    case ErrorCode::kLineLimit:
+    case ErrorCode::kUniformIndent:
+    case ErrorCode::kNotIndentTab:
+    case ErrorCode::kSingleQuote:
+    case ErrorCode::kImport:
+    case ErrorCode::kCountStar:
+    case ErrorCode::kUtf8Encoding:
+    case ErrorCode::kCustomRule:
+    // NOLINT comments are parsed again for the options of the checks above.
+    case ErrorCode::kNoLint:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Sets <normalized> to <sql> with every literal replaced by a placeholder of
+// its type, and <literals> to the byte ranges of the literals. Returns false
+// if <sql> can't be tokenized.
+bool Normalize(absl::string_view sql, std::string *normalized,
+               std::vector<std::pair<int, int>> *literals) {
+  ParseResumeLocation location = ParseResumeLocation::FromStringView(sql);
+  std::vector<ParseToken> tokens;
+  if (!GetParseTokens(ParseTokenOptions(), &location, &tokens).ok())
+    return false;
+
+  normalized->reserve(sql.size());
+  int copied = 0;
+  for (const ParseToken &token : tokens) {
+    if (token.kind() != ParseToken::VALUE) continue;
+    int start = token.GetLocationRange().start().GetByteOffset();
+    int end = token.GetLocationRange().end().GetByteOffset();
+    normalized->append(sql.data() + copied, start - copied);
+    // The type is a part of the placeholder, as some positions only accept
+    // some types, e.g. LIMIT 'a' doesn't parse.
+    *normalized += '\x01';
+    *normalized += static_cast<char>(token.GetValue().type_kind());
+    literals->emplace_back(start, end);
+    copied = end;
+  }
+  normalized->append(sql.data() + copied, sql.size() - copied);
+  return true;
+}
+
+// Returns the position in the new query that matches <offset> in the old
+// query. Both queries have the same text around literals, only the literals
+// have different lengths.
+int Remap(int offset, const std::vector<std::pair<int, int>> &old_literals,
+          const std::vector<std::pair<int, int>> &new_literals) {
+  // The last literal that starts at or before the offset.
+  int index =
+      std::upper_bound(old_literals.begin(), old_literals.end(), offset,
+                       [](int value, const std::pair<int, int> &literal) {
+                         return value < literal.first;
+                       }) -
+      old_literals.begin() - 1;
+  if (index < 0) return offset;
+
+  const auto &[old_start, old_end] = old_literals[index];
+  const auto &[new_start, new_end] = new_literals[index];
+  if (offset < old_end)
+    return new_start + std::min(offset - old_start, new_end - new_start - 1);
+  return new_end + (offset - old_end);
+}
+
+}  // namespace
+
+FingerprintCache::FingerprintCache(int max_entries) : entries_(max_entries) {}
+
+LinterResult FingerprintCache::RunChecks(absl::string_view sql,
+                                         const Config &config,
+                                         uint64_t config_fingerprint,
+                                         absl::string_view filename) {
+  LinterOptions options;
+  GetOptionsFromConfig(config, &options);
+  return RunChecks(sql, options, config_fingerprint, filename);
+}
+
+LinterResult FingerprintCache::RunChecks(absl::string_view sql,
+                                         const LinterOptions &config_options,
+                                         uint64_t config_fingerprint,
+                                         absl::string_view filename) {
+  std::string normalized;
+  std::vector<std::pair<int, int>> literals;
+  if (!Normalize(sql, &normalized, &literals)) {
+    ++misses_;
+    return linter::RunChecks(sql, config_options, filename);
+  }
+  uint64_t key =
+      CombineFingerprints(config_fingerprint, Fingerprint64(normalized));
+
+  LinterOptions options = config_options;
+  options.SetFilename(filename);
+  std::shared_ptr<const Entry> entry = entries_.Find(key);
+
+  if (entry == nullptr) {
+    ++misses_;
+    LinterResult result = linter::RunChecks(sql, &options);
+    auto new_entry = std::make_shared<Entry>();
+    new_entry->literals = std::move(literals);
+    // Results with parser failures or status messages are not cached, they
+    // don't have offsets to move.
+    bool cacheable = result.GetStatus().empty();
+    for (LintError &error : result.GetErrors()) {
+      if (error.GetOffset() < 0) {
+        cacheable = false;
+        break;
+      }
+      if (IsRecomputed(error.GetType())) continue;
+      new_entry->findings.push_back(
+          {error.GetType(), error.GetOffset(), error.GetErrorMessage()});
+    }
+    if (cacheable) entries_.Insert(key, std::move(new_entry));
+    return result;
+  }
+
+  ++hits_;
+  LinterResult result = ParseNoLintComments(sql, &options);
+  result.SetFilename(options.Filename());
+  options.SetTextMatches(std::make_shared<const std::vector<TextMatch>>(
+      FindTextPatterns(sql, options)));
+  for (const auto &check : GetLiteralSensitiveChecks().GetList())
+    result.Add(check(sql, options));
+  for (const Finding &finding : entry->findings) {
+    result.Add(finding.type, sql,
+               Remap(finding.offset, entry->literals, literals),
+               finding.message);
+  }
+  return result;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,97 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_FINGERPRINT_CACHE_H_
+#define SRC_FINGERPRINT_CACHE_H_
+
+// A cache of lint results for workloads where most queries are instances of
+// a few templates that differ only in literals, like query logs.
+//
+// The key of a query is its fingerprint: the hash of its text where every
+// literal is replaced by a placeholder of the literal's type, combined with
+// the fingerprint of the configuration. Comments and whitespace are a part
+// of the key, so NOLINT comments and positions of all other tokens match
+// between queries with the same key.
+//
+// When a query hits the cache, stored findings are moved to the positions
+// of the new query by the differences in literal lengths, and only the checks
+// whose results depend on literal contents ('GetLiteralSensitiveChecks')
+// are run again. The parser and all other checks are skipped.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/config.pb.h"
+#include "src/generational_cache.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+class FingerprintCache {
+ public:
+  // The cache holds at most about <max_entries> templates.
+  explicit FingerprintCache(int max_entries = 1 << 16);
+
+  FingerprintCache(const FingerprintCache &) = delete;
+  FingerprintCache &operator=(const FingerprintCache &) = delete;
+
+  // Returns the same result as 'RunChecks(sql, config, filename)'.
+  // <config_fingerprint> should be 'ConfigFingerprint(config)', it is
+  // computed once by the caller. It is safe to call from multiple threads.
+  LinterResult RunChecks(absl::string_view sql, const Config &config,
+                         uint64_t config_fingerprint,
+                         absl::string_view filename = "");
+
+  // Same, with <options> already computed from the configuration once for
+  // all queries.
+  LinterResult RunChecks(absl::string_view sql, const LinterOptions &options,
+                         uint64_t config_fingerprint,
+                         absl::string_view filename = "");
+
+  // Returns the number of queries that were served from the cache.
+  int64_t Hits() const { return hits_; }
+
+  // Returns the number of queries that were fully linted.
+  int64_t Misses() const { return misses_; }
+
+ private:
+  // A finding of a literal insensitive check.
+  struct Finding {
+    ErrorCode type;
+    int offset;
+    std::string message;
+  };
+
+  struct Entry {
+    // Byte ranges of literals in the query that filled the entry.
+    std::vector<std::pair<int, int>> literals;
+    std::vector<Finding> findings;
+  };
+
+  GenerationalCache<Entry> entries_;
+
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_FINGERPRINT_CACHE_H_
@@ -0,0 +1,93 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/fingerprint_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+std::vector<std::pair<ErrorCode, std::pair<int, int>>> Findings(
+    LinterResult result) {
+  result.Sort();
+  std::vector<std::pair<ErrorCode, std::pair<int, int>>> findings;
+  for (const LintError &error : result.GetErrors())
+    findings.emplace_back(error.GetType(), error.GetPosition());
+  return findings;
+}
+
+TEST(FingerprintCacheTest, SameTemplateHits) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  FingerprintCache cache;
+
+  cache.RunChecks("SELECT 'x' a, \"y\" FROM t WHERE c = 1;\n", config,
+                  fingerprint);
+  EXPECT_EQ(cache.Misses(), 1);
+
+  // Same query with longer literals, the alias finding moves right and the
+  // double quoted string is found again.
+  absl::string_view sql =
+      "SELECT 'longer' a, \"longest\" FROM t WHERE c = 12345;\n";
+  LinterResult result = cache.RunChecks(sql, config, fingerprint);
+  EXPECT_EQ(cache.Hits(), 1);
+  EXPECT_EQ(Findings(result), Findings(RunChecks(sql, config, "")));
+  EXPECT_FALSE(result.ok());
+}
+
+TEST(FingerprintCacheTest, LiteralSensitiveChecksRunAgain) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  FingerprintCache cache;
+
+  cache.RunChecks("SELECT COUNT(2) FROM t;\n", config, fingerprint);
+  absl::string_view sql = "SELECT COUNT(1) FROM t;\n";
+  LinterResult result = cache.RunChecks(sql, config, fingerprint);
+  EXPECT_EQ(cache.Hits(), 1);
+  EXPECT_EQ(Findings(result), Findings(RunChecks(sql, config, "")));
+  EXPECT_FALSE(result.ok());
+}
+
+TEST(FingerprintCacheTest, DifferentTemplatesMiss) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  FingerprintCache cache;
+
+  cache.RunChecks("SELECT 1 LIMIT 1;\n", config, fingerprint);
+  // Literals of another type are another template.
+  cache.RunChecks("SELECT 1 LIMIT 'a';\n", config, fingerprint);
+  cache.RunChecks("SELECT 1  LIMIT 1;\n", config, fingerprint);
+
+  Config other;
+  other.set_line_limit(10);
+  cache.RunChecks("SELECT 1 LIMIT 1;\n", other, ConfigFingerprint(other));
+  EXPECT_EQ(cache.Hits(), 0);
+  EXPECT_EQ(cache.Misses(), 4);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
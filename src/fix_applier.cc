@@ -0,0 +1,114 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/fix_applier.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Start positions of applied edits, mapped to their ends and edits.
+using EditMap = std::map<int, std::pair<int, const TextEdit *>>;
+
+// Returns if <edit> can be applied with the edits in <applied>.
+bool CanApply(const TextEdit &edit, int text_size, const EditMap &applied) {
+  const int end = edit.offset + edit.length;
+  if (edit.offset < 0 || edit.length < 0 || end > text_size) return false;
+  auto next = applied.lower_bound(edit.offset);
+  if (next != applied.end() &&
+      (next->first == edit.offset || next->first < end))
+    return false;
+  if (next != applied.begin() && std::prev(next)->second.first > edit.offset)
+    return false;
+  return true;
+}
+
+}  // namespace
+
+int ApplyFixes(absl::string_view text, std::vector<std::vector<TextEdit>> fixes,
+               std::string *output) {
+  for (std::vector<TextEdit> &fix : fixes) {
+    std::sort(fix.begin(), fix.end(),
+              [](const TextEdit &a, const TextEdit &b) {
+                return a.offset < b.offset;
+              });
+  }
+  fixes.erase(std::remove_if(fixes.begin(), fixes.end(),
+                             [](const std::vector<TextEdit> &fix) {
+                               return fix.empty();
+                             }),
+              fixes.end());
+  std::stable_sort(fixes.begin(), fixes.end(),
+                   [](const std::vector<TextEdit> &a,
+                      const std::vector<TextEdit> &b) {
+                     return a[0].offset < b[0].offset;
+                   });
+
+  const int text_size = text.size();
+  EditMap applied;
+  int applied_fixes = 0;
+  for (const std::vector<TextEdit> &fix : fixes) {
+    // Edits of the fix are added one by one, so they are checked with each
+    // other too, and removed if any of them can't be applied.
+    int added = 0;
+    for (const TextEdit &edit : fix) {
+      if (!CanApply(edit, text_size, applied)) break;
+      applied[edit.offset] = {edit.offset + edit.length, &edit};
+      ++added;
+    }
+    if (added == static_cast<int>(fix.size())) {
+      ++applied_fixes;
+      continue;
+    }
+    for (int i = 0; i < added; ++i) applied.erase(fix[i].offset);
+  }
+
+  output->clear();
+  size_t size = text.size();
+  for (const auto &[offset, edit] : applied) {
+    size += edit.second->replacement.size();
+    size -= edit.second->length;
+  }
+  output->reserve(size);
+  int position = 0;
+  for (const auto &[offset, edit] : applied) {
+    output->append(text.data() + position, offset - position);
+    output->append(edit.second->replacement);
+    position = edit.first;
+  }
+  output->append(text.data() + position, text.size() - position);
+  return applied_fixes;
+}
+
+int ApplyFixes(absl::string_view text, const LinterResult &result,
+               std::string *output) {
+  std::vector<std::vector<TextEdit>> fixes;
+  for (const LintError &error : result.GetErrors())
+    if (!error.GetFix().empty()) fixes.push_back(error.GetFix());
+  return ApplyFixes(text, std::move(fixes), output);
+}
+
+}  // namespace zetasql::linter
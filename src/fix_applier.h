@@ -0,0 +1,47 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_FIX_APPLIER_H_
+#define SRC_FIX_APPLIER_H_
+
+// Application of automatic fixes of lint errors, see 'LintError::GetFix'.
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+// Applies <fixes>, each a group of edits of <text>, and sets <output> to the
+// result. A fix is applied whole or not at all: fixes are taken in the order
+// of their first edits, and a fix is rejected if any of its edits is outside
+// of <text>, overlaps an edit of an applied fix or starts at the same
+// position with it. Returns the number of applied fixes.
+//
+// The output is built in a single pass over <text>, so the cost doesn't
+// depend on the number of edits.
+int ApplyFixes(absl::string_view text, std::vector<std::vector<TextEdit>> fixes,
+               std::string *output);
+
+// Applies the fixes of errors in <result> to <text>, same with 'ApplyFixes'.
+int ApplyFixes(absl::string_view text, const LinterResult &result,
+               std::string *output);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_FIX_APPLIER_H_
@@ -0,0 +1,73 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/fix_applier.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/lint_error.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(FixApplierTest, AppliesEdits) {
+  std::string output;
+  EXPECT_EQ(ApplyFixes("select COUNT(1) FROM T a;",
+                       {{{23, 0, "AS "}},
+                        {{0, 6, "SELECT"}},
+                        {{13, 1, "*"}}},
+                       &output),
+            3);
+  EXPECT_EQ(output, "SELECT COUNT(*) FROM T AS a;");
+
+  EXPECT_EQ(
+      ApplyFixes("SELECT 1;", std::vector<std::vector<TextEdit>>(), &output),
+      0);
+  EXPECT_EQ(output, "SELECT 1;");
+}
+
+TEST(FixApplierTest, RejectsConflictingFixes) {
+  std::string output;
+  // The second fix overlaps the first one, the third one inserts at the
+  // same position with the first one.
+  EXPECT_EQ(ApplyFixes("SELECT a\tb;",
+                       {{{7, 2, "x "}}, {{8, 1, " "}}, {{7, 0, "y"}}},
+                       &output),
+            1);
+  EXPECT_EQ(output, "SELECT x b;");
+
+  // A fix is rejected whole, including its edits that don't conflict.
+  EXPECT_EQ(ApplyFixes("SELECT \"a\";",
+                       {{{9, 1, "'"}, {7, 1, "'"}}, {{6, 2, "x"}}}, &output),
+            1);
+  EXPECT_EQ(output, "SELECTxa\";");
+  EXPECT_EQ(ApplyFixes("SELECT \"a\";",
+                       {{{9, 1, "'"}, {7, 1, "'"}}, {{8, 1, "b"}}}, &output),
+            2);
+  EXPECT_EQ(output, "SELECT 'b';");
+
+  // Edits outside of the text.
+  EXPECT_EQ(ApplyFixes("SELECT 1;", {{{8, 2, ""}}, {{-1, 0, "x"}}}, &output),
+            0);
+  EXPECT_EQ(output, "SELECT 1;");
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,87 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_GENERATIONAL_CACHE_H_
+#define SRC_GENERATIONAL_CACHE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql::linter {
+
+// A thread safe map from 64 bit keys to immutable values, with a bounded
+// number of entries. Entries are kept in two generations. When the current
+// one is full it becomes the previous one, and the old previous one is
+// dropped. Entries found in the previous generation are moved to the current
+// one, so entries in use survive, like an LRU cache without per entry
+// bookkeeping.
+template <typename Value>
+class GenerationalCache {
+ public:
+  // At most <max_entries> entries are kept.
+  explicit GenerationalCache(int max_entries)
+      : generation_size_(std::max(max_entries / 2, 1)) {}
+
+  GenerationalCache(const GenerationalCache &) = delete;
+  GenerationalCache &operator=(const GenerationalCache &) = delete;
+
+  // Returns the value of <key>, or nullptr.
+  std::shared_ptr<const Value> Find(uint64_t key) {
+    absl::MutexLock lock(&mutex_);
+    auto it = current_.find(key);
+    if (it != current_.end()) return it->second;
+    it = previous_.find(key);
+    if (it == previous_.end()) return nullptr;
+    std::shared_ptr<const Value> value = std::move(it->second);
+    previous_.erase(it);
+    InsertLocked(key, value);
+    return value;
+  }
+
+  // Sets the value of <key>.
+  void Insert(uint64_t key, std::shared_ptr<const Value> value) {
+    absl::MutexLock lock(&mutex_);
+    InsertLocked(key, std::move(value));
+  }
+
+ private:
+  void InsertLocked(uint64_t key, std::shared_ptr<const Value> value)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (static_cast<int>(current_.size()) >= generation_size_) {
+      previous_ = std::move(current_);
+      current_.clear();
+    }
+    current_[key] = std::move(value);
+  }
+
+  const int generation_size_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<const Value>> current_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, std::shared_ptr<const Value>> previous_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_GENERATIONAL_CACHE_H_
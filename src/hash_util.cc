@@ -0,0 +1,56 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/hash_util.h"
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// MurmurHash64A by Austin Appleby, which is in the public domain. Bytes are
+// read in little endian order on every platform.
+uint64_t Fingerprint64(absl::string_view data, uint64_t seed) {
+  constexpr uint64_t kMul = 0xc6a4a7935bd1e995ULL;
+  constexpr int kShift = 47;
+  const int size = data.size();
+  const unsigned char *bytes =
+      reinterpret_cast<const unsigned char*>(data.data());
+
+  uint64_t hash = seed ^ (size * kMul);
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word = 0;
+    for (int j = 7; j >= 0; --j) word = (word << 8) | bytes[i + j];
+    word *= kMul;
+    word ^= word >> kShift;
+    word *= kMul;
+    hash ^= word;
+    hash *= kMul;
+  }
+  if (i < size) {
+    for (int j = size - 1; j >= i; --j)
+      hash ^= static_cast<uint64_t>(bytes[j]) << (8 * (j - i));
+    hash *= kMul;
+  }
+  hash ^= hash >> kShift;
+  hash *= kMul;
+  hash ^= hash >> kShift;
+  return hash;
+}
+
+}  // namespace zetasql::linter
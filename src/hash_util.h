@@ -0,0 +1,40 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_HASH_UTIL_H_
+#define SRC_HASH_UTIL_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Returns a 64 bit hash of <data>. Unlike absl::Hash, the result is the
+// same in every process and on every run, so it can be stored and
+// compared later.
+uint64_t Fingerprint64(absl::string_view data, uint64_t seed = 0);
+
+// Combines two fingerprints into one, the order of arguments matters.
+inline uint64_t CombineFingerprints(uint64_t first, uint64_t second) {
+  // Same mixing as boost::hash_combine, widened to 64 bits.
+  return first ^ (second + 0x9e3779b97f4a7c15ULL + (first << 12) +
+                  (first >> 4));
+}
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_HASH_UTIL_H_
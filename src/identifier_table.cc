@@ -0,0 +1,89 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/identifier_table.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/checks_util.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "zetasql/public/parse_tokens.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns if <name> is a single keyword token.
+bool IsKeyword(absl::string_view name) {
+  ParseResumeLocation location = ParseResumeLocation::FromStringView(name);
+  std::vector<ParseToken> tokens;
+  ParseTokenOptions options;
+  options.max_tokens = 1;
+  if (!GetParseTokens(options, &location, &tokens).ok() || tokens.empty())
+    return false;
+  return tokens[0].kind() == ParseToken::KEYWORD &&
+         tokens[0].GetImage().size() == name.size();
+}
+
+}  // namespace
+
+uint32_t GetNamingStyles(absl::string_view name) {
+  uint32_t styles = 0;
+  if (IsUpperCamelCase(name)) styles |= kUpperCamelCase;
+  if (IsLowerCamelCase(name)) styles |= kLowerCamelCase;
+  if (IsLowerSnakeCase(name)) styles |= kLowerSnakeCase;
+  if (IsCapsSnakeCase(name)) styles |= kCapsSnakeCase;
+  if (IsAllCaps(name)) styles |= kAllCaps;
+  if (IsKeyword(name)) styles |= kKeyword;
+  return styles;
+}
+
+uint32_t IdentifierTable::Styles(absl::string_view name) {
+  Shard &shard = shards_[absl::Hash<absl::string_view>()(name) % kShards];
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.styles.find(name);
+    if (it != shard.styles.end()) return it->second;
+  }
+  // Styles are computed without the lock, another thread can insert the
+  // same name meanwhile.
+  const uint32_t styles = GetNamingStyles(name);
+  absl::MutexLock lock(&shard.mutex);
+  if (static_cast<int>(shard.styles.size()) < max_shard_size_)
+    shard.styles.emplace(name, styles);
+  return styles;
+}
+
+int IdentifierTable::size() {
+  int size = 0;
+  for (Shard &shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    size += shard.styles.size();
+  }
+  return size;
+}
+
+IdentifierTable &IdentifierTable::Shared() {
+  static IdentifierTable *table = new IdentifierTable();
+  return *table;
+}
+
+}  // namespace zetasql::linter
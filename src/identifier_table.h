@@ -0,0 +1,84 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_IDENTIFIER_TABLE_H_
+#define SRC_IDENTIFIER_TABLE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql::linter {
+
+// Naming styles of an identifier, bits of the mask returned by
+// 'GetNamingStyles'.
+enum NamingStyle : uint32_t {
+  kUpperCamelCase = 1 << 0,
+  kLowerCamelCase = 1 << 1,
+  kLowerSnakeCase = 1 << 2,
+  kCapsSnakeCase = 1 << 3,
+  kAllCaps = 1 << 4,
+  // The identifier is a ZetaSQL keyword, e.g. 'date' or 'type'.
+  kKeyword = 1 << 5,
+};
+
+// Returns the mask of the naming styles of identifier <name>.
+uint32_t GetNamingStyles(absl::string_view name);
+
+// A thread safe table of identifiers and their naming styles. The same table
+// and column names occur many times in a repository, so styles of a name are
+// computed once and later occurrences are a hash lookup. Names are spread
+// over shards with separate locks, so files linted in parallel rarely wait
+// for each other.
+class IdentifierTable {
+ public:
+  // At most <max_size> names are kept. Styles of other names are computed on
+  // every lookup.
+  explicit IdentifierTable(int max_size = 1 << 20)
+      : max_shard_size_(max_size / kShards + 1) {}
+
+  IdentifierTable(const IdentifierTable &) = delete;
+  IdentifierTable &operator=(const IdentifierTable &) = delete;
+
+  // Returns 'GetNamingStyles(name)'.
+  uint32_t Styles(absl::string_view name);
+
+  // Returns the number of names in the table.
+  int size();
+
+  // Returns the table that checks share during a run.
+  static IdentifierTable &Shared();
+
+ private:
+  static constexpr int kShards = 16;
+
+  struct Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<std::string, uint32_t> styles ABSL_GUARDED_BY(mutex);
+  };
+
+  const int max_shard_size_;
+  Shard shards_[kShards];
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_IDENTIFIER_TABLE_H_
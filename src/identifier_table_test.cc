@@ -0,0 +1,74 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/identifier_table.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(IdentifierTableTest, GetNamingStyles) {
+  EXPECT_EQ(GetNamingStyles("MyTable"), kUpperCamelCase);
+  EXPECT_EQ(GetNamingStyles("column_name"), kLowerSnakeCase);
+  EXPECT_EQ(GetNamingStyles("TWO_PI"), kCapsSnakeCase | kAllCaps);
+  EXPECT_EQ(GetNamingStyles("INT64"),
+            kUpperCamelCase | kCapsSnakeCase | kAllCaps);
+  EXPECT_EQ(GetNamingStyles("name"), kLowerCamelCase | kLowerSnakeCase);
+
+  EXPECT_TRUE(GetNamingStyles("date") & kKeyword);
+  EXPECT_TRUE(GetNamingStyles("Type") & kKeyword);
+  EXPECT_FALSE(GetNamingStyles("`type`") & kKeyword);
+  EXPECT_FALSE(GetNamingStyles("date_of_birth") & kKeyword);
+}
+
+TEST(IdentifierTableTest, Styles) {
+  IdentifierTable table(/*max_size=*/100);
+  EXPECT_EQ(table.Styles("MyTable"), GetNamingStyles("MyTable"));
+  EXPECT_EQ(table.Styles("MyTable"), GetNamingStyles("MyTable"));
+  EXPECT_EQ(table.Styles("date"), GetNamingStyles("date"));
+  EXPECT_EQ(table.size(), 2);
+
+  // Names beyond the size limit are still classified.
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(table.Styles(absl::StrCat("name_", i)), kLowerSnakeCase);
+  EXPECT_LT(table.size(), 200);
+}
+
+TEST(IdentifierTableTest, SharedByThreads) {
+  IdentifierTable table;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&table]() {
+      for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(table.Styles(absl::StrCat("Table", i % 100)),
+                  kUpperCamelCase);
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  EXPECT_EQ(table.size(), 100);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,492 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/input_source.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "src/file_utils.h"
+#include "src/thread_pool.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr int kBufferSize = 1 << 16;
+constexpr int kTarBlockSize = 512;
+
+// Archive members larger than this are not sql files worth linting, and
+// reading them would need too much memory.
+constexpr int64_t kMaxMemberSize = 1 << 30;
+
+enum class Format { kPlain, kGzip, kZstd, kTar, kTarGzip, kTarZstd };
+
+Format FormatOf(absl::string_view filename) {
+  if (absl::EndsWith(filename, ".tar")) return Format::kTar;
+  if (absl::EndsWith(filename, ".tar.gz") || absl::EndsWith(filename, ".tgz"))
+    return Format::kTarGzip;
+  if (absl::EndsWith(filename, ".tar.zst") ||
+      absl::EndsWith(filename, ".tzst"))
+    return Format::kTarZstd;
+  if (absl::EndsWith(filename, ".gz")) return Format::kGzip;
+  if (absl::EndsWith(filename, ".zst")) return Format::kZstd;
+  return Format::kPlain;
+}
+
+void EnsureTrailingNewline(std::string *content) {
+  if (!content->empty() && content->back() != '\n') *content += '\n';
+}
+
+// A stream of bytes that is read once, from the start to the end.
+class ByteSource {
+ public:
+  virtual ~ByteSource() = default;
+
+  // Reads at most <size> bytes to <buffer>. Returns the number of bytes
+  // read, which is 0 only at the end of the stream or after an error.
+  virtual int Read(char *buffer, int size) = 0;
+
+  // Reads exactly <size> bytes, unless the stream ends before.
+  int ReadFully(char *buffer, int size) {
+    int total = 0;
+    while (total < size) {
+      int count = Read(buffer + total, size - total);
+      if (count <= 0) break;
+      total += count;
+    }
+    return total;
+  }
+
+  // Skips <size> bytes, returns false if the stream ends before.
+  bool Skip(int64_t size) {
+    char buffer[4096];
+    while (size > 0) {
+      int count = Read(buffer, std::min<int64_t>(size, sizeof(buffer)));
+      if (count <= 0) return false;
+      size -= count;
+    }
+    return true;
+  }
+
+  // Returns the error that stopped reading, if there is one.
+  const absl::Status &status() const { return status_; }
+
+ protected:
+  absl::Status status_;
+};
+
+class FileSource : public ByteSource {
+ public:
+  explicit FileSource(absl::string_view filename)
+      : fd_(open(std::string(filename).c_str(), O_RDONLY)) {
+    if (fd_ < 0)
+      status_ = absl::NotFoundError(
+          absl::StrCat("File couldn't be opened: ", filename));
+  }
+
+  ~FileSource() override {
+    if (fd_ >= 0) close(fd_);
+  }
+
+  int Read(char *buffer, int size) override {
+    if (!status_.ok()) return 0;
+    while (true) {
+      ssize_t count = read(fd_, buffer, size);
+      if (count >= 0) return count;
+      if (errno == EINTR) continue;
+      status_ = absl::InternalError(
+          absl::StrCat("File couldn't be read: ", std::strerror(errno)));
+      return 0;
+    }
+  }
+
+ private:
+  const int fd_;
+};
+
+// Decompresses a gzip stream. Concatenated gzip members, as written by
+// parallel compressors, are read as a single stream.
+class GzipSource : public ByteSource {
+ public:
+  explicit GzipSource(std::unique_ptr<ByteSource> input)
+      : input_(std::move(input)), buffer_(new char[kBufferSize]) {
+    // 15 is the largest window, adding 32 accepts gzip and zlib headers.
+    if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+      status_ = absl::InternalError("Decompressor couldn't be initialized.");
+    else
+      initialized_ = true;
+  }
+
+  ~GzipSource() override {
+    if (initialized_) inflateEnd(&stream_);
+  }
+
+  int Read(char *buffer, int size) override {
+    while (status_.ok() && !finished_) {
+      if (stream_.avail_in == 0) {
+        int count = input_->Read(buffer_.get(), kBufferSize);
+        if (count == 0) {
+          finished_ = true;
+          if (!input_->status().ok())
+            status_ = input_->status();
+          else if (in_member_)
+            status_ = absl::DataLossError("Compressed data is truncated.");
+          return 0;
+        }
+        stream_.next_in = reinterpret_cast<Bytef *>(buffer_.get());
+        stream_.avail_in = count;
+      }
+      stream_.next_out = reinterpret_cast<Bytef *>(buffer);
+      stream_.avail_out = size;
+      in_member_ = true;
+      int ret = inflate(&stream_, Z_NO_FLUSH);
+      int produced = size - stream_.avail_out;
+      if (ret == Z_STREAM_END) {
+        inflateReset(&stream_);
+        in_member_ = false;
+      } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        status_ = absl::DataLossError(absl::StrCat(
+            "Invalid compressed data: ",
+            stream_.msg != nullptr ? stream_.msg : "unknown error"));
+        return 0;
+      }
+      if (produced > 0) return produced;
+    }
+    return 0;
+  }
+
+ private:
+  std::unique_ptr<ByteSource> input_;
+  std::unique_ptr<char[]> buffer_;
+  z_stream stream_ = {};
+  bool initialized_ = false;
+  bool in_member_ = false;
+  bool finished_ = false;
+};
+
+// Decompresses a zstd stream. Concatenated frames, as written by parallel
+// compressors, are read as a single stream.
+class ZstdSource : public ByteSource {
+ public:
+  explicit ZstdSource(std::unique_ptr<ByteSource> input)
+      : input_(std::move(input)),
+        buffer_(new char[kBufferSize]),
+        stream_(ZSTD_createDStream()) {
+    if (stream_ == nullptr || ZSTD_isError(ZSTD_initDStream(stream_)))
+      status_ = absl::InternalError("Decompressor couldn't be initialized.");
+    in_ = {buffer_.get(), 0, 0};
+  }
+
+  ~ZstdSource() override { ZSTD_freeDStream(stream_); }
+
+  int Read(char *buffer, int size) override {
+    while (status_.ok() && !finished_) {
+      // A full output buffer can leave decompressed data in the stream, it
+      // is returned before more input is read.
+      if (in_.pos == in_.size && !flushing_) {
+        int count = input_->Read(buffer_.get(), kBufferSize);
+        if (count == 0) {
+          finished_ = true;
+          if (!input_->status().ok())
+            status_ = input_->status();
+          else if (in_frame_)
+            status_ = absl::DataLossError("Compressed data is truncated.");
+          return 0;
+        }
+        in_ = {buffer_.get(), static_cast<size_t>(count), 0};
+      }
+      ZSTD_outBuffer out = {buffer, static_cast<size_t>(size), 0};
+      size_t ret = ZSTD_decompressStream(stream_, &out, &in_);
+      if (ZSTD_isError(ret)) {
+        status_ = absl::DataLossError(
+            absl::StrCat("Invalid compressed data: ", ZSTD_getErrorName(ret)));
+        return 0;
+      }
+      // 0 is returned at the end of a frame, when all of its data is
+      // returned. The next frame starts with the following input.
+      in_frame_ = ret != 0;
+      flushing_ = in_frame_ && out.pos == out.size;
+      if (out.pos > 0) return out.pos;
+    }
+    return 0;
+  }
+
+ private:
+  std::unique_ptr<ByteSource> input_;
+  std::unique_ptr<char[]> buffer_;
+  ZSTD_DStream *stream_;
+  ZSTD_inBuffer in_;
+  bool in_frame_ = false;
+  bool flushing_ = false;
+  bool finished_ = false;
+};
+
+// Returns a NUL terminated string field of a tar header.
+std::string HeaderString(const char *field, int size) {
+  return std::string(field, strnlen(field, size));
+}
+
+// Parses a numeric field of a tar header. Fields are octal, or base-256 if
+// the highest bit is set, which is used for large files.
+int64_t HeaderNumber(const char *field, int size) {
+  int64_t value = 0;
+  if (static_cast<unsigned char>(field[0]) & 0x80) {
+    value = field[0] & 0x7F;
+    for (int i = 1; i < size; ++i)
+      value = (value << 8) | static_cast<unsigned char>(field[i]);
+    return value;
+  }
+  int i = 0;
+  while (i < size && field[i] == ' ') ++i;
+  for (; i < size && field[i] >= '0' && field[i] <= '7'; ++i)
+    value = value * 8 + (field[i] - '0');
+  return value;
+}
+
+// Returns the 'path' of a pax extended header, or an empty string. Records
+// of the header are in "<length> <key>=<value>\n" format.
+std::string PaxPath(absl::string_view data) {
+  std::string path;
+  size_t position = 0;
+  while (position < data.size()) {
+    size_t space = data.find(' ', position);
+    if (space == absl::string_view::npos) break;
+    int length = 0;
+    if (!absl::SimpleAtoi(data.substr(position, space - position), &length) ||
+        length <= 0 || position + length > data.size() ||
+        space + 1 >= position + length)
+      break;
+    absl::string_view record =
+        data.substr(space + 1, position + length - space - 2);
+    if (absl::ConsumePrefix(&record, "path=")) path = std::string(record);
+    position += length;
+  }
+  return path;
+}
+
+absl::Status ReadTar(ByteSource *source, const std::string &archive,
+                     const std::function<bool(InputFile)> &callback) {
+  auto truncated = [&]() {
+    if (!source->status().ok()) return source->status();
+    return absl::DataLossError(
+        absl::StrCat("Archive is truncated: ", archive));
+  };
+
+  char header[kTarBlockSize];
+  // The name given by a GNU long name or pax header for the next member.
+  std::string next_name;
+  while (true) {
+    int count = source->ReadFully(header, kTarBlockSize);
+    // Some writers don't add the end of archive blocks.
+    if (count == 0 && source->status().ok()) return absl::OkStatus();
+    if (count < kTarBlockSize) return truncated();
+    if (std::all_of(header, header + kTarBlockSize,
+                    [](char c) { return c == '\0'; }))
+      return absl::OkStatus();
+
+    std::string name = HeaderString(header, 100);
+    if (memcmp(header + 257, "ustar", 5) == 0) {
+      std::string prefix = HeaderString(header + 345, 155);
+      if (!prefix.empty()) name = absl::StrCat(prefix, "/", name);
+    }
+    if (!next_name.empty()) name = std::move(next_name);
+    next_name.clear();
+
+    const int64_t size = HeaderNumber(header + 124, 12);
+    const int64_t padding =
+        (kTarBlockSize - size % kTarBlockSize) % kTarBlockSize;
+    const char type = header[156];
+    const bool is_file = type == '0' || type == '\0' || type == '7';
+    const bool is_name = type == 'L' || type == 'x';
+    if ((!is_name && !(is_file && HasSqlExtension(name))) ||
+        size > kMaxMemberSize) {
+      if (is_file && size > kMaxMemberSize) {
+        InputFile input;
+        input.name = absl::StrCat(archive, "!", name);
+        input.source = archive;
+        input.status = absl::ResourceExhaustedError(
+            "Archive member is too large to lint.");
+        if (!callback(std::move(input))) return absl::OkStatus();
+      }
+      if (!source->Skip(size + padding)) return truncated();
+      continue;
+    }
+
+    std::string data(size, '\0');
+    if (source->ReadFully(data.data(), size) < size ||
+        !source->Skip(padding))
+      return truncated();
+    if (type == 'L') {
+      next_name = HeaderString(data.data(), data.size());
+    } else if (type == 'x') {
+      next_name = PaxPath(data);
+    } else {
+      InputFile input;
+      input.name = absl::StrCat(archive, "!", name);
+      input.source = archive;
+      input.content = std::move(data);
+      EnsureTrailingNewline(&input.content);
+      if (!callback(std::move(input))) return absl::OkStatus();
+    }
+  }
+}
+
+}  // namespace
+
+bool IsArchiveOrCompressed(absl::string_view filename) {
+  return FormatOf(filename) != Format::kPlain;
+}
+
+bool IsSupportedInput(absl::string_view filename) {
+  switch (FormatOf(filename)) {
+    case Format::kPlain:
+      return HasSqlExtension(filename);
+    case Format::kGzip:
+      return HasSqlExtension(filename.substr(0, filename.size() - 3));
+    case Format::kZstd:
+      return HasSqlExtension(filename.substr(0, filename.size() - 4));
+    default:
+      return true;
+  }
+}
+
+absl::Status ReadInputs(absl::string_view filename,
+                        const std::function<bool(InputFile)> &callback) {
+  const Format format = FormatOf(filename);
+  std::unique_ptr<ByteSource> source = std::make_unique<FileSource>(filename);
+  if (!source->status().ok()) return source->status();
+  if (format == Format::kGzip || format == Format::kTarGzip)
+    source = std::make_unique<GzipSource>(std::move(source));
+  if (format == Format::kZstd || format == Format::kTarZstd)
+    source = std::make_unique<ZstdSource>(std::move(source));
+  if (format == Format::kTar || format == Format::kTarGzip ||
+      format == Format::kTarZstd)
+    return ReadTar(source.get(), std::string(filename), callback);
+
+  InputFile input;
+  input.name = std::string(filename);
+  input.source = input.name;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  while (int count = source->Read(buffer.get(), kBufferSize))
+    input.content.append(buffer.get(), count);
+  if (!source->status().ok()) return source->status();
+  EnsureTrailingNewline(&input.content);
+  callback(std::move(input));
+  return absl::OkStatus();
+}
+
+InputReader::InputReader(std::vector<std::string> filenames, int max_pending,
+                         int num_threads)
+    : filenames_(std::move(filenames)),
+      max_pending_(std::max(max_pending, 1)),
+      files_(filenames_.size()),
+      pool_(std::max(num_threads, 1)) {
+  // Workers take files in order, so the file whose inputs are taken next is
+  // always being read, and the reader can't wait on a file that isn't.
+  for (int index = 0; index < static_cast<int>(filenames_.size()); ++index)
+    pool_.Schedule([this, index]() { ReadFile(index); });
+}
+
+InputReader::~InputReader() {
+  absl::MutexLock lock(&mutex_);
+  cancelled_ = true;
+}
+
+bool InputReader::Next(InputFile *input) {
+  absl::MutexLock lock(&mutex_);
+  while (next_ < static_cast<int>(files_.size())) {
+    auto ready = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+      return !files_[next_].inputs.empty() || files_[next_].done;
+    };
+    mutex_.Await(absl::Condition(&ready));
+    PendingFile &file = files_[next_];
+    if (!file.inputs.empty()) {
+      *input = std::move(file.inputs.front());
+      file.inputs.pop_front();
+      --pending_;
+      return true;
+    }
+    ++next_;
+  }
+  return false;
+}
+
+int InputReader::PeakPending() {
+  absl::MutexLock lock(&mutex_);
+  return peak_pending_;
+}
+
+void InputReader::ReadFile(int index) {
+  auto push = [this, index](InputFile input) {
+    absl::MutexLock lock(&mutex_);
+    // Later files can fill the buffer while 'Next' waits for this one.
+    auto has_space = [this, index]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+      return pending_ < max_pending_ ||
+             (index == next_ && files_[index].inputs.empty()) || cancelled_;
+    };
+    mutex_.Await(absl::Condition(&has_space));
+    if (cancelled_) return false;
+    files_[index].inputs.push_back(std::move(input));
+    peak_pending_ = std::max(peak_pending_, ++pending_);
+    return true;
+  };
+
+  bool cancelled;
+  {
+    absl::MutexLock lock(&mutex_);
+    cancelled = cancelled_;
+  }
+  if (!cancelled) {
+    const std::string &filename = filenames_[index];
+    bool stopped = false;
+    absl::Status status = ReadInputs(filename, [&](InputFile input) {
+      stopped = !push(std::move(input));
+      return !stopped;
+    });
+    // The error is given as an input, in its order among the others.
+    if (!stopped && !status.ok()) {
+      InputFile input;
+      input.name = filename;
+      input.source = filename;
+      input.status = status;
+      push(std::move(input));
+    }
+  }
+  absl::MutexLock lock(&mutex_);
+  files_[index].done = true;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,126 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_INPUT_SOURCE_H_
+#define SRC_INPUT_SOURCE_H_
+
+// Reading of sql inputs from plain files, compressed files and archives.
+//
+// Supported formats are decided by the file name:
+//   <name>.sql.gz         A gzip compressed sql file, named <name>.sql.gz.
+//   <name>.sql.zst        A zstd compressed sql file, named <name>.sql.zst.
+//   .tar, .tar.gz, .tgz,  Every member with a sql extension is an input,
+//   .tar.zst, .tzst       named '<archive>!<member path>'.
+// Other files are read as they are.
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/thread_pool.h"
+
+namespace zetasql::linter {
+
+// A single sql text to lint.
+struct InputFile {
+  // The name shown in results.
+  std::string name;
+
+  // The file that contains the input, it is the archive for archive
+  // members. Configuration files are searched from its directory.
+  std::string source;
+
+  // Content of the input. Like 'ReadFile', every line ends with '\n'.
+  std::string content;
+
+  // Error of reading the input, the content is empty if it isn't ok.
+  absl::Status status;
+};
+
+// Returns if <filename> is a compressed file or an archive.
+bool IsArchiveOrCompressed(absl::string_view filename);
+
+// Returns if <filename> is a sql file, maybe compressed, or an archive.
+bool IsSupportedInput(absl::string_view filename);
+
+// Reads all inputs in <filename> and calls <callback> for each of them in
+// order. Inputs are decompressed while they are read, so the whole archive
+// is never held in memory. If <callback> returns false, reading stops.
+absl::Status ReadInputs(absl::string_view filename,
+                        const std::function<bool(InputFile)> &callback);
+
+// Reads inputs of <filenames> on background threads, so reading and
+// decompression of later inputs overlap with linting of earlier ones. Files
+// are read in parallel, and their inputs are still returned in order.
+class InputReader {
+ public:
+  // Files are read by <num_threads> workers. At most <max_pending> read
+  // inputs of all files wait to be taken, which bounds the memory when
+  // reading is faster than linting. Workers wait with the input they read
+  // until there is space, only the file whose inputs are taken next can add
+  // one more input, so that 'Next' never waits for a full buffer.
+  explicit InputReader(std::vector<std::string> filenames,
+                       int max_pending = 16, int num_threads = 1);
+
+  // Stops reading and waits for the workers.
+  ~InputReader();
+
+  InputReader(const InputReader &) = delete;
+  InputReader &operator=(const InputReader &) = delete;
+
+  // Moves the next input, in the order of files and archive members, to
+  // <input>. Returns false if there are no more inputs.
+  bool Next(InputFile *input);
+
+  // Returns the largest number of read inputs that waited to be taken at
+  // once so far.
+  int PeakPending();
+
+ private:
+  // Inputs of a file that are read but not taken yet.
+  struct PendingFile {
+    std::deque<InputFile> inputs;
+    bool done = false;
+  };
+
+  // Reads the inputs of file <index> to its pending inputs.
+  void ReadFile(int index);
+
+  const std::vector<std::string> filenames_;
+  const int max_pending_;
+
+  absl::Mutex mutex_;
+  std::vector<PendingFile> files_ ABSL_GUARDED_BY(mutex_);
+  // The file whose inputs are taken by 'Next'.
+  int next_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Inputs of all files that wait to be taken.
+  int pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  int peak_pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Declared last, so its workers are stopped before other members are
+  // destroyed.
+  ThreadPool pool_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_INPUT_SOURCE_H_
@@ -0,0 +1,244 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/input_source.h"
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+void WriteFile(const std::string &filename, absl::string_view content) {
+  std::ofstream file(filename, std::ios::binary);
+  file << content;
+}
+
+void WriteGzipFile(const std::string &filename, absl::string_view content) {
+  gzFile file = gzopen(filename.c_str(), "wb");
+  gzwrite(file, content.data(), content.size());
+  gzclose(file);
+}
+
+// Writes <content> as a zstd file of frames of at most <frame_size> bytes.
+void WriteZstdFile(const std::string &filename, absl::string_view content,
+                   int frame_size) {
+  std::string file;
+  for (size_t start = 0; start < content.size(); start += frame_size) {
+    absl::string_view frame = content.substr(start, frame_size);
+    std::string compressed(ZSTD_compressBound(frame.size()), '\0');
+    compressed.resize(ZSTD_compress(&compressed[0], compressed.size(),
+                                    frame.data(), frame.size(), 3));
+    file += compressed;
+  }
+  WriteFile(filename, file);
+}
+
+// Returns a tar member with a ustar header.
+std::string TarMember(absl::string_view name, absl::string_view content,
+                      char type = '0') {
+  std::string header(512, '\0');
+  memcpy(&header[0], name.data(), std::min<size_t>(name.size(), 100));
+  snprintf(&header[124], 12, "%011o", static_cast<int>(content.size()));
+  header[156] = type;
+  memcpy(&header[257], "ustar", 5);
+  std::string data(content);
+  data.resize((content.size() + 511) / 512 * 512, '\0');
+  return header + data;
+}
+
+std::vector<std::pair<std::string, std::string>> ReadAll(
+    const std::string &filename) {
+  std::vector<std::pair<std::string, std::string>> inputs;
+  EXPECT_TRUE(ReadInputs(filename, [&](InputFile input) {
+                inputs.emplace_back(input.name, input.content);
+                return true;
+              }).ok());
+  return inputs;
+}
+
+TEST(InputSourceTest, SupportedInputs) {
+  EXPECT_TRUE(IsSupportedInput("a.sql"));
+  EXPECT_TRUE(IsSupportedInput("a.sql.gz"));
+  EXPECT_TRUE(IsSupportedInput("a.tar"));
+  EXPECT_TRUE(IsSupportedInput("a.tgz"));
+  EXPECT_TRUE(IsSupportedInput("a.sql.zst"));
+  EXPECT_TRUE(IsSupportedInput("a.tar.zst"));
+  EXPECT_TRUE(IsSupportedInput("a.tzst"));
+  EXPECT_FALSE(IsSupportedInput("a.txt.zst"));
+  EXPECT_FALSE(IsSupportedInput("a.txt"));
+  EXPECT_FALSE(IsSupportedInput("a.txt.gz"));
+  EXPECT_TRUE(IsArchiveOrCompressed("a.tar.gz"));
+  EXPECT_FALSE(IsArchiveOrCompressed("a.sql"));
+}
+
+TEST(InputSourceTest, GzipFile) {
+  std::string filename = testing::TempDir() + "/query.sql.gz";
+  std::string content(100000, 'x');
+  content += "\nSELECT 1;";
+  WriteGzipFile(filename, content);
+  auto inputs = ReadAll(filename);
+  ASSERT_EQ(inputs.size(), 1);
+  EXPECT_EQ(inputs[0].first, filename);
+  EXPECT_EQ(inputs[0].second, content + "\n");
+}
+
+TEST(InputSourceTest, ZstdFile) {
+  // A large line is split into frames, and is larger than the output
+  // buffers of the decompressor.
+  std::string content(300000, 'x');
+  content += "\nSELECT 1;";
+  for (int frame_size : {1 << 20, 1000}) {
+    std::string filename = testing::TempDir() + "/query.sql.zst";
+    WriteZstdFile(filename, content, frame_size);
+    auto inputs = ReadAll(filename);
+    ASSERT_EQ(inputs.size(), 1);
+    EXPECT_EQ(inputs[0].first, filename);
+    EXPECT_EQ(inputs[0].second, content + "\n");
+  }
+
+  std::string truncated = testing::TempDir() + "/truncated.sql.zst";
+  std::string compressed(ZSTD_compressBound(content.size()), '\0');
+  compressed.resize(ZSTD_compress(&compressed[0], compressed.size(),
+                                  content.data(), content.size(), 3));
+  WriteFile(truncated, compressed.substr(0, compressed.size() / 2));
+  EXPECT_FALSE(ReadInputs(truncated, [](InputFile) { return true; }).ok());
+}
+
+TEST(InputSourceTest, TarMembers) {
+  std::string archive = TarMember("dir/a.sql", "SELECT 1;\n") +
+                        TarMember("notes.txt", "not sql") +
+                        TarMember("././@LongLink", "dir/long_name.sql", 'L') +
+                        TarMember("dir/long_na", "SELECT 2;") +
+                        std::string(1024, '\0');
+
+  std::string tar = testing::TempDir() + "/bundle.tar";
+  WriteFile(tar, archive);
+  std::string tar_gz = testing::TempDir() + "/bundle.tar.gz";
+  WriteGzipFile(tar_gz, archive);
+  std::string tar_zst = testing::TempDir() + "/bundle.tar.zst";
+  WriteZstdFile(tar_zst, archive, 1000);
+
+  for (const std::string &filename : {tar, tar_gz, tar_zst}) {
+    auto inputs = ReadAll(filename);
+    ASSERT_EQ(inputs.size(), 2);
+    EXPECT_EQ(inputs[0].first, filename + "!dir/a.sql");
+    EXPECT_EQ(inputs[0].second, "SELECT 1;\n");
+    EXPECT_EQ(inputs[1].first, filename + "!dir/long_name.sql");
+    EXPECT_EQ(inputs[1].second, "SELECT 2;\n");
+  }
+}
+
+TEST(InputSourceTest, Errors) {
+  std::string truncated = testing::TempDir() + "/truncated.tar";
+  WriteFile(truncated, TarMember("a.sql", "SELECT 1;").substr(0, 600));
+  EXPECT_FALSE(ReadInputs(truncated, [](InputFile) { return true; }).ok());
+
+  EXPECT_FALSE(ReadInputs(testing::TempDir() + "/missing.sql",
+                          [](InputFile) { return true; })
+                   .ok());
+}
+
+TEST(InputSourceTest, ReaderKeepsOrder) {
+  std::string first = testing::TempDir() + "/first.sql";
+  std::string archive = testing::TempDir() + "/second.tar";
+  WriteFile(first, "SELECT 1;");
+  WriteFile(archive, TarMember("a.sql", "SELECT 2;") +
+                         TarMember("b.sql", "SELECT 3;"));
+
+  InputReader reader({first, testing::TempDir() + "/missing.sql", archive},
+                     1);
+  std::vector<std::string> names;
+  InputFile input;
+  while (reader.Next(&input)) {
+    names.push_back(input.name);
+    EXPECT_EQ(input.status.ok(), !input.content.empty());
+  }
+  EXPECT_EQ(names, std::vector<std::string>(
+                       {first, testing::TempDir() + "/missing.sql",
+                        archive + "!a.sql", archive + "!b.sql"}));
+}
+
+TEST(InputSourceTest, ReaderKeepsOrderOfParallelFiles) {
+  std::vector<std::string> filenames;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 20; ++i) {
+    std::string archive =
+        absl::StrCat(testing::TempDir(), "/parallel", i, ".tar.zst");
+    WriteZstdFile(archive,
+                  TarMember("a.sql", absl::StrCat("SELECT ", i, ";")) +
+                      TarMember("b.sql", "SELECT 0;"),
+                  1000);
+    filenames.push_back(archive);
+    expected.push_back(archive + "!a.sql");
+    expected.push_back(archive + "!b.sql");
+  }
+
+  InputReader reader(filenames, 1, 4);
+  std::vector<std::string> names;
+  InputFile input;
+  while (reader.Next(&input)) names.push_back(input.name);
+  EXPECT_EQ(names, expected);
+}
+
+TEST(InputSourceTest, ReaderBoundsPendingInputs) {
+  // Files with a single input each, read much faster than they are taken.
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 50; ++i) {
+    std::string filename =
+        absl::StrCat(testing::TempDir(), "/pending", i, ".sql.zst");
+    WriteZstdFile(filename, absl::StrCat("SELECT ", i, ";"), 1000);
+    filenames.push_back(filename);
+  }
+
+  InputReader reader(filenames, 4, 8);
+  std::vector<std::string> names;
+  InputFile input;
+  while (reader.Next(&input)) {
+    names.push_back(input.name);
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(names, filenames);
+  EXPECT_GE(reader.PeakPending(), 1);
+  // One more input of the file that is taken next can be added.
+  EXPECT_LE(reader.PeakPending(), 5);
+}
+
+TEST(InputSourceTest, ReaderCanBeDestroyedEarly) {
+  std::string filename = testing::TempDir() + "/early.sql";
+  WriteFile(filename, "SELECT 1;");
+  InputReader reader(std::vector<std::string>(10, filename), 1, 4);
+  InputFile input;
+  EXPECT_TRUE(reader.Next(&input));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
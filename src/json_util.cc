@@ -0,0 +1,318 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/json_util.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Nesting limit, protects the recursive parser from malicious input.
+constexpr int kMaxDepth = 64;
+
+void AppendUtf8(uint32_t code_point, std::string *out) {
+  if (code_point < 0x80) {
+    *out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    *out += static_cast<char>(0xC0 | (code_point >> 6));
+    *out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    *out += static_cast<char>(0xE0 | (code_point >> 12));
+    *out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    *out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    *out += static_cast<char>(0xF0 | (code_point >> 18));
+    *out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    *out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    *out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+bool ParseHex4(absl::string_view text, int position, uint32_t *value) {
+  if (position + 4 > static_cast<int>(text.size())) return false;
+  *value = 0;
+  for (int i = position; i < position + 4; ++i) {
+    char c = text[i];
+    if (!absl::ascii_isxdigit(c)) return false;
+    int digit = absl::ascii_isdigit(c) ? c - '0'
+                                       : absl::ascii_tolower(c) - 'a' + 10;
+    *value = *value * 16 + digit;
+  }
+  return true;
+}
+
+// Decodes escape sequences of a JSON string body, which is already
+// validated by the parser.
+std::string Unescape(absl::string_view raw) {
+  std::string out;
+  out.reserve(raw.size());
+  for (int i = 0; i < static_cast<int>(raw.size()); ++i) {
+    if (raw[i] != '\\') {
+      out += raw[i];
+      continue;
+    }
+    char c = raw[++i];
+    switch (c) {
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        uint32_t code_point = 0;
+        ParseHex4(raw, i + 1, &code_point);
+        i += 4;
+        uint32_t low = 0;
+        if (code_point >= 0xD800 && code_point < 0xDC00 &&
+            i + 2 < static_cast<int>(raw.size()) && raw[i + 1] == '\\' &&
+            raw[i + 2] == 'u' && ParseHex4(raw, i + 3, &low) &&
+            low >= 0xDC00 && low < 0xE000) {
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+          i += 6;
+        }
+        AppendUtf8(code_point, &out);
+        break;
+      }
+      default:
+        // '"', '\\' and '/'.
+        out += c;
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+class JsonParser {
+ public:
+  explicit JsonParser(absl::string_view text) : text_(text) {}
+
+  absl::Status Parse(JsonValue *value) {
+    if (!ParseValue(value, 0)) return Error();
+    SkipWhitespace();
+    if (position_ != static_cast<int>(text_.size())) return Error();
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::Status Error() const {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid JSON at offset ", position_));
+  }
+
+  void SkipWhitespace() {
+    while (position_ < static_cast<int>(text_.size()) &&
+           (text_[position_] == ' ' || text_[position_] == '\t' ||
+            text_[position_] == '\n' || text_[position_] == '\r'))
+      ++position_;
+  }
+
+  bool Consume(absl::string_view literal) {
+    if (text_.substr(position_, literal.size()) != literal) return false;
+    position_ += literal.size();
+    return true;
+  }
+
+  bool ParseValue(JsonValue *value, int depth) {
+    if (depth > kMaxDepth) return false;
+    SkipWhitespace();
+    if (position_ >= static_cast<int>(text_.size())) return false;
+    switch (text_[position_]) {
+      case '{':
+        return ParseObject(value, depth);
+      case '[':
+        return ParseArray(value, depth);
+      case '"':
+        value->type_ = JsonValue::Type::kString;
+        return ParseString(&value->raw_, &value->has_escapes_);
+      case 't':
+        value->type_ = JsonValue::Type::kBool;
+        value->bool_ = true;
+        return Consume("true");
+      case 'f':
+        value->type_ = JsonValue::Type::kBool;
+        return Consume("false");
+      case 'n':
+        return Consume("null");
+      default:
+        return ParseNumber(value);
+    }
+  }
+
+  bool ParseObject(JsonValue *value, int depth) {
+    value->type_ = JsonValue::Type::kObject;
+    ++position_;
+    SkipWhitespace();
+    if (Consume("}")) return true;
+    while (true) {
+      SkipWhitespace();
+      absl::string_view raw_key;
+      bool has_escapes = false;
+      if (position_ >= static_cast<int>(text_.size()) ||
+          text_[position_] != '"' || !ParseString(&raw_key, &has_escapes))
+        return false;
+      SkipWhitespace();
+      if (!Consume(":")) return false;
+      JsonValue member;
+      if (!ParseValue(&member, depth + 1)) return false;
+      value->members_.emplace_back(
+          has_escapes ? Unescape(raw_key) : std::string(raw_key),
+          std::move(member));
+      SkipWhitespace();
+      if (Consume("}")) return true;
+      if (!Consume(",")) return false;
+    }
+  }
+
+  bool ParseArray(JsonValue *value, int depth) {
+    value->type_ = JsonValue::Type::kArray;
+    ++position_;
+    SkipWhitespace();
+    if (Consume("]")) return true;
+    while (true) {
+      JsonValue element;
+      if (!ParseValue(&element, depth + 1)) return false;
+      value->elements_.push_back(std::move(element));
+      SkipWhitespace();
+      if (Consume("]")) return true;
+      if (!Consume(",")) return false;
+    }
+  }
+
+  // Sets <raw> to the string body between the quotes.
+  bool ParseString(absl::string_view *raw, bool *has_escapes) {
+    int start = ++position_;
+    while (position_ < static_cast<int>(text_.size())) {
+      char c = text_[position_];
+      if (c == '"') {
+        *raw = text_.substr(start, position_ - start);
+        ++position_;
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) return false;
+      if (c == '\\') {
+        *has_escapes = true;
+        if (++position_ >= static_cast<int>(text_.size())) return false;
+        c = text_[position_];
+        if (c == 'u') {
+          uint32_t unused;
+          if (!ParseHex4(text_, position_ + 1, &unused)) return false;
+          position_ += 4;
+        } else if (c != '"' && c != '\\' && c != '/' && c != 'b' && c != 'f' &&
+                   c != 'n' && c != 'r' && c != 't') {
+          return false;
+        }
+      }
+      ++position_;
+    }
+    return false;
+  }
+
+  bool ParseNumber(JsonValue *value) {
+    int start = position_;
+    while (position_ < static_cast<int>(text_.size()) &&
+           (absl::ascii_isdigit(text_[position_]) || text_[position_] == '-' ||
+            text_[position_] == '+' || text_[position_] == '.' ||
+            text_[position_] == 'e' || text_[position_] == 'E'))
+      ++position_;
+    value->type_ = JsonValue::Type::kNumber;
+    value->raw_ = text_.substr(start, position_ - start);
+    double unused;
+    return absl::SimpleAtod(value->raw_, &unused);
+  }
+
+  absl::string_view text_;
+  int position_ = 0;
+};
+
+std::string JsonValue::String() const {
+  if (!has_escapes_) return std::string(raw_);
+  return Unescape(raw_);
+}
+
+double JsonValue::Number() const {
+  double value = 0;
+  if (type_ == Type::kNumber && absl::SimpleAtod(raw_, &value)) return value;
+  return 0;
+}
+
+const JsonValue *JsonValue::Find(absl::string_view key) const {
+  for (const auto &member : members_)
+    if (member.first == key) return &member.second;
+  return nullptr;
+}
+
+absl::Status ParseJson(absl::string_view text, JsonValue *value) {
+  *value = JsonValue();
+  return JsonParser(text).Parse(value);
+}
+
+void AppendJsonString(absl::string_view str, std::string *out) {
+  static const char kHex[] = "0123456789abcdef";
+  out->reserve(out->size() + str.size() + 2);
+  *out += '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        *out += "\\\"";
+        break;
+      case '\\':
+        *out += "\\\\";
+        break;
+      case '\n':
+        *out += "\\n";
+        break;
+      case '\r':
+        *out += "\\r";
+        break;
+      case '\t':
+        *out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          *out += "\\u00";
+          *out += kHex[(c >> 4) & 0xF];
+          *out += kHex[c & 0xF];
+        } else {
+          *out += c;
+        }
+    }
+  }
+  *out += '"';
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,92 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_JSON_UTIL_H_
+#define SRC_JSON_UTIL_H_
+
+// A small JSON reader and writer helpers for the machine readable
+// input and output formats of the linter.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// A parsed JSON value. Strings and numbers are not copied, they refer to the
+// parsed text, so the text should outlive the value.
+class JsonValue {
+ public:
+  enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+  Type type() const { return type_; }
+
+  bool IsNull() const { return type_ == Type::kNull; }
+  bool IsString() const { return type_ == Type::kString; }
+  bool IsNumber() const { return type_ == Type::kNumber; }
+  bool IsObject() const { return type_ == Type::kObject; }
+  bool IsArray() const { return type_ == Type::kArray; }
+
+  // Returns the unescaped value of a string.
+  std::string String() const;
+
+  // Returns the value of a string without copying it. Escape sequences
+  // are not decoded, so it is only the real value if 'HasEscapes' is false.
+  absl::string_view RawString() const { return raw_; }
+
+  // Returns if a string contains escape sequences.
+  bool HasEscapes() const { return has_escapes_; }
+
+  // Returns the value of a number, or 0 for other types.
+  double Number() const;
+
+  // Returns the value of a boolean, or false for other types.
+  bool Bool() const { return bool_; }
+
+  // Returns the member of an object with <key>, or nullptr.
+  const JsonValue *Find(absl::string_view key) const;
+
+  // Returns elements of an array.
+  const std::vector<JsonValue> &Elements() const { return elements_; }
+
+  // Returns members of an object in the order they appear.
+  const std::vector<std::pair<std::string, JsonValue>> &Members() const {
+    return members_;
+  }
+
+ private:
+  friend class JsonParser;
+
+  Type type_ = Type::kNull;
+  absl::string_view raw_;
+  bool has_escapes_ = false;
+  bool bool_ = false;
+  std::vector<JsonValue> elements_;
+  std::vector<std::pair<std::string, JsonValue>> members_;
+};
+
+// Parses a whole JSON document.
+absl::Status ParseJson(absl::string_view text, JsonValue *value);
+
+// Appends <str> as a quoted and escaped JSON string.
+void AppendJsonString(absl::string_view str, std::string *out);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_JSON_UTIL_H_
@@ -0,0 +1,81 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/json_util.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(JsonUtilTest, ParseRecord) {
+  JsonValue value;
+  absl::string_view text =
+      "{\"query\": \"SELECT 'a'\\n\", \"user\":\"x\", \"job_id\": \"j1\", "
+      "\"bytes\": 1.5e3, \"tags\": [true, false, null], \"nested\": {}}";
+  ASSERT_TRUE(ParseJson(text, &value).ok());
+  ASSERT_TRUE(value.IsObject());
+
+  const JsonValue *query = value.Find("query");
+  ASSERT_NE(query, nullptr);
+  EXPECT_TRUE(query->HasEscapes());
+  EXPECT_EQ(query->String(), "SELECT 'a'\n");
+
+  // Strings without escapes refer to the parsed text.
+  const JsonValue *user = value.Find("user");
+  EXPECT_FALSE(user->HasEscapes());
+  EXPECT_EQ(user->RawString().data(), text.data() + text.find("x\""));
+
+  EXPECT_EQ(value.Find("bytes")->Number(), 1500);
+  EXPECT_EQ(value.Find("tags")->Elements().size(), 3);
+  EXPECT_TRUE(value.Find("tags")->Elements()[0].Bool());
+  EXPECT_TRUE(value.Find("tags")->Elements()[2].IsNull());
+  EXPECT_TRUE(value.Find("nested")->IsObject());
+  EXPECT_EQ(value.Find("missing"), nullptr);
+}
+
+TEST(JsonUtilTest, UnicodeEscapes) {
+  JsonValue value;
+  ASSERT_TRUE(ParseJson("\"\\u00e7\\ud83d\\ude00\\/\"", &value).ok());
+  EXPECT_EQ(value.String(), "\xc3\xa7\xf0\x9f\x98\x80/");
+}
+
+TEST(JsonUtilTest, InvalidDocuments) {
+  JsonValue value;
+  EXPECT_FALSE(ParseJson("", &value).ok());
+  EXPECT_FALSE(ParseJson("{\"a\": }", &value).ok());
+  EXPECT_FALSE(ParseJson("{\"a\": 1} x", &value).ok());
+  EXPECT_FALSE(ParseJson("\"\\x\"", &value).ok());
+  EXPECT_FALSE(ParseJson("\"unterminated", &value).ok());
+  EXPECT_FALSE(ParseJson(std::string(100, '['), &value).ok());
+}
+
+TEST(JsonUtilTest, AppendJsonString) {
+  std::string out;
+  AppendJsonString("a\"b\\c\n\x01", &out);
+  EXPECT_EQ(out, "\"a\\\"b\\\\c\\n\\u0001\"");
+
+  JsonValue value;
+  ASSERT_TRUE(ParseJson(out, &value).ok());
+  EXPECT_EQ(value.String(), "a\"b\\c\n\x01");
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
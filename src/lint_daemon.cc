@@ -0,0 +1,272 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/lint_daemon.h"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/text_format.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+#include "src/thread_pool.h"
+#include "src/wire_format.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Connections without a request for this many seconds are closed, so idle
+// clients don't keep workers busy.
+constexpr int kIdleTimeout = 30;
+
+// Configurations are parsed again when more than this many distinct ones
+// are in use, which bounds the memory of clients sending many of them.
+constexpr int kMaxConfigurations = 64;
+
+absl::Status MakeAddress(absl::string_view socket_path, sockaddr_un *address) {
+  if (socket_path.empty() || socket_path.size() >= sizeof(address->sun_path))
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid socket path: ", socket_path));
+  std::memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  std::memcpy(address->sun_path, socket_path.data(), socket_path.size());
+  return absl::OkStatus();
+}
+
+// Returns a socket connected to <socket_path> in <fd>.
+absl::Status Connect(absl::string_view socket_path, int *fd) {
+  sockaddr_un address;
+  absl::Status status = MakeAddress(socket_path, &address);
+  if (!status.ok()) return status;
+  *fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (*fd < 0)
+    return absl::InternalError(
+        absl::StrCat("Socket couldn't be created: ", std::strerror(errno)));
+  if (connect(*fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) !=
+      0) {
+    status = absl::UnavailableError(absl::StrCat(
+        "Couldn't connect to ", socket_path, ": ", std::strerror(errno)));
+    close(*fd);
+    *fd = -1;
+  }
+  return status;
+}
+
+}  // namespace
+
+LintDaemon::LintDaemon(absl::string_view socket_path, int num_threads,
+                       int max_pending, int cache_size,
+                       absl::string_view config_name)
+    : socket_path_(socket_path),
+      num_threads_(num_threads),
+      max_pending_(max_pending),
+      config_name_(config_name),
+      results_(cache_size) {}
+
+LintDaemon::~LintDaemon() {
+  int fd = listen_fd_.exchange(-1);
+  if (fd >= 0) close(fd);
+}
+
+absl::Status LintDaemon::Listen() {
+  sockaddr_un address;
+  absl::Status status = MakeAddress(socket_path_, &address);
+  if (!status.ok()) return status;
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return absl::InternalError(
+        absl::StrCat("Socket couldn't be created: ", std::strerror(errno)));
+
+  auto bind_socket = [&]() {
+    return bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+  };
+  int bound = bind_socket();
+  if (bound != 0 && errno == EADDRINUSE) {
+    // The socket file stays after its daemon dies. It is only replaced if
+    // nobody answers on it.
+    int probe = -1;
+    if (Connect(socket_path_, &probe).ok()) {
+      close(probe);
+      close(fd);
+      return absl::AlreadyExistsError(
+          absl::StrCat("A daemon is already listening on ", socket_path_));
+    }
+    unlink(socket_path_.c_str());
+    bound = bind_socket();
+  }
+  if (bound != 0 || listen(fd, SOMAXCONN) != 0) {
+    status = absl::InternalError(absl::StrCat(
+        "Couldn't listen on ", socket_path_, ": ", std::strerror(errno)));
+    close(fd);
+    return status;
+  }
+  listen_fd_ = fd;
+  return absl::OkStatus();
+}
+
+void LintDaemon::Serve() {
+  {
+    // Accepting blocks while <max_pending> connections wait for a worker.
+    ThreadPool pool(num_threads_, max_pending_);
+    while (!stopping_) {
+      int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (stopping_ || (errno != EINTR && errno != ECONNABORTED)) break;
+        continue;
+      }
+      pool.Schedule([this, fd]() { ServeConnection(fd); });
+    }
+  }
+  int fd = listen_fd_.exchange(-1);
+  if (fd >= 0) {
+    close(fd);
+    unlink(socket_path_.c_str());
+  }
+}
+
+void LintDaemon::Shutdown() {
+  stopping_ = true;
+  // Wakes up 'accept' and the workers waiting for requests.
+  shutdown(listen_fd_, SHUT_RDWR);
+  absl::MutexLock lock(&mutex_);
+  for (int fd : connections_) shutdown(fd, SHUT_RD);
+}
+
+void LintDaemon::ServeConnection(int fd) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (stopping_) {
+      close(fd);
+      return;
+    }
+    connections_.insert(fd);
+  }
+  timeval timeout = {kIdleTimeout, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  std::string payload;
+  while (ReadFrame(fd, &payload).ok()) {
+    LintRequest request;
+    LintResponse response;
+    absl::Status status = DecodeRequest(payload, &request);
+    if (status.ok())
+      response = Lint(request);
+    else
+      response.error = std::string(status.message());
+    if (!WriteFrame(fd, EncodeResponse(response)).ok()) break;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  connections_.erase(fd);
+  close(fd);
+}
+
+std::shared_ptr<const LintDaemon::Configuration> LintDaemon::GetConfiguration(
+    const std::string &text) {
+  uint64_t key = Fingerprint64(text);
+  absl::MutexLock lock(&mutex_);
+  auto it = configurations_.find(key);
+  if (it != configurations_.end()) return it->second;
+
+  auto configuration = std::make_shared<Configuration>();
+  Config config;
+  if (!google::protobuf::TextFormat::ParseFromString(text, &config)) {
+    configuration->status =
+        absl::InvalidArgumentError("Configuration couldn't be parsed.");
+  } else {
+    absl::Status status = ValidateConfig(config);
+    if (status.ok())
+      configuration->resolver =
+          std::make_unique<ConfigResolver>(config, config_name_);
+    else
+      configuration->status = absl::InvalidArgumentError(
+          absl::StrCat("Invalid configuration: ", status.message()));
+  }
+  if (configurations_.size() >= kMaxConfigurations) configurations_.clear();
+  configurations_[key] = configuration;
+  return configuration;
+}
+
+LintResponse LintDaemon::Lint(const LintRequest &request) {
+  LintResponse response;
+  std::shared_ptr<const Configuration> configuration =
+      GetConfiguration(request.config);
+  if (!configuration->status.ok()) {
+    response.error = std::string(configuration->status.message());
+    return response;
+  }
+
+  for (const LintRequestFile &file : request.files) {
+    std::shared_ptr<const ResolvedConfig> config =
+        configuration->resolver->Resolve(file.name);
+    uint64_t key = CombineFingerprints(config->fingerprint,
+                                       Fingerprint64(file.content));
+    std::shared_ptr<const std::vector<LintFinding>> findings =
+        results_.Find(key);
+    if (findings != nullptr) {
+      ++hits_;
+    } else {
+      LinterResult result =
+          RunChecks(file.content, config->options, file.name);
+      result.Sort();
+      auto new_findings = std::make_shared<std::vector<LintFinding>>();
+      for (LintError &error : result.GetErrors()) {
+        auto [line, column] = error.GetPosition();
+        new_findings->push_back({error.ErrorCodeToString(), line, column,
+                                 error.GetErrorMessage()});
+      }
+      findings = new_findings;
+      // Results with status messages, e.g. internal errors, are not cached.
+      if (result.GetStatus().empty()) results_.Insert(key, findings);
+    }
+    response.files.push_back({file.name, *findings});
+  }
+  return response;
+}
+
+absl::Status CallLintDaemon(absl::string_view socket_path,
+                            const LintRequest &request,
+                            LintResponse *response) {
+  int fd = -1;
+  absl::Status status = Connect(socket_path, &fd);
+  if (!status.ok()) return status;
+  std::string payload;
+  status = WriteFrame(fd, EncodeRequest(request));
+  if (status.ok()) status = ReadFrame(fd, &payload);
+  if (status.ok()) status = DecodeResponse(payload, response);
+  close(fd);
+  return status;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,119 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_LINT_DAEMON_H_
+#define SRC_LINT_DAEMON_H_
+
+// A long lived linter process serving lint requests over a Unix domain
+// socket, see 'wire_format.h' for the messages.
+//
+// Clients like editor plugins and pre-commit hooks don't pay the startup
+// cost of a linter process for every invocation. The daemon keeps parsed
+// configurations, their per directory configuration files, and the results
+// of recently linted file contents in memory.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/config_resolver.h"
+#include "src/generational_cache.h"
+#include "src/wire_format.h"
+
+namespace zetasql::linter {
+
+class LintDaemon {
+ public:
+  // Requests are served by <num_threads> workers. At most <max_pending>
+  // accepted connections wait for a worker, later clients wait in the
+  // listen queue of the socket. Results of at most <cache_size> file
+  // contents are kept. Per directory configuration files are named
+  // <config_name>, like in 'ConfigResolver'.
+  LintDaemon(absl::string_view socket_path, int num_threads, int max_pending,
+             int cache_size,
+             absl::string_view config_name = kDirectoryConfigName);
+
+  // Closes the socket, if it is still open.
+  ~LintDaemon();
+
+  LintDaemon(const LintDaemon &) = delete;
+  LintDaemon &operator=(const LintDaemon &) = delete;
+
+  // Creates the socket. Fails if another daemon is listening on it, a stale
+  // socket file of a dead daemon is replaced.
+  absl::Status Listen();
+
+  // Accepts and serves connections until 'Shutdown' is called, then waits
+  // for running requests and removes the socket.
+  void Serve();
+
+  // Makes 'Serve' return. It is safe to call from any thread.
+  void Shutdown();
+
+  // Lints all files of <request>. It is safe to call from multiple threads.
+  LintResponse Lint(const LintRequest &request);
+
+  // Returns the number of files that were served from the result cache.
+  int64_t Hits() const { return hits_; }
+
+ private:
+  // A parsed base configuration with its per directory configurations.
+  struct Configuration {
+    absl::Status status;
+    std::unique_ptr<ConfigResolver> resolver;
+  };
+
+  // Returns the configuration of a request, parsed once per distinct text.
+  std::shared_ptr<const Configuration> GetConfiguration(
+      const std::string &text);
+
+  // Answers requests of a connection until the client closes it.
+  void ServeConnection(int fd);
+
+  const std::string socket_path_;
+  const int num_threads_;
+  const int max_pending_;
+  const std::string config_name_;
+  std::atomic<int> listen_fd_{-1};
+  std::atomic<bool> stopping_{false};
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<const Configuration>>
+      configurations_ ABSL_GUARDED_BY(mutex_);
+  // Sockets of open connections, closed for reading by 'Shutdown'.
+  absl::flat_hash_set<int> connections_ ABSL_GUARDED_BY(mutex_);
+
+  GenerationalCache<std::vector<LintFinding>> results_;
+  std::atomic<int64_t> hits_{0};
+};
+
+// Sends <request> to the daemon listening on <socket_path> and waits for its
+// response.
+absl::Status CallLintDaemon(absl::string_view socket_path,
+                            const LintRequest &request,
+                            LintResponse *response);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_LINT_DAEMON_H_
@@ -0,0 +1,115 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/lint_daemon.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "gtest/gtest.h"
+#include "src/wire_format.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(LintDaemonTest, ServesRequests) {
+  std::string socket_path = testing::TempDir() + "/lint_daemon.sock";
+  LintDaemon daemon(socket_path, 2, 4, 100, "");
+  ASSERT_TRUE(daemon.Listen().ok());
+  std::thread server([&daemon]() { daemon.Serve(); });
+
+  // Only one daemon listens on a socket.
+  LintDaemon other(socket_path, 1, 1, 1, "");
+  EXPECT_TRUE(absl::IsAlreadyExists(other.Listen()));
+
+  LintRequest request;
+  request.config = "line_limit: 20\n";
+  request.files.push_back({"a.sql", "SELECT a b FROM T;\n"});
+  request.files.push_back({"b.sql", "SELECT 1;\n"});
+  LintResponse response;
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &response).ok());
+  EXPECT_EQ(response.error, "");
+  ASSERT_EQ(response.files.size(), 2);
+  EXPECT_EQ(response.files[0].name, "a.sql");
+  ASSERT_FALSE(response.files[0].findings.empty());
+  EXPECT_EQ(response.files[0].findings[0].check, "alias");
+  EXPECT_EQ(response.files[0].findings[0].line, 1);
+  EXPECT_TRUE(response.files[1].findings.empty());
+  EXPECT_EQ(daemon.Hits(), 0);
+
+  // The same content under another name is served from the cache.
+  request.files = {{"c.sql", "SELECT a b FROM T;\n"}};
+  LintResponse cached;
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &cached).ok());
+  ASSERT_EQ(cached.files.size(), 1);
+  EXPECT_EQ(cached.files[0].name, "c.sql");
+  EXPECT_EQ(cached.files[0].findings.size(),
+            response.files[0].findings.size());
+  EXPECT_EQ(daemon.Hits(), 1);
+
+  request.config = "line_limit: ";
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &response).ok());
+  EXPECT_NE(response.error, "");
+
+  // Invalid rules are reported instead of being skipped.
+  request.config = "custom_rule { name: \"unbalanced\" pattern: \"(\" }";
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &response).ok());
+  EXPECT_TRUE(absl::StrContains(response.error, "unbalanced"))
+      << response.error;
+
+  daemon.Shutdown();
+  server.join();
+  EXPECT_FALSE(CallLintDaemon(socket_path, request, &response).ok());
+}
+
+TEST(LintDaemonTest, RereadsDirectoryConfigs) {
+  std::string root = testing::TempDir() + "/daemon_configs";
+  mkdir(root.c_str(), 0755);
+  std::string config = root + "/.zetasql-lint.textproto";
+  std::ofstream(config) << "line_limit: 100";
+  std::string socket_path = testing::TempDir() + "/daemon_configs.sock";
+  LintDaemon daemon(socket_path, 1, 1, 100);
+  ASSERT_TRUE(daemon.Listen().ok());
+  std::thread server([&daemon]() { daemon.Serve(); });
+
+  LintRequest request;
+  request.files.push_back({root + "/a.sql", "SELECT 1 + 2 + 3 + 4;\n"});
+  LintResponse response;
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &response).ok());
+  ASSERT_EQ(response.files.size(), 1);
+  EXPECT_TRUE(response.files[0].findings.empty());
+
+  // The edited configuration is used, instead of the cached result.
+  std::ofstream(config) << "line_limit: 10";
+  ASSERT_TRUE(CallLintDaemon(socket_path, request, &response).ok());
+  ASSERT_EQ(response.files.size(), 1);
+  ASSERT_EQ(response.files[0].findings.size(), 1);
+  EXPECT_EQ(response.files[0].findings[0].check, "line-limit-exceed");
+  EXPECT_EQ(daemon.Hits(), 0);
+
+  daemon.Shutdown();
+  server.join();
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
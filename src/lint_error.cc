@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,6 +25,7 @@
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "src/utf8.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
 #include "zetasql/base/statusor.h"
@@ -34,6 +36,28 @@
 
 namespace zetasql::linter {
 
+namespace {
+
+// Returns the position where the line of <position> starts. Lines end with
+// "\n", "\r" or "\r\n", same with ZetaSQL.
+size_t LineStart(absl::string_view sql, size_t position) {
+  const size_t line_end = sql.substr(0, position).find_last_of("\r\n");
+  return line_end == absl::string_view::npos ? 0 : line_end + 1;
+}
+
+// Returns the 1-based number of the line after <text>.
+int CountLines(absl::string_view text) {
+  int lines = 1;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '\n' || (text[i] == '\r' && (i + 1 == text.size() ||
+                                                 text[i + 1] != '\n')))
+      ++lines;
+  }
+  return lines;
+}
+
+}  // namespace
+
 std::ostream& operator<<(std::ostream& os, const ErrorCode& obj) {
   std::string s = "No such ErrorCode";
   for (auto& it : GetErrorMap())
@@ -67,7 +91,13 @@ std::map<std::string, ErrorCode> GetErrorMap() {
       {"count-star", ErrorCode::kCountStar},
       {"keyword-identifier", ErrorCode::kKeywordIdentifier},
       {"specify-table", ErrorCode::kSpecifyTable},
-      {"status", ErrorCode::kStatus}};
+      {"status", ErrorCode::kStatus},
+      {"utf8-encoding", ErrorCode::kUtf8Encoding},
+      {"custom-rule", ErrorCode::kCustomRule},
+      {"ast-rule", ErrorCode::kAstRule},
+      {"unknown-column", ErrorCode::kUnknownColumn},
+      {"ambiguous-column", ErrorCode::kAmbiguousColumn},
+      {"join-key-type", ErrorCode::kJoinKeyType}};
   return error_map;
 }
 std::string LintError::GetErrorMessage() { return message_; }
@@ -85,17 +115,15 @@ std::string LintError::ErrorCodeToString() {
   return "";
 }
 
-void LintError::PrintError() {
-  if (filename_ == "") {
-    std::cout << ConstructPositionMessage() << GetErrorMessage() << " ["
-              << ErrorCodeToString() << "]" << std::endl;
-  } else {
-    std::cout << filename_ << ":" << ConstructPositionMessage()
-              << GetErrorMessage() << " [" << ErrorCodeToString() << "]"
-              << std::endl;
-  }
+std::string LintError::ToString() {
+  std::string text = absl::StrCat(ConstructPositionMessage(), GetErrorMessage(),
+                                  " [", ErrorCodeToString(), "]");
+  if (filename_ == "") return text;
+  return absl::StrCat(filename_, ":", text);
 }
 
+void LintError::PrintError() { std::cout << ToString() << std::endl; }
+
 void LinterResult::PrintResult() {
   Sort();
   for (LintError error : errors_) error.PrintError();
@@ -122,12 +150,25 @@ LinterResult::LinterResult(const absl::Status& status) {
 absl::Status LinterResult::Add(absl::string_view filename, ErrorCode type,
                                absl::string_view sql, int character_location,
                                std::string message) {
-  ParseLocationPoint lp =
-      ParseLocationPoint::FromByteOffset(character_location);
-  ParseLocationTranslator lt(sql);
   std::pair<int, int> error_pos;
-  ZETASQL_ASSIGN_OR_RETURN(error_pos, lt.GetLineAndColumnAfterTabExpansion(lp));
-  LintError t(type, filename, error_pos.first, error_pos.second, message);
+  const size_t end = std::min<size_t>(character_location, sql.size());
+  const size_t line_start = LineStart(sql, end);
+  const absl::string_view line =
+      sql.substr(line_start, sql.find_first_of("\r\n", end) - line_start);
+  if (IsAscii(line)) {
+    ParseLocationPoint lp =
+        ParseLocationPoint::FromByteOffset(character_location);
+    ParseLocationTranslator lt(sql);
+    ZETASQL_ASSIGN_OR_RETURN(error_pos,
+                             lt.GetLineAndColumnAfterTabExpansion(lp));
+  } else {
+    // Columns of lines with other characters are counted in characters
+    // instead of bytes, and malformed UTF-8 is counted byte by byte.
+    error_pos.first = CountLines(sql.substr(0, line_start));
+    error_pos.second = DisplayColumn(sql.substr(line_start, end - line_start));
+  }
+  LintError t(type, filename, error_pos.first, error_pos.second, message,
+              character_location);
   errors_.push_back(t);
   return absl::OkStatus();
 }
@@ -138,9 +179,17 @@ void LinterResult::Add(ErrorCode type, absl::string_view sql,
   Add(filename_, type, sql, character_location, message).IgnoreError();
 }
 
+void LinterResult::Add(ErrorCode type, absl::string_view sql,
+                       int character_location, std::string message,
+                       std::vector<TextEdit> fix) {
+  size_t count = errors_.size();
+  Add(type, sql, character_location, message);
+  if (errors_.size() > count) errors_.back().SetFix(std::move(fix));
+}
+
 void LinterResult::Add(ErrorCode type, int line, int column,
-                       absl::string_view message) {
-  errors_.push_back(LintError(type, filename_, line, column, message));
+                       absl::string_view message, int offset) {
+  errors_.push_back(LintError(type, filename_, line, column, message, offset));
 }
 
 void LinterResult::Add(LinterResult result) {
@@ -160,4 +209,18 @@ void LinterResult::Sort() {
        });
 }
 
+void LinterResult::ShiftPositions(int lines, int columns) {
+  for (LintError& error : errors_) {
+    auto [line, column] = error.GetPosition();
+    if (line == 1) column += columns;
+    error.SetPosition(line + lines, column);
+  }
+}
+
+void LinterResult::RemoveErrors(
+    const std::function<bool(const LintError&)>& remove) {
+  errors_.erase(std::remove_if(errors_.begin(), errors_.end(), remove),
+                errors_.end());
+}
+
 }  // namespace zetasql::linter
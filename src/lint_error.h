@@ -17,6 +17,7 @@
 #ifndef SRC_LINT_ERROR_H_
 #define SRC_LINT_ERROR_H_
 
+#include <functional>
 #include <iostream>
 #include <map>
 #include <string>
@@ -53,6 +54,12 @@ enum class ErrorCode : int {
   kSpecifyTable,
   kStatus,
   kNoLint,
+  kUtf8Encoding,
+  kCustomRule,
+  kAstRule,
+  kUnknownColumn,
+  kAmbiguousColumn,
+  kJoinKeyType,
   COUNT,  // This is not a real ErrorCode, It is for checking if every ErrorCode
           // has a string. This should always at the end and no new check should
           // have an assigned value.
@@ -63,15 +70,24 @@ std::ostream& operator<<(std::ostream& os, const ErrorCode& obj);
 // Returns string mapping of each ErrorCode
 std::map<std::string, ErrorCode> GetErrorMap();
 
+// A replacement of <length> bytes at byte <offset> of the linted text with
+// <replacement>. An insertion has zero length.
+struct TextEdit {
+  int offset;
+  int length;
+  std::string replacement;
+};
+
 // Stores properties of a single lint error.
 class LintError {
  public:
   LintError(ErrorCode type, absl::string_view filename, int line, int column,
-            absl::string_view message)
+            absl::string_view message, int offset = -1)
       : type_(type),
         filename_(filename),
         line_(line),
         column_(column),
+        offset_(offset),
         message_(message) {}
 
   // Returns the raw form of error message, (without position information).
@@ -89,6 +105,9 @@ class LintError {
   // Returns mapped string that corresponds to the error type.
   std::string ErrorCodeToString();
 
+  // Returns the error in the format 'PrintError' prints it.
+  std::string ToString();
+
   // This function outputs lint errors of successful checks
   // and status messages of failed checks.
   void PrintError();
@@ -96,9 +115,26 @@ class LintError {
   // Returns the line number where the error occurred.
   int GetLineNumber() const { return line_; }
 
+  // Changes the position of the error.
+  void SetPosition(int line, int column) {
+    line_ = line;
+    column_ = column;
+  }
+
   // Returns the type of the lint error
   ErrorCode GetType() const { return type_; }
 
+  // Returns the byte offset in the linted text where the error occurred,
+  // or -1 if the error is only known by its line and column.
+  int GetOffset() const { return offset_; }
+
+  // Returns the edits that fix the error together, it is empty if the error
+  // doesn't have an automatic fix.
+  const std::vector<TextEdit>& GetFix() const { return fix_; }
+
+  // Sets the edits that fix the error.
+  void SetFix(std::vector<TextEdit> fix) { fix_ = std::move(fix); }
+
  private:
   // Holds type of the lint error. Type of an error is a number
   // that corresponds to a specific linter check.
@@ -113,8 +149,14 @@ class LintError {
   // Column number where the lint error occurred.
   int column_;
 
+  // Byte offset where the lint error occurred.
+  int offset_;
+
   // Error message that will be printed.
   std::string message_ = "";
+
+  // Edits of the automatic fix.
+  std::vector<TextEdit> fix_;
 };
 
 // It is the result of a linter run.
@@ -144,8 +186,15 @@ class LinterResult {
   void Add(ErrorCode type, absl::string_view sql, int character_location,
            std::string message);
 
-  // Direct addition of a lint error.
-  void Add(ErrorCode type, int line, int column, absl::string_view message);
+  // Same with above function, the error can be fixed by applying all
+  // edits in <fix> to 'sql'.
+  void Add(ErrorCode type, absl::string_view sql, int character_location,
+           std::string message, std::vector<TextEdit> fix);
+
+  // Direct addition of a lint error. <offset> is the byte offset of the
+  // position, if it is known.
+  void Add(ErrorCode type, int line, int column, absl::string_view message,
+           int offset = -1);
 
   // This function adds all errors in 'result' to this
   // It basicly combines two result.
@@ -160,11 +209,19 @@ class LinterResult {
   // Sorts all errors.
   void Sort();
 
+  // Moves all errors <lines> lines down. Errors in the first line are also
+  // moved <columns> columns right. It is used when a part of a file is
+  // linted separately from the rest.
+  void ShiftPositions(int lines, int columns);
+
+  // Removes errors that <remove> returns true for.
+  void RemoveErrors(const std::function<bool(const LintError&)>& remove);
+
   // Returns all Lint Errors that are detected.
-  std::vector<LintError> GetErrors() { return errors_; }
+  std::vector<LintError> GetErrors() const { return errors_; }
 
   // Returns all Status Errors that are occurred.
-  std::vector<absl::Status> GetStatus() { return status_; }
+  std::vector<absl::Status> GetStatus() const { return status_; }
 
   // Output the result in a user-readable format. This function
   // will be used to inform user about lint errors in their sql file.
@@ -30,11 +30,16 @@
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
 #include "re2/re2.h"
+#include "src/ast_rules.h"
 #include "src/checks.h"
 #include "src/checks_list.h"
+#include "src/checks_util.h"
 #include "src/config.pb.h"
+#include "src/custom_rules.h"
 #include "src/lint_error.h"
 #include "src/linter_options.h"
+#include "src/pattern_matcher.h"
+#include "src/schema_catalog.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
 #include "zetasql/public/error_helpers.h"
@@ -138,7 +143,7 @@ LinterResult CheckParserSucceeds(absl::string_view sql,
   return result;
 }
 
-void GetOptionsFromConfig(Config config, LinterOptions* options) {
+void GetOptionsFromConfig(const Config& config, LinterOptions* options) {
   if (config.has_tab_size()) options->SetTabSize(config.tab_size());
 
   if (config.has_end_line()) options->SetLineDelimeter(config.end_line()[0]);
@@ -153,9 +158,21 @@ void GetOptionsFromConfig(Config config, LinterOptions* options) {
   if (config.has_upper_keyword())
     options->SetUpperKeyword(config.upper_keyword());
 
+  if (config.custom_rule_size() > 0)
+    options->SetCustomRules(CustomRuleSet::ForConfig(config));
+
+  if (config.ast_rule_size() > 0)
+    options->SetAstRules(AstRuleSet::ForConfig(config));
+
+  if (config.has_schema()) {
+    std::shared_ptr<SchemaCatalog> catalog;
+    if (SchemaCatalog::Shared(config.schema(), &catalog).ok())
+      options->SetCatalog(std::move(catalog));
+  }
+
   std::map<std::string, ErrorCode> error_map = GetErrorMap();
 
-  for (const std::string check_name : config.nolint()) {
+  for (const std::string& check_name : config.nolint()) {
     if (error_map.count(check_name)) {
       options->DisableCheck(error_map[check_name]);
     }
@@ -166,6 +183,10 @@ LinterResult RunChecks(absl::string_view sql, LinterOptions* options) {
   ChecksList list = GetAllChecks();
   LinterResult result = ParseNoLintComments(sql, options);
   result.SetFilename(options->Filename());
+  if (options->TextMatches() == nullptr) {
+    options->SetTextMatches(std::make_shared<const std::vector<TextMatch>>(
+        FindTextPatterns(sql, *options)));
+  }
 
   // This check should come strictly before others, and able to
   // change options.
@@ -177,7 +198,7 @@ LinterResult RunChecks(absl::string_view sql, LinterOptions* options) {
   return result;
 }
 
-LinterResult RunChecks(absl::string_view sql, Config config,
+LinterResult RunChecks(absl::string_view sql, const Config& config,
                        absl::string_view filename) {
   LinterOptions options(filename);
   GetOptionsFromConfig(config, &options);
@@ -189,9 +210,69 @@ LinterResult RunChecks(absl::string_view sql, absl::string_view filename) {
   return RunChecks(sql, &options);
 }
 
+LinterResult RunChecks(absl::string_view sql, const LinterOptions& options,
+                       absl::string_view filename) {
+  LinterOptions copy = options;
+  copy.SetFilename(filename);
+  return RunChecks(sql, &copy);
+}
+
+LinterResult RunStatementChecks(absl::string_view statement,
+                                const Config& config, int line, int column) {
+  // Same with 'ReadFile', checks like 'CheckLineLength' only look at lines
+  // ending with a newline.
+  std::string sql(statement);
+  if (sql.empty() || sql.back() != '\n') sql += '\n';
+  LinterResult result = RunChecks(sql, config, "");
+  result.ShiftPositions(line, column);
+  result.Sort();
+  return result;
+}
+
 LinterResult RunChecks(absl::string_view sql) {
   LinterOptions options;
   return RunChecks(sql, &options);
 }
 
+std::vector<LinterResult> RunChecks(absl::string_view sql,
+                                    const std::vector<Config>& configs,
+                                    absl::string_view filename) {
+  // Outputs are shared only if every statement is parsed. Otherwise the
+  // parser error depends on NOLINT comments of each configuration, and each
+  // of them runs 'CheckParserSucceeds' like a single run.
+  std::vector<std::shared_ptr<ParserOutput>> outputs;
+  ParseResumeLocation location = ParseResumeLocation::FromStringView(sql);
+  bool is_the_end = false;
+  bool parsed = true;
+  while (parsed && !is_the_end) {
+    std::unique_ptr<ParserOutput> output;
+    parsed = ParseNextScriptStatement(&location, ParserOptions(), &output,
+                                      &is_the_end)
+                 .ok();
+    outputs.push_back(std::move(output));
+  }
+  auto keywords = std::make_shared<const std::vector<ParseToken>>(
+      GetKeywords(sql, ErrorCode::kLetterCase));
+
+  std::vector<LinterResult> results;
+  for (const Config& config : configs) {
+    LinterOptions options(filename);
+    GetOptionsFromConfig(config, &options);
+    options.SetKeywords(keywords);
+    if (!parsed) {
+      results.push_back(RunChecks(sql, &options));
+      continue;
+    }
+    options.SetParserOutputs(outputs);
+    LinterResult result = ParseNoLintComments(sql, &options);
+    result.SetFilename(filename);
+    options.SetTextMatches(std::make_shared<const std::vector<TextMatch>>(
+        FindTextPatterns(sql, options)));
+    for (const auto check : GetAllChecks().GetList())
+      result.Add(check(sql, options));
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
 }  // namespace zetasql::linter
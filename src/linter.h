@@ -52,21 +52,41 @@ LinterResult CheckParserSucceeds(absl::string_view sql, LinterOptions* options);
 
 // This function gets LinterOptions from a specified
 // configuration file.
-void GetOptionsFromConfig(Config config, LinterOptions* options);
+void GetOptionsFromConfig(const Config& config, LinterOptions* options);
 
 // It runs all linter checks
 LinterResult RunChecks(absl::string_view sql, LinterOptions* options);
 
 // It runs all linter checks
-LinterResult RunChecks(absl::string_view sql, Config config,
+LinterResult RunChecks(absl::string_view sql, const Config& config,
                        absl::string_view filename);
 
 // It runs all linter checks
 LinterResult RunChecks(absl::string_view sql, absl::string_view filename);
 
+// Runs all linter checks with a copy of <options>, like the options of a
+// 'ResolvedConfig' that are shared by the files of a directory.
+LinterResult RunChecks(absl::string_view sql, const LinterOptions& options,
+                       absl::string_view filename);
+
+// Runs all linter checks on <statement>, a part of a stream that starts at
+// 0-based <line> and <column> of it, like statements of 'StatementSplitter'.
+// The statement is checked like a file ending with a newline, so its last
+// line is checked like the others. Findings are sorted and their positions
+// are in the stream.
+LinterResult RunStatementChecks(absl::string_view statement,
+                                const Config& config, int line, int column);
+
 // It runs all linter checks
 LinterResult RunChecks(absl::string_view sql);
 
+// Runs all linter checks once for each of <configs>, and returns a result
+// for each of them. The sql is tokenized and parsed only once, and the
+// checks of all configurations use the same parser outputs.
+std::vector<LinterResult> RunChecks(absl::string_view sql,
+                                    const std::vector<Config>& configs,
+                                    absl::string_view filename);
+
 }  // namespace zetasql::linter
 
 #endif  // SRC_LINTER_H_
@@ -46,6 +46,11 @@ void LinterOptions::DisableCheck(ErrorCode code) {
   option_map_[code].SetActiveStart(false);
 }
 
+void LinterOptions::EnableCheck(ErrorCode code) {
+  if (!option_map_.count(code)) option_map_[code] = CheckOptions();
+  option_map_[code].SetActiveStart(true);
+}
+
 bool LinterOptions::CheckOptions::IsActive(int position) const {
   bool active = active_start_;
   for (int i = 0;
@@ -36,10 +36,16 @@
 #include <vector>
 
 #include "src/lint_error.h"
+#include "src/pattern_matcher.h"
 #include "zetasql/public/parse_helpers.h"
+#include "zetasql/public/parse_tokens.h"
 
 namespace zetasql::linter {
 
+class AstRuleSet;
+class CustomRuleSet;
+class SchemaCatalog;
+
 class LinterOptions {
   class CheckOptions;
 
@@ -71,15 +77,64 @@ class LinterOptions {
   // Adds a single parser output to parset_output_
   void AddParserOutput(std::unique_ptr<ParserOutput> output);
 
+  // Uses <outputs> of an earlier parse of the same sql, instead of parsing
+  // again.
+  void SetParserOutputs(std::vector<std::shared_ptr<ParserOutput>> outputs) {
+    parser_outputs_ = std::move(outputs);
+    remember_parser_ = true;
+  }
+
   // Changes if any lint is active from the start.
   void DisableCheck(ErrorCode code);
 
+  // Makes a lint active from the start.
+  void EnableCheck(ErrorCode code);
+
   // ---------------------------------- GETTER/SETTER functions
 
-  const std::vector<std::unique_ptr<ParserOutput>> &ParserOutputs() const {
+  const std::vector<std::shared_ptr<ParserOutput>> &ParserOutputs() const {
     return parser_outputs_;
   }
 
+  // Keywords of the sql from an earlier tokenization, or null.
+  const std::shared_ptr<const std::vector<ParseToken>> &Keywords() const {
+    return keywords_;
+  }
+  void SetKeywords(std::shared_ptr<const std::vector<ParseToken>> val) {
+    keywords_ = std::move(val);
+  }
+
+  // Matches of text patterns from an earlier scan of the sql, or null.
+  const std::shared_ptr<const std::vector<TextMatch>> &TextMatches() const {
+    return text_matches_;
+  }
+  void SetTextMatches(std::shared_ptr<const std::vector<TextMatch>> val) {
+    text_matches_ = std::move(val);
+  }
+
+  // Compiled custom rules of the configuration, or null.
+  const std::shared_ptr<const CustomRuleSet> &CustomRules() const {
+    return custom_rules_;
+  }
+  void SetCustomRules(std::shared_ptr<const CustomRuleSet> val) {
+    custom_rules_ = std::move(val);
+  }
+
+  // Compiled syntax tree rules of the configuration, or null.
+  const std::shared_ptr<const AstRuleSet> &AstRules() const {
+    return ast_rules_;
+  }
+  void SetAstRules(std::shared_ptr<const AstRuleSet> val) {
+    ast_rules_ = std::move(val);
+  }
+
+  // Catalog of the schema of the configuration, or null. It is shared by
+  // all threads.
+  const std::shared_ptr<SchemaCatalog> &Catalog() const { return catalog_; }
+  void SetCatalog(std::shared_ptr<SchemaCatalog> val) {
+    catalog_ = std::move(val);
+  }
+
   bool RememberParser() const { return remember_parser_; }
   void SetRememberParser(bool val) { remember_parser_ = val; }
 
@@ -133,8 +188,24 @@ class LinterOptions {
   // It will optimize linter to make only one parser call.
   bool remember_parser_ = false;
 
-  // If remember_parser_ is enabled, this will hold parser output.
-  std::vector<std::unique_ptr<ParserOutput>> parser_outputs_;
+  // If remember_parser_ is enabled, this will hold parser output. Outputs
+  // can be shared by options of different configurations.
+  std::vector<std::shared_ptr<ParserOutput>> parser_outputs_;
+
+  // If it isn't null, keywords are not tokenized again.
+  std::shared_ptr<const std::vector<ParseToken>> keywords_;
+
+  // If it isn't null, text patterns are not searched again.
+  std::shared_ptr<const std::vector<TextMatch>> text_matches_;
+
+  // Custom rules checked by 'CheckCustomRules'.
+  std::shared_ptr<const CustomRuleSet> custom_rules_;
+
+  // Syntax tree rules checked by 'CheckAstRules'.
+  std::shared_ptr<const AstRuleSet> ast_rules_;
+
+  // Catalog of 'CheckSemantics'.
+  std::shared_ptr<SchemaCatalog> catalog_;
 
   // Name of the sql file.
   absl::string_view filename_ = "";
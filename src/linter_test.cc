@@ -25,6 +25,7 @@
 
 #include "absl/strings/match.h"
 #include "gtest/gtest.h"
+#include "src/config.pb.h"
 #include "src/lint_error.h"
 #include "src/linter_options.h"
 
@@ -85,5 +86,46 @@ TEST(LinterTest, StatementValidityCheck) {
   EXPECT_FALSE(CheckParserSucceeds("SELECT 1; SELECT 2 3 4;", &options).ok());
 }
 
+TEST(LinterTest, SeveralConfigs) {
+  Config lower;
+  lower.set_upper_keyword(false);
+  Config short_lines;
+  short_lines.set_line_limit(10);
+  short_lines.add_nolint("alias");
+  std::vector<Config> configs = {Config(), lower, short_lines};
+
+  for (absl::string_view sql :
+       {"SELECT a b FROM T;\nselect COUNT(1) FROM T;\n", "SELECT 1 2;\n"}) {
+    std::vector<LinterResult> results = RunChecks(sql, configs, "a.sql");
+    ASSERT_EQ(results.size(), configs.size());
+    for (int i = 0; i < static_cast<int>(configs.size()); ++i) {
+      LinterResult expected = RunChecks(sql, configs[i], "a.sql");
+      expected.Sort();
+      results[i].Sort();
+      std::vector<LintError> errors = results[i].GetErrors();
+      std::vector<LintError> expected_errors = expected.GetErrors();
+      ASSERT_EQ(errors.size(), expected_errors.size());
+      for (int j = 0; j < static_cast<int>(errors.size()); ++j)
+        EXPECT_EQ(errors[j].ToString(), expected_errors[j].ToString());
+    }
+  }
+}
+
+TEST(LinterTest, RunStatementChecks) {
+  Config config;
+  config.set_line_limit(20);
+  // The statement starts at line 3, column 6 of the stream, and its last
+  // line is too long.
+  LinterResult result =
+      RunStatementChecks("\nSELECT a\nFROM Table1 AS t WHERE t.a > 1;",
+                         config, 2, 5);
+  std::vector<LintError> errors = result.GetErrors();
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors[0].GetType(), ErrorCode::kLineLimit);
+  EXPECT_EQ(errors[0].GetLineNumber(), 5);
+
+  EXPECT_TRUE(RunStatementChecks("SELECT a FROM T;", config, 0, 0).ok());
+}
+
 }  // namespace
 }  // namespace zetasql::linter
@@ -0,0 +1,373 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/lsp_server.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/json_util.h"
+#include "src/lint_error.h"
+#include "src/rope.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr absl::string_view kContentLength = "Content-Length:";
+
+// JSON-RPC error codes.
+constexpr int kParseError = -32700;
+constexpr int kMethodNotFound = -32601;
+
+// Diagnostic severities.
+constexpr int kSeverityError = 1;
+constexpr int kSeverityWarning = 2;
+
+const JsonValue &Member(const JsonValue &object, absl::string_view key) {
+  static const JsonValue *const kNull = new JsonValue();
+  const JsonValue *value = object.Find(key);
+  return value == nullptr ? *kNull : *value;
+}
+
+int IntMember(const JsonValue &object, absl::string_view key) {
+  return static_cast<int>(Member(object, key).Number());
+}
+
+// Appends a request id, which is a number or a string.
+void AppendId(const JsonValue &id, std::string *out) {
+  if (id.IsString())
+    AppendJsonString(id.String(), out);
+  else if (id.IsNumber())
+    absl::StrAppend(out, id.RawString());
+  else
+    *out += "null";
+}
+
+std::string Response(const JsonValue &id, absl::string_view result) {
+  std::string out = "{\"jsonrpc\": \"2.0\", \"id\": ";
+  AppendId(id, &out);
+  absl::StrAppend(&out, ", \"result\": ", result, "}");
+  return out;
+}
+
+std::string ErrorResponse(const JsonValue &id, int code,
+                          absl::string_view message) {
+  std::string out = "{\"jsonrpc\": \"2.0\", \"id\": ";
+  AppendId(id, &out);
+  absl::StrAppend(&out, ", \"error\": {\"code\": ", code, ", \"message\": ");
+  AppendJsonString(message, &out);
+  out += "}}";
+  return out;
+}
+
+std::string PublishDiagnostics(absl::string_view uri, int64_t version,
+                               absl::string_view diagnostics) {
+  std::string out =
+      "{\"jsonrpc\": \"2.0\", \"method\": "
+      "\"textDocument/publishDiagnostics\", \"params\": {\"uri\": ";
+  AppendJsonString(uri, &out);
+  if (version >= 0) absl::StrAppend(&out, ", \"version\": ", version);
+  absl::StrAppend(&out, ", \"diagnostics\": ", diagnostics, "}}");
+  return out;
+}
+
+// Returns the path of a 'file' URI, other URIs are returned unchanged.
+std::string FilenameFromUri(absl::string_view uri) {
+  if (!absl::ConsumePrefix(&uri, "file://")) return std::string(uri);
+  std::string filename;
+  for (int i = 0; i < static_cast<int>(uri.size()); ++i) {
+    int value = 0;
+    if (uri[i] == '%' && i + 2 < static_cast<int>(uri.size()) &&
+        absl::SimpleHexAtoi(uri.substr(i + 1, 2), &value)) {
+      filename += static_cast<char>(value);
+      i += 2;
+    } else {
+      filename += uri[i];
+    }
+  }
+  return filename;
+}
+
+// Returns the length of UTF-8 <text> in UTF-16 code units.
+int Utf16Length(absl::string_view text) {
+  int length = 0;
+  for (char c : text) {
+    unsigned char byte = c;
+    if ((byte & 0xC0) != 0x80) length += byte >= 0xF0 ? 2 : 1;
+  }
+  return length;
+}
+
+}  // namespace
+
+bool ReadLspMessage(std::istream &input, std::string *body) {
+  int64_t length = -1;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty()) {
+      // Headers end with an empty line.
+      if (length < 0) continue;
+      body->resize(length);
+      input.read(body->data(), length);
+      return input.gcount() == length;
+    }
+    if (absl::StartsWithIgnoreCase(line, kContentLength) &&
+        !absl::SimpleAtoi(
+            absl::StripAsciiWhitespace(
+                absl::string_view(line).substr(kContentLength.size())),
+            &length))
+      length = -1;
+  }
+  return false;
+}
+
+void WriteLspMessage(absl::string_view body, std::ostream &output) {
+  output << kContentLength << " " << body.size() << "\r\n\r\n" << body;
+  output.flush();
+}
+
+LspServer::LspServer(std::istream &input, std::ostream &output,
+                     const Config &config, absl::string_view config_name,
+                     absl::Duration debounce)
+    : input_(input),
+      output_(output),
+      debounce_(debounce),
+      resolver_(config, config_name) {}
+
+int LspServer::Run() {
+  std::thread linter([this]() { LintLoop(); });
+  int exit_code = 1;
+  std::string body;
+  while (ReadLspMessage(input_, &body)) {
+    JsonValue message;
+    if (!ParseJson(body, &message).ok() || !message.IsObject()) {
+      Send(ErrorResponse(JsonValue(), kParseError, "Invalid message."));
+      continue;
+    }
+    if (Member(message, "method").String() == "exit") {
+      exit_code = shutdown_requested_ ? 0 : 1;
+      break;
+    }
+    HandleMessage(message);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    changed_.clear();
+    stopping_ = true;
+  }
+  linter.join();
+  return exit_code;
+}
+
+void LspServer::HandleMessage(const JsonValue &message) {
+  const JsonValue &method = Member(message, "method");
+  const JsonValue &params = Member(message, "params");
+  const JsonValue &id = Member(message, "id");
+  std::string name = method.String();
+
+  if (name == "initialize") {
+    // Change notifications send only the edited ranges.
+    Send(Response(id,
+                  "{\"capabilities\": {\"textDocumentSync\": "
+                  "{\"openClose\": true, \"change\": 2}}, "
+                  "\"serverInfo\": {\"name\": \"zetasql-lint\"}}"));
+  } else if (name == "shutdown") {
+    absl::MutexLock lock(&mutex_);
+    flushing_ = true;
+    auto idle = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+      return changed_.empty() && !linting_;
+    };
+    mutex_.Await(absl::Condition(&idle));
+    shutdown_requested_ = true;
+    Send(Response(id, "null"));
+  } else if (name == "textDocument/didOpen") {
+    OpenDocument(params);
+  } else if (name == "textDocument/didChange") {
+    ChangeDocument(params);
+  } else if (name == "textDocument/didClose") {
+    CloseDocument(params);
+  } else if (message.Find("id") != nullptr && method.IsString()) {
+    Send(ErrorResponse(id, kMethodNotFound,
+                       absl::StrCat("Unsupported method: ", name)));
+  }
+  // Other notifications and responses to our messages are ignored.
+}
+
+void LspServer::OpenDocument(const JsonValue &params) {
+  const JsonValue &document = Member(params, "textDocument");
+  absl::MutexLock lock(&mutex_);
+  std::string uri = Member(document, "uri").String();
+  Document &open = documents_[uri];
+  open.text = Rope(Member(document, "text").String());
+  open.version = IntMember(document, "version");
+  open.generation = ++generation_;
+  changed_.insert(uri);
+  last_edit_ = absl::Now();
+}
+
+void LspServer::ChangeDocument(const JsonValue &params) {
+  const JsonValue &document = Member(params, "textDocument");
+  absl::MutexLock lock(&mutex_);
+  std::string uri = Member(document, "uri").String();
+  auto it = documents_.find(uri);
+  if (it == documents_.end()) return;
+  Document &changed = it->second;
+  for (const JsonValue &change :
+       Member(params, "contentChanges").Elements()) {
+    const JsonValue &range = Member(change, "range");
+    std::string text = Member(change, "text").String();
+    if (!range.IsObject()) {
+      changed.text = Rope(text);
+      continue;
+    }
+    const JsonValue &start = Member(range, "start");
+    const JsonValue &end = Member(range, "end");
+    changed.text.Replace(
+        changed.text.Offset(IntMember(start, "line"),
+                            IntMember(start, "character")),
+        changed.text.Offset(IntMember(end, "line"),
+                            IntMember(end, "character")),
+        text);
+  }
+  changed.version = IntMember(document, "version");
+  changed.generation = ++generation_;
+  changed_.insert(uri);
+  last_edit_ = absl::Now();
+}
+
+void LspServer::CloseDocument(const JsonValue &params) {
+  std::string uri = Member(Member(params, "textDocument"), "uri").String();
+  {
+    absl::MutexLock lock(&mutex_);
+    documents_.erase(uri);
+    changed_.erase(uri);
+  }
+  // Diagnostics of closed documents are cleared.
+  Send(PublishDiagnostics(uri, -1, "[]"));
+}
+
+void LspServer::LintLoop() {
+  mutex_.Lock();
+  while (true) {
+    auto has_work = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+      return stopping_ || !changed_.empty();
+    };
+    mutex_.Await(absl::Condition(&has_work));
+    if (stopping_) break;
+
+    // Waits until edits pause, so a burst of keystrokes is linted once.
+    while (!flushing_ && !stopping_ && absl::Now() < last_edit_ + debounce_) {
+      auto interrupted = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return flushing_ || stopping_;
+      };
+      mutex_.AwaitWithDeadline(absl::Condition(&interrupted),
+                               last_edit_ + debounce_);
+    }
+    if (stopping_ || changed_.empty()) continue;
+
+    std::string uri = *changed_.begin();
+    changed_.erase(changed_.begin());
+    auto it = documents_.find(uri);
+    if (it == documents_.end()) continue;
+    std::string text = it->second.text.ToString();
+    int64_t version = it->second.version;
+    int64_t generation = it->second.generation;
+    linting_ = true;
+    mutex_.Unlock();
+
+    std::string diagnostics = Diagnostics(uri, text);
+
+    mutex_.Lock();
+    linting_ = false;
+    // A document edited during the run is changed again, and its stale
+    // diagnostics are dropped.
+    it = documents_.find(uri);
+    if (it != documents_.end() && it->second.generation == generation)
+      Send(PublishDiagnostics(uri, version, diagnostics));
+  }
+  mutex_.Unlock();
+}
+
+std::string LspServer::Diagnostics(absl::string_view uri,
+                                   absl::string_view text) {
+  std::string filename = FilenameFromUri(uri);
+  std::shared_ptr<const ResolvedConfig> config = resolver_.Resolve(filename);
+  LinterResult result =
+      cache_.RunChecks(text, config->options, config->fingerprint, filename);
+  result.Sort();
+
+  std::vector<int> line_starts = {0};
+  for (int i = 0; i < static_cast<int>(text.size()); ++i)
+    if (text[i] == '\n') line_starts.push_back(i + 1);
+
+  std::string out = "[";
+  for (LintError &error : result.GetErrors()) {
+    // Columns of findings count tabs as many characters, positions are
+    // computed from offsets when findings have them.
+    int line, character;
+    int offset = error.GetOffset();
+    if (offset >= 0 && offset <= static_cast<int>(text.size())) {
+      line = std::upper_bound(line_starts.begin(), line_starts.end(), offset) -
+             line_starts.begin() - 1;
+      character = Utf16Length(
+          text.substr(line_starts[line], offset - line_starts[line]));
+    } else {
+      auto [error_line, error_column] = error.GetPosition();
+      line = std::max(error_line - 1, 0);
+      character = std::max(error_column - 1, 0);
+    }
+    if (out.size() > 1) out += ", ";
+    absl::StrAppend(&out, "{\"range\": {\"start\": {\"line\": ", line,
+                    ", \"character\": ", character, "}, \"end\": {\"line\": ",
+                    line, ", \"character\": ", character,
+                    "}}, \"severity\": ",
+                    error.GetType() == ErrorCode::kStatus ? kSeverityError
+                                                          : kSeverityWarning,
+                    ", \"source\": \"zetasql-lint\", \"code\": ");
+    AppendJsonString(error.ErrorCodeToString(), &out);
+    out += ", \"message\": ";
+    AppendJsonString(error.GetErrorMessage(), &out);
+    out += "}";
+  }
+  out += "]";
+  return out;
+}
+
+void LspServer::Send(absl::string_view body) {
+  absl::MutexLock lock(&output_mutex_);
+  WriteLspMessage(body, output_);
+}
+
+}  // namespace zetasql::linter
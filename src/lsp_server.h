@@ -0,0 +1,126 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_LSP_SERVER_H_
+#define SRC_LSP_SERVER_H_
+
+// A Language Server Protocol frontend, publishing lint findings of open
+// documents as diagnostics while they are edited.
+//
+// Messages are JSON-RPC over the given streams, usually standard input and
+// output, each with a 'Content-Length' header. Documents are synced
+// incrementally: edits are applied to a 'Rope', and each lint run goes
+// through a 'StatementCache', so only the statements touched by edits since
+// the last run are parsed and checked again.
+//
+// Lint runs happen on a background thread. A run starts when a document
+// wasn't edited for the debounce delay, and its diagnostics are dropped if
+// the document was edited while it ran; a new run follows for the latest
+// version. 'shutdown' is answered after all pending runs are published.
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/json_util.h"
+#include "src/rope.h"
+#include "src/statement_cache.h"
+
+namespace zetasql::linter {
+
+// Reads the body of a message into <body>. Returns false at the end of
+// <input>.
+bool ReadLspMessage(std::istream &input, std::string *body);
+
+// Writes <body> as a message.
+void WriteLspMessage(absl::string_view body, std::ostream &output);
+
+class LspServer {
+ public:
+  // Files get their configuration from a 'ConfigResolver' of <config> and
+  // <config_name>.
+  LspServer(std::istream &input, std::ostream &output, const Config &config,
+            absl::string_view config_name, absl::Duration debounce);
+
+  LspServer(const LspServer &) = delete;
+  LspServer &operator=(const LspServer &) = delete;
+
+  // Serves messages until an 'exit' notification or the end of input.
+  // Returns the exit code: 0 if 'shutdown' was requested before, else 1.
+  int Run();
+
+  // Returns the number of parts of documents that were linted, and the number
+  // reused from earlier runs, see 'StatementCache'.
+  int64_t LintedParts() const { return cache_.Misses(); }
+  int64_t ReusedParts() const { return cache_.Hits(); }
+
+ private:
+  struct Document {
+    Rope text;
+    int64_t version = 0;
+    // Changes with every edit, across all documents.
+    int64_t generation = 0;
+  };
+
+  void HandleMessage(const JsonValue &message);
+  void OpenDocument(const JsonValue &params);
+  void ChangeDocument(const JsonValue &params);
+  void CloseDocument(const JsonValue &params);
+
+  // Lints changed documents until 'stopping_' is set.
+  void LintLoop();
+
+  // Lints a snapshot of a document and returns its diagnostics.
+  std::string Diagnostics(absl::string_view uri, absl::string_view text);
+
+  // Writes a message to the output.
+  void Send(absl::string_view body);
+
+  std::istream &input_;
+  std::ostream &output_;
+  const absl::Duration debounce_;
+  ConfigResolver resolver_;
+  StatementCache cache_;
+  bool shutdown_requested_ = false;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Document> documents_
+      ABSL_GUARDED_BY(mutex_);
+  // Documents with edits that are not linted yet.
+  absl::btree_set<std::string> changed_ ABSL_GUARDED_BY(mutex_);
+  absl::Time last_edit_ ABSL_GUARDED_BY(mutex_);
+  int64_t generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Set while a document is linted outside of the lock.
+  bool linting_ ABSL_GUARDED_BY(mutex_) = false;
+  // Set by 'shutdown', changed documents are linted without the delay.
+  bool flushing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+
+  absl::Mutex output_mutex_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_LSP_SERVER_H_
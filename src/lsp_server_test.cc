@@ -0,0 +1,221 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/lsp_server.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/json_util.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+std::string Message(absl::string_view body) {
+  std::ostringstream out;
+  WriteLspMessage(body, out);
+  return out.str();
+}
+
+// Runs a server on <input> and returns its output messages. Sets
+// <linted_parts> to the number of parts the server linted, if it isn't null.
+std::vector<std::string> RunServer(const std::string &input, int *exit_code,
+                                   int64_t *linted_parts = nullptr) {
+  std::istringstream in(input);
+  std::ostringstream out;
+  // The delay is longer than the test, so only the last version of a
+  // document is linted, when 'shutdown' flushes pending runs.
+  LspServer server(in, out, Config(), "", absl::Seconds(60));
+  *exit_code = server.Run();
+  if (linted_parts != nullptr) *linted_parts = server.LintedParts();
+
+  std::istringstream output(out.str());
+  std::vector<std::string> messages;
+  std::string body;
+  while (ReadLspMessage(output, &body)) messages.push_back(body);
+  return messages;
+}
+
+TEST(LspServerTest, ReadAndWriteMessages) {
+  std::istringstream in(Message("{\"a\": 1}") +
+                        "content-length: 2\r\nOther: x\r\n\r\n{}" +
+                        "Content-Length: 10\r\n\r\n{}");
+  std::string body;
+  ASSERT_TRUE(ReadLspMessage(in, &body));
+  EXPECT_EQ(body, "{\"a\": 1}");
+  ASSERT_TRUE(ReadLspMessage(in, &body));
+  EXPECT_EQ(body, "{}");
+  // The last message is truncated.
+  EXPECT_FALSE(ReadLspMessage(in, &body));
+}
+
+TEST(LspServerTest, IncrementalEdits) {
+  std::string input =
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"initialize\", "
+          "\"params\": {}}") +
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didOpen\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/a.sql\", "
+          "\"version\": 1, \"text\": "
+          "\"SELECT 1;\\nSELECT a b FROM T;\\n\"}}}") +
+      // Replaces 'a b' with 'a AS b'.
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didChange\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/a.sql\", "
+          "\"version\": 2}, \"contentChanges\": [{\"range\": {\"start\": "
+          "{\"line\": 1, \"character\": 8}, \"end\": {\"line\": 1, "
+          "\"character\": 9}}, \"text\": \" AS\"}]}}") +
+      Message("{\"jsonrpc\": \"2.0\", \"id\": 2, \"method\": \"shutdown\"}") +
+      Message("{\"jsonrpc\": \"2.0\", \"method\": \"exit\"}");
+  int exit_code = -1;
+  std::vector<std::string> messages = RunServer(input, &exit_code);
+  EXPECT_EQ(exit_code, 0);
+  ASSERT_EQ(messages.size(), 3);
+
+  JsonValue initialize;
+  ASSERT_TRUE(ParseJson(messages[0], &initialize).ok());
+  EXPECT_EQ(initialize.Find("id")->Number(), 1);
+  EXPECT_NE(initialize.Find("result")->Find("capabilities"), nullptr);
+
+  JsonValue publish;
+  ASSERT_TRUE(ParseJson(messages[1], &publish).ok());
+  EXPECT_EQ(publish.Find("method")->String(),
+            "textDocument/publishDiagnostics");
+  const JsonValue *params = publish.Find("params");
+  EXPECT_EQ(params->Find("version")->Number(), 2);
+  for (const JsonValue &diagnostic : params->Find("diagnostics")->Elements())
+    EXPECT_NE(diagnostic.Find("code")->String(), "alias");
+
+  JsonValue shutdown;
+  ASSERT_TRUE(ParseJson(messages[2], &shutdown).ok());
+  EXPECT_EQ(shutdown.Find("id")->Number(), 2);
+  EXPECT_TRUE(shutdown.Find("result")->IsNull());
+}
+
+TEST(LspServerTest, Diagnostics) {
+  std::string input =
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didOpen\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/b.sql\", "
+          "\"version\": 3, \"text\": "
+          "\"SELECT 1;\\nSELECT a b FROM T;\\n\"}}}") +
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"id\": \"s\", \"method\": \"shutdown\"}");
+  int exit_code = -1;
+  std::vector<std::string> messages = RunServer(input, &exit_code);
+  // The input ends without 'exit'.
+  EXPECT_EQ(exit_code, 1);
+  ASSERT_EQ(messages.size(), 2);
+
+  JsonValue publish;
+  ASSERT_TRUE(ParseJson(messages[0], &publish).ok());
+  const JsonValue *params = publish.Find("params");
+  EXPECT_EQ(params->Find("uri")->String(), "file:///tmp/b.sql");
+  EXPECT_EQ(params->Find("version")->Number(), 3);
+  bool found = false;
+  for (const JsonValue &diagnostic : params->Find("diagnostics")->Elements()) {
+    if (diagnostic.Find("code")->String() != "alias") continue;
+    found = true;
+    const JsonValue *start = diagnostic.Find("range")->Find("start");
+    EXPECT_EQ(start->Find("line")->Number(), 1);
+    EXPECT_EQ(start->Find("character")->Number(), 9);
+  }
+  EXPECT_TRUE(found);
+
+  JsonValue shutdown;
+  ASSERT_TRUE(ParseJson(messages[1], &shutdown).ok());
+  EXPECT_EQ(shutdown.Find("id")->String(), "s");
+}
+
+TEST(LspServerTest, UnparsedStatement) {
+  // The second document is the first one with a statement being typed.
+  std::string input =
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didOpen\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/d.sql\", "
+          "\"version\": 1, \"text\": "
+          "\"SELECT a b FROM T;\\nSELECT 1;\\nSELECT 2;\\nSELECT 3;\\n\"}}}") +
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didOpen\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/e.sql\", "
+          "\"version\": 1, \"text\": "
+          "\"SELECT a b FROM T;\\nSELECT 1;\\nSELECT 2 FROM;\\n"
+          "SELECT 3;\\n\"}}}") +
+      Message("{\"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"shutdown\"}") +
+      Message("{\"jsonrpc\": \"2.0\", \"method\": \"exit\"}");
+  int exit_code = -1;
+  int64_t linted_parts = 0;
+  std::vector<std::string> messages =
+      RunServer(input, &exit_code, &linted_parts);
+  ASSERT_EQ(messages.size(), 3);
+  // Documents are linted in the order of their uris, and only the statement
+  // that can't be parsed is linted again for the second one.
+  EXPECT_EQ(linted_parts, 5);
+
+  JsonValue publish;
+  ASSERT_TRUE(ParseJson(messages[1], &publish).ok());
+  const JsonValue *params = publish.Find("params");
+  EXPECT_EQ(params->Find("uri")->String(), "file:///tmp/e.sql");
+  bool parse_failed = false, alias = false;
+  for (const JsonValue &diagnostic : params->Find("diagnostics")->Elements()) {
+    const int line =
+        diagnostic.Find("range")->Find("start")->Find("line")->Number();
+    const std::string code = diagnostic.Find("code")->String();
+    if (code == "parser-failed") parse_failed = line == 2;
+    if (code == "alias") alias = line == 0;
+  }
+  EXPECT_TRUE(parse_failed);
+  EXPECT_TRUE(alias);
+}
+
+TEST(LspServerTest, UnsupportedMessages) {
+  std::string input =
+      Message("{\"jsonrpc\": \"2.0\", \"id\": 7, \"method\": \"hover\"}") +
+      Message("{\"jsonrpc\": \"2.0\", \"method\": \"$/unknown\"}") +
+      Message("not json") +
+      Message(
+          "{\"jsonrpc\": \"2.0\", \"method\": \"textDocument/didClose\", "
+          "\"params\": {\"textDocument\": {\"uri\": \"file:///tmp/c.sql\"}}}") +
+      Message("{\"jsonrpc\": \"2.0\", \"method\": \"exit\"}");
+  int exit_code = -1;
+  std::vector<std::string> messages = RunServer(input, &exit_code);
+  EXPECT_EQ(exit_code, 1);
+  ASSERT_EQ(messages.size(), 3);
+
+  JsonValue error;
+  ASSERT_TRUE(ParseJson(messages[0], &error).ok());
+  EXPECT_EQ(error.Find("id")->Number(), 7);
+  EXPECT_EQ(error.Find("error")->Find("code")->Number(), -32601);
+  ASSERT_TRUE(ParseJson(messages[1], &error).ok());
+  EXPECT_EQ(error.Find("error")->Find("code")->Number(), -32700);
+
+  // Closing a document clears its diagnostics.
+  JsonValue publish;
+  ASSERT_TRUE(ParseJson(messages[2], &publish).ok());
+  EXPECT_TRUE(
+      publish.Find("params")->Find("diagnostics")->Elements().empty());
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
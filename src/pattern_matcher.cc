@@ -0,0 +1,102 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/pattern_matcher.h"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+PatternMatcher::PatternMatcher(const std::vector<std::string> &patterns) {
+  // Builds the trie of lowercase patterns, -1 is a missing edge.
+  std::vector<std::vector<int32_t>> trie(1, std::vector<int32_t>(256, -1));
+  matches_.emplace_back();
+  for (int p = 0; p < static_cast<int>(patterns.size()); ++p) {
+    int state = kStart;
+    for (char c : patterns[p]) {
+      const unsigned char lower = absl::ascii_tolower(c);
+      if (trie[state][lower] < 0) {
+        trie[state][lower] = trie.size();
+        trie.emplace_back(256, -1);
+        matches_.emplace_back();
+      }
+      state = trie[state][lower];
+    }
+    matches_[state].push_back(p);
+    pattern_sizes_.push_back(patterns[p].size());
+  }
+
+  // Fills missing edges with the edges of the failure state, in breadth
+  // first order so that failure states are complete when they are used.
+  std::vector<int32_t> failure(trie.size(), kStart);
+  std::queue<int> queue;
+  for (int c = 0; c < 256; ++c) {
+    if (trie[kStart][c] < 0) {
+      trie[kStart][c] = kStart;
+    } else {
+      queue.push(trie[kStart][c]);
+    }
+  }
+  while (!queue.empty()) {
+    const int state = queue.front();
+    queue.pop();
+    // Patterns ending at the failure state end here too.
+    for (int p : matches_[failure[state]]) matches_[state].push_back(p);
+    for (int c = 0; c < 256; ++c) {
+      const int next = trie[state][c];
+      if (next < 0) {
+        trie[state][c] = trie[failure[state]][c];
+      } else {
+        failure[next] = trie[failure[state]][c];
+        queue.push(next);
+      }
+    }
+  }
+
+  // Uppercase bytes follow the edges of their lowercase versions.
+  transitions_.resize(trie.size() * 256);
+  for (int state = 0; state < static_cast<int>(trie.size()); ++state) {
+    for (int c = 0; c < 256; ++c) {
+      transitions_[state * 256 + c] =
+          trie[state][static_cast<unsigned char>(absl::ascii_tolower(c))];
+    }
+  }
+}
+
+void PatternMatcher::Scan(
+    absl::string_view text,
+    const std::function<void(int pattern, int start)> &on_match) const {
+  int state = kStart;
+  for (int i = 0; i < static_cast<int>(text.size()); ++i) {
+    state = Next(state, text[i]);
+    for (int p : matches_[state]) on_match(p, i + 1 - pattern_sizes_[p]);
+  }
+}
+
+const std::vector<std::string> &TextPatternStrings() {
+  static const std::vector<std::string> *strings =
+      new std::vector<std::string>{"COUNT", "IMPORT"};
+  return *strings;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,83 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_PATTERN_MATCHER_H_
+#define SRC_PATTERN_MATCHER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Finds occurrences of several patterns in a single pass over a text, with an
+// Aho-Corasick automaton. Matching is ASCII case-insensitive. Each byte costs
+// one table lookup, independent of the number of patterns.
+class PatternMatcher {
+ public:
+  // State before any byte is read.
+  static constexpr int kStart = 0;
+
+  // Builds the automaton. A pattern is identified by its index in
+  // <patterns>.
+  explicit PatternMatcher(const std::vector<std::string> &patterns);
+
+  // Returns the state after reading <c> in <state>.
+  int Next(int state, char c) const {
+    return transitions_[state * 256 + static_cast<unsigned char>(c)];
+  }
+
+  // Returns the patterns that end with the byte leading to <state>.
+  const std::vector<int> &Matches(int state) const { return matches_[state]; }
+
+  // Returns the size of a pattern.
+  int PatternSize(int pattern) const { return pattern_sizes_[pattern]; }
+
+  // Calls <on_match> with the pattern and the start position of every
+  // occurrence in <text>, in order of their end positions.
+  void Scan(absl::string_view text,
+            const std::function<void(int pattern, int start)> &on_match) const;
+
+ private:
+  std::vector<int32_t> transitions_;
+  std::vector<std::vector<int>> matches_;
+  std::vector<int> pattern_sizes_;
+};
+
+// Patterns that textual checks search in code, outside of strings and
+// comments. All of them are found in one pass by 'FindTextPatterns'. A new
+// pattern is added here and in 'TextPatternStrings'.
+enum class TextPattern : int {
+  kCount = 0,
+  kImport,
+};
+
+// Returns the strings of 'TextPattern' values, in the order of the values.
+const std::vector<std::string> &TextPatternStrings();
+
+// An occurrence of a 'TextPattern', <position> is its start.
+struct TextMatch {
+  TextPattern pattern;
+  int position;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_PATTERN_MATCHER_H_
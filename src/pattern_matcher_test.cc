@@ -0,0 +1,66 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/pattern_matcher.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns <pattern, start> pairs of all matches in <text>.
+std::vector<std::pair<int, int>> Matches(const PatternMatcher &matcher,
+                                         absl::string_view text) {
+  std::vector<std::pair<int, int>> matches;
+  matcher.Scan(text, [&matches](int pattern, int start) {
+    matches.push_back({pattern, start});
+  });
+  return matches;
+}
+
+TEST(PatternMatcherTest, CaseInsensitive) {
+  PatternMatcher matcher({"COUNT", "IMPORT"});
+  EXPECT_EQ(Matches(matcher, "SELECT count(1), Count(*);\nimport x;"),
+            (std::vector<std::pair<int, int>>{{0, 7}, {0, 17}, {1, 27}}));
+  EXPECT_TRUE(Matches(matcher, "SELECT COUN T;").empty());
+}
+
+TEST(PatternMatcherTest, OverlappingPatterns) {
+  PatternMatcher matcher({"he", "she", "his", "hers"});
+  EXPECT_EQ(Matches(matcher, "ushers"),
+            (std::vector<std::pair<int, int>>{{1, 1}, {0, 2}, {3, 2}}));
+  EXPECT_EQ(Matches(matcher, "hishe"),
+            (std::vector<std::pair<int, int>>{{2, 0}, {1, 2}, {0, 3}}));
+}
+
+TEST(PatternMatcherTest, TextPatternStrings) {
+  PatternMatcher matcher(TextPatternStrings());
+  std::vector<std::pair<int, int>> matches =
+      Matches(matcher, "IMPORT MODULE a; SELECT COUNT(1);");
+  ASSERT_EQ(matches.size(), 2);
+  EXPECT_EQ(static_cast<TextPattern>(matches[0].first), TextPattern::kImport);
+  EXPECT_EQ(static_cast<TextPattern>(matches[1].first), TextPattern::kCount);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
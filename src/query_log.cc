@@ -0,0 +1,201 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/query_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/fingerprint_cache.h"
+#include "src/json_util.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+#include "src/linter_options.h"
+#include "src/thread_pool.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Records are handed to workers in chunks of up to this size, so scheduling
+// cost is shared by many small records.
+constexpr int kChunkSize = 1 << 20;
+
+// Appends a string member of the record to the result, or null if the
+// record doesn't have it.
+void AppendStringMember(const JsonValue &record, absl::string_view key,
+                        std::string *output) {
+  const JsonValue *value = record.Find(key);
+  AppendJsonString(key, output);
+  *output += ": ";
+  if (value == nullptr || !value->IsString()) {
+    *output += "null";
+  } else if (value->HasEscapes()) {
+    AppendJsonString(value->String(), output);
+  } else {
+    AppendJsonString(value->RawString(), output);
+  }
+}
+
+// Lints a record, with <cache> if it isn't null.
+absl::Status LintRecord(absl::string_view record, const LinterOptions &options,
+                        FingerprintCache *cache, uint64_t config_fingerprint,
+                        std::string *output) {
+  JsonValue value;
+  absl::Status status = ParseJson(record, &value);
+  if (!status.ok()) return status;
+  const JsonValue *query = value.IsObject() ? value.Find("query") : nullptr;
+  if (query == nullptr || !query->IsString())
+    return absl::InvalidArgumentError("Record doesn't have a 'query' string.");
+
+  // Same with 'ReadFile', the query ends with a newline, so checks like
+  // 'CheckLineLength' see its last line.
+  std::string sql = query->HasEscapes() ? query->String()
+                                        : std::string(query->RawString());
+  if (sql.empty() || sql.back() != '\n') sql += '\n';
+  LinterResult result =
+      cache == nullptr ? RunChecks(sql, options, "")
+                       : cache->RunChecks(sql, options, config_fingerprint);
+  result.Sort();
+
+  *output += "{";
+  AppendStringMember(value, "job_id", output);
+  *output += ", ";
+  AppendStringMember(value, "user", output);
+  *output += ", \"findings\": [";
+  bool first = true;
+  for (LintError &error : result.GetErrors()) {
+    if (!first) *output += ", ";
+    first = false;
+    auto [line, column] = error.GetPosition();
+    *output += "{\"check\": ";
+    AppendJsonString(error.ErrorCodeToString(), output);
+    absl::StrAppend(output, ", \"line\": ", line, ", \"column\": ", column,
+                    ", \"message\": ");
+    AppendJsonString(error.GetErrorMessage(), output);
+    *output += "}";
+  }
+  *output += "]}\n";
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status LintQueryLogRecord(absl::string_view record, const Config &config,
+                                std::string *output) {
+  LinterOptions options;
+  GetOptionsFromConfig(config, &options);
+  return LintRecord(record, options, nullptr, 0, output);
+}
+
+int LintQueryLog(std::istream &input, std::ostream &output,
+                 const Config &config, int num_threads, int cache_size) {
+  std::unique_ptr<FingerprintCache> cache;
+  if (cache_size > 0) cache = std::make_unique<FingerprintCache>(cache_size);
+  // Options are computed once, and copied for each query.
+  const ResolvedConfig resolved(std::make_shared<const Config>(config));
+  absl::Mutex output_mutex;
+  std::atomic<int> linted(0);
+
+  auto lint_chunk = [&](const std::string &chunk) {
+    std::string results;
+    int start = 0;
+    while (start < static_cast<int>(chunk.size())) {
+      size_t end = chunk.find('\n', start);
+      if (end == std::string::npos) end = chunk.size();
+      absl::string_view record(chunk.data() + start, end - start);
+      start = end + 1;
+      if (absl::StripAsciiWhitespace(record).empty()) continue;
+
+      absl::Status status = LintRecord(record, resolved.options, cache.get(),
+                                       resolved.fingerprint, &results);
+      if (status.ok()) {
+        ++linted;
+      } else {
+        absl::MutexLock lock(&output_mutex);
+        std::cerr << "Skipping query log record: " << status.message()
+                  << std::endl;
+      }
+    }
+    absl::MutexLock lock(&output_mutex);
+    output << results;
+    output.flush();
+  };
+
+  {
+    // At most two chunks per worker are waiting, which bounds the memory
+    // when reading is faster than linting.
+    ThreadPool pool(num_threads, 2 * num_threads);
+    // Input is read in blocks straight into chunks, and records are split
+    // in place. The partial last record of a chunk is carried over to the
+    // next one.
+    std::streambuf *buffer = input.rdbuf();
+    auto chunk = std::make_shared<std::string>();
+    chunk->reserve(kChunkSize);
+    // The end of complete records in the chunk.
+    size_t records_end = 0;
+    while (buffer->sgetc() != std::istream::traits_type::eof()) {
+      // Waits for input only when nothing is buffered, and takes everything
+      // that is buffered.
+      std::streamsize count = std::max<std::streamsize>(buffer->in_avail(), 1);
+      count = std::min<std::streamsize>(count, kChunkSize);
+      const size_t size = chunk->size();
+      chunk->resize(size + count);
+      chunk->resize(size + buffer->sgetn(&(*chunk)[size], count));
+      // Only the new part is searched, records can be longer than a block.
+      const size_t newline = absl::string_view(*chunk).substr(size).rfind('\n');
+      if (newline != absl::string_view::npos) records_end = size + newline + 1;
+      // A chunk is also scheduled when no more input is buffered, so records
+      // of a live stream are linted as they come instead of when a whole
+      // chunk arrives.
+      if ((static_cast<int>(chunk->size()) < kChunkSize &&
+           buffer->in_avail() > 0) ||
+          records_end == 0)
+        continue;
+      auto next = std::make_shared<std::string>();
+      next->reserve(kChunkSize);
+      next->append(*chunk, records_end, std::string::npos);
+      chunk->resize(records_end);
+      records_end = 0;
+      pool.Schedule([chunk, &lint_chunk]() { lint_chunk(*chunk); });
+      chunk = std::move(next);
+    }
+    if (!chunk->empty())
+      pool.Schedule([chunk, &lint_chunk]() { lint_chunk(*chunk); });
+  }
+  if (cache != nullptr) {
+    std::cerr << cache->Hits() << " of " << cache->Hits() + cache->Misses()
+              << " queries were found in the fingerprint cache" << std::endl;
+  }
+  return linted;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,59 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_QUERY_LOG_H_
+#define SRC_QUERY_LOG_H_
+
+// Linting of query logs. A query log is a stream of newline delimited JSON
+// records, each of them is an independent query:
+//
+//    {"query": "SELECT 1;", "user": "someone", "job_id": "job_1"}
+//
+// For each record, a result record is written as a single line:
+//
+//    {"job_id": "job_1", "user": "someone", "findings": [{"check": "alias",
+//     "line": 1, "column": 10, "message": "..."}]}
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "src/config.pb.h"
+
+namespace zetasql::linter {
+
+// Lints a single query log record and appends its result record,
+// ending with a newline, to <output>.
+absl::Status LintQueryLogRecord(absl::string_view record, const Config &config,
+                                std::string *output);
+
+// Lints all records in <input> on <num_threads> workers and writes result
+// records to <output>. Results can be written in a different order than the
+// records, they should be matched with 'job_id'. Malformed records are
+// reported to standard error and skipped. Returns the number of linted
+// records. Records are scheduled as soon as they are read, so <input> can be
+// a live stream, e.g. a pipe.
+//
+// If <cache_size> is positive, results are cached for at most that many
+// query templates, see 'FingerprintCache'.
+int LintQueryLog(std::istream &input, std::ostream &output,
+                 const Config &config, int num_threads, int cache_size = 0);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_QUERY_LOG_H_
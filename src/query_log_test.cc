@@ -0,0 +1,133 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/query_log.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(QueryLogTest, LastLineOfQuery) {
+  Config config;
+  config.set_line_limit(20);
+  std::string output;
+  ASSERT_TRUE(LintQueryLogRecord(
+                  "{\"query\": \"SELECT a FROM Table1 AS t WHERE t.a > 1;\", "
+                  "\"job_id\": \"job_1\"}",
+                  config, &output)
+                  .ok());
+  EXPECT_TRUE(absl::StrContains(output, "line-limit-exceed")) << output;
+
+  output.clear();
+  ASSERT_TRUE(LintQueryLogRecord(
+                  "{\"query\": \"SELECT a\\nFROM Table1 AS t WHERE t.a > 1;\", "
+                  "\"job_id\": \"job_2\"}",
+                  config, &output)
+                  .ok());
+  EXPECT_TRUE(absl::StrContains(output, "\"line\": 2")) << output;
+}
+
+// Input that returns its first part, then waits until the results of the
+// first part are written before it returns the rest, like a live pipe.
+class LiveInput : public std::streambuf {
+ public:
+  LiveInput(std::string first, std::string rest, absl::Notification *written)
+      : parts_({std::move(first), std::move(rest)}), written_(written) {}
+
+  bool waited_ok() const { return waited_ok_; }
+
+ protected:
+  int_type underflow() override {
+    if (next_ == static_cast<int>(parts_.size())) return traits_type::eof();
+    if (next_ == 1)
+      waited_ok_ = written_->WaitForNotificationWithTimeout(absl::Seconds(30));
+    std::string &part = parts_[next_++];
+    setg(&part[0], &part[0], &part[0] + part.size());
+    return traits_type::to_int_type(part[0]);
+  }
+
+ private:
+  std::vector<std::string> parts_;
+  int next_ = 0;
+  absl::Notification *written_;
+  bool waited_ok_ = false;
+};
+
+// Output that notifies when something is written.
+class NotifyingOutput : public std::stringbuf {
+ public:
+  explicit NotifyingOutput(absl::Notification *written) : written_(written) {}
+
+ protected:
+  int sync() override {
+    if (!str().empty() && !written_->HasBeenNotified()) written_->Notify();
+    return 0;
+  }
+
+ private:
+  absl::Notification *written_;
+};
+
+TEST(QueryLogTest, LiveStream) {
+  absl::Notification written;
+  LiveInput input_buffer("{\"query\": \"SELECT 1;\", \"job_id\": \"job_1\"}\n",
+                         "{\"query\": \"SELECT 2;\", \"job_id\": \"job_2\"}\n",
+                         &written);
+  NotifyingOutput output_buffer(&written);
+  std::istream input(&input_buffer);
+  std::ostream output(&output_buffer);
+
+  EXPECT_EQ(LintQueryLog(input, output, Config(), 2), 2);
+  // The first record was linted before the second one arrived.
+  EXPECT_TRUE(input_buffer.waited_ok());
+  EXPECT_TRUE(absl::StrContains(output_buffer.str(), "job_2"));
+}
+
+TEST(QueryLogTest, RecordsAcrossChunks) {
+  // Records are longer than blocks of the stream, and chunks end inside of
+  // them.
+  std::string log;
+  for (int i = 0; i < 3000; ++i) {
+    absl::StrAppend(&log, "{\"query\": \"SELECT ", std::string(500, '1'),
+                    ";\", \"job_id\": \"job_", i, "\"}\n");
+  }
+  std::istringstream input(log);
+  std::ostringstream output;
+  EXPECT_EQ(LintQueryLog(input, output, Config(), 2), 3000);
+  const std::string results = output.str();
+  EXPECT_EQ(std::count(results.begin(), results.end(), '\n'), 3000);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,134 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/rope.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Chunks are split at this size.
+constexpr size_t kChunkSize = 2048;
+
+// An edit that leaves a chunk smaller than this merges it with the next one,
+// so many small edits don't leave many tiny chunks.
+constexpr size_t kMinChunkSize = 512;
+
+}  // namespace
+
+Rope::Rope(absl::string_view text) : size_(text.size()) {
+  InsertChunks(0, text);
+}
+
+void Rope::InsertChunks(int position, absl::string_view text) {
+  std::vector<Chunk> chunks;
+  for (size_t start = 0; start < text.size(); start += kChunkSize) {
+    Chunk &chunk = chunks.emplace_back();
+    chunk.text = std::string(text.substr(start, kChunkSize));
+    chunk.newlines = std::count(chunk.text.begin(), chunk.text.end(), '\n');
+  }
+  chunks_.insert(chunks_.begin() + position,
+                 std::make_move_iterator(chunks.begin()),
+                 std::make_move_iterator(chunks.end()));
+}
+
+size_t Rope::Offset(int line, int character) const {
+  // Finds the chunk with the newline that ends the previous line.
+  int index = 0;
+  int lines_before = 0;
+  size_t chunk_start = 0;
+  while (index < static_cast<int>(chunks_.size()) &&
+         lines_before + chunks_[index].newlines < line) {
+    lines_before += chunks_[index].newlines;
+    chunk_start += chunks_[index].text.size();
+    ++index;
+  }
+  if (index == static_cast<int>(chunks_.size())) return size_;
+
+  size_t position = 0;
+  for (int i = lines_before; i < line; ++i)
+    position = chunks_[index].text.find('\n', position) + 1;
+
+  // Characters are counted in UTF-16 code units: code points after the
+  // basic multilingual plane, with a 4 byte UTF-8 encoding, are two units.
+  int remaining = character;
+  for (; index < static_cast<int>(chunks_.size()); ++index) {
+    const std::string &text = chunks_[index].text;
+    for (; position < text.size(); ++position) {
+      unsigned char c = text[position];
+      if (c == '\n') return chunk_start + position;
+      if ((c & 0xC0) == 0x80) continue;
+      int units = c >= 0xF0 ? 2 : 1;
+      if (remaining < units) return chunk_start + position;
+      remaining -= units;
+    }
+    chunk_start += text.size();
+    position = 0;
+  }
+  return size_;
+}
+
+void Rope::Replace(size_t start, size_t end, absl::string_view text) {
+  start = std::min(start, size_);
+  end = std::clamp(end, start, size_);
+  if (chunks_.empty()) {
+    InsertChunks(0, text);
+    size_ = text.size();
+    return;
+  }
+
+  // The chunks with <start> and <end>.
+  int first = 0;
+  size_t first_start = 0;
+  while (first + 1 < static_cast<int>(chunks_.size()) &&
+         first_start + chunks_[first].text.size() <= start) {
+    first_start += chunks_[first].text.size();
+    ++first;
+  }
+  int last = first;
+  size_t last_start = first_start;
+  while (last + 1 < static_cast<int>(chunks_.size()) &&
+         last_start + chunks_[last].text.size() < end) {
+    last_start += chunks_[last].text.size();
+    ++last;
+  }
+
+  std::string merged = chunks_[first].text.substr(0, start - first_start);
+  merged.append(text.data(), text.size());
+  merged += chunks_[last].text.substr(end - last_start);
+  if (merged.size() < kMinChunkSize &&
+      last + 1 < static_cast<int>(chunks_.size())) {
+    merged += chunks_[++last].text;
+  }
+  chunks_.erase(chunks_.begin() + first, chunks_.begin() + last + 1);
+  InsertChunks(first, merged);
+  size_ = size_ - (end - start) + text.size();
+}
+
+std::string Rope::ToString() const {
+  std::string text;
+  text.reserve(size_);
+  for (const Chunk &chunk : chunks_) text += chunk.text;
+  return text;
+}
+
+}  // namespace zetasql::linter
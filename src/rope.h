@@ -0,0 +1,72 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_ROPE_H_
+#define SRC_ROPE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Text of an open document, edited in place by small replacements.
+//
+// The text is kept in a sequence of chunks of bounded size, each knowing its
+// number of newlines. An edit rewrites only the chunks it touches, and
+// positions are found by skipping whole chunks, so the cost of an edit
+// doesn't grow with the size of the document like it does for a single
+// string.
+//
+// Positions are given like in the Language Server Protocol: a line number
+// and a character offset in UTF-16 code units, both starting from 0.
+class Rope {
+ public:
+  Rope() = default;
+  explicit Rope(absl::string_view text);
+
+  // Returns the size of the text in bytes.
+  size_t size() const { return size_; }
+
+  // Returns the byte offset of <character> in <line>. Positions after the
+  // end of a line are the end of that line, and lines after the end of the
+  // text are the end of the text.
+  size_t Offset(int line, int character) const;
+
+  // Replaces bytes in [<start>, <end>) with <text>.
+  void Replace(size_t start, size_t end, absl::string_view text);
+
+  // Returns the whole text.
+  std::string ToString() const;
+
+ private:
+  struct Chunk {
+    std::string text;
+    int newlines = 0;
+  };
+
+  // Splits <text> into chunks and inserts them at <position>.
+  void InsertChunks(int position, absl::string_view text);
+
+  std::vector<Chunk> chunks_;
+  size_t size_ = 0;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_ROPE_H_
@@ -0,0 +1,93 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/rope.h"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(RopeTest, Offset) {
+  // "é" is 2 bytes and 1 UTF-16 unit, "😀" is 4 bytes and 2 units.
+  Rope rope("SELECT 1;\n\xc3\xa9 \xf0\x9f\x98\x80 x\n\nlast");
+  EXPECT_EQ(rope.Offset(0, 0), 0);
+  EXPECT_EQ(rope.Offset(0, 7), 7);
+  EXPECT_EQ(rope.Offset(0, 100), 9);
+  EXPECT_EQ(rope.Offset(1, 0), 10);
+  EXPECT_EQ(rope.Offset(1, 1), 12);
+  EXPECT_EQ(rope.Offset(1, 2), 13);
+  EXPECT_EQ(rope.Offset(1, 4), 17);
+  EXPECT_EQ(rope.Offset(1, 5), 18);
+  EXPECT_EQ(rope.Offset(2, 3), 20);
+  EXPECT_EQ(rope.Offset(3, 2), 23);
+  EXPECT_EQ(rope.Offset(10, 0), rope.size());
+}
+
+TEST(RopeTest, Replace) {
+  Rope rope("SELECT 1;\nSELECT 2;\n");
+  rope.Replace(7, 8, "a AS b");
+  EXPECT_EQ(rope.ToString(), "SELECT a AS b;\nSELECT 2;\n");
+  rope.Replace(rope.Offset(1, 0), rope.Offset(2, 0), "");
+  EXPECT_EQ(rope.ToString(), "SELECT a AS b;\n");
+  rope.Replace(rope.size(), rope.size(), "SELECT 3;");
+  EXPECT_EQ(rope.ToString(), "SELECT a AS b;\nSELECT 3;");
+  EXPECT_EQ(rope.size(), 24);
+
+  Rope empty;
+  empty.Replace(0, 0, "x");
+  EXPECT_EQ(empty.ToString(), "x");
+}
+
+// Compares random edits of a large text with the same edits of a string.
+TEST(RopeTest, RandomEdits) {
+  std::mt19937 random(1);
+  std::string expected;
+  for (int i = 0; i < 2000; ++i)
+    expected += "SELECT " + std::to_string(i) + " FROM T;\n";
+  Rope rope(expected);
+
+  for (int i = 0; i < 2000; ++i) {
+    size_t start = random() % (expected.size() + 1);
+    size_t end = start + random() % std::min<size_t>(
+                             expected.size() - start + 1, i % 10 ? 20 : 10000);
+    std::string text(random() % (i % 7 ? 10 : 5000), 'a' + i % 26);
+    if (i % 3 == 0) text += '\n';
+    expected.replace(start, end - start, text);
+    rope.Replace(start, end, text);
+    ASSERT_EQ(rope.size(), expected.size());
+  }
+  EXPECT_EQ(rope.ToString(), expected);
+
+  int line = 0;
+  size_t line_start = 0;
+  for (size_t i = 0; i <= expected.size(); ++i) {
+    if (i == expected.size() || expected[i] == '\n') {
+      EXPECT_EQ(rope.Offset(line, 0), line_start);
+      EXPECT_EQ(rope.Offset(line, 3), std::min(line_start + 3, i));
+      ++line;
+      line_start = i + 1;
+    }
+  }
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -13,114 +13,543 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <cstdint>
 #include <fstream>
+#include <iterator>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
-#include "absl/strings/str_join.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
-#include "google/protobuf/text_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "src/baseline.h"
 #include "src/config.pb.h"
+#include "src/config_comparison.h"
+#include "src/config_resolver.h"
+#include "src/diff_parser.h"
+#include "src/directory_walker.h"
+#include "src/disk_cache.h"
+#include "src/file_utils.h"
+#include "src/file_watcher.h"
+#include "src/fix_applier.h"
+#include "src/finding_tracker.h"
+#include "src/input_source.h"
 #include "src/linter.h"
+#include "src/lsp_server.h"
+#include "src/query_log.h"
+#include "src/schema_catalog.h"
+#include "src/statement_cache.h"
+#include "src/statement_splitter.h"
+#include "src/thread_pool.h"
 
 ABSL_FLAG(std::string, config, "",
           "A prototxt file having configuration options.");
 
+ABSL_FLAG(std::string, config_name,
+          std::string(zetasql::linter::kDirectoryConfigName),
+          "Name of per directory configuration files. They are searched in "
+          "the directory of each sql file and its parents, and override "
+          "--config. An empty name disables the search.");
+
+ABSL_FLAG(std::vector<std::string>, configs, {},
+          "Comma separated configuration files. Files are linted once with "
+          "each of them, and a summary compares their findings with the "
+          "first one.");
+
 ABSL_FLAG(bool, quick, false,
           "Read from standard input. It will read one"
           "statement and continue until reading semicolon ';'");
 
+ABSL_FLAG(bool, stream, false,
+          "Read statements from standard input until it is closed. Each "
+          "statement is linted as soon as its semicolon ';' is read.");
+
 ABSL_FLAG(bool, print_ast, false, "Print parsed AST for the input queries.");
 
+ABSL_FLAG(bool, watch, false,
+          "Watch the directories given as arguments. Changed sql files are "
+          "linted again, and only new and resolved findings are printed. "
+          "All files are linted again when a --config_name file changes.");
+
+ABSL_FLAG(bool, lsp, false,
+          "Run as a Language Server Protocol server on standard input and "
+          "output, publishing findings of open documents as diagnostics.");
+
+ABSL_FLAG(int, lsp_debounce_ms, 30,
+          "In --lsp mode, a document is linted when it wasn't edited for "
+          "this many milliseconds.");
+
+ABSL_FLAG(std::string, query_log, "",
+          "A file of newline delimited JSON records with 'query', 'user' and "
+          "'job_id' fields. Each query is linted separately and a JSON result "
+          "record is printed for it. Use '-' to read from standard input.");
+
+ABSL_FLAG(int, fingerprint_cache_size, 100000,
+          "Number of query templates whose results are cached in --query_log "
+          "mode. Queries that differ only in literals share a template. "
+          "Use 0 to disable the cache.");
+
+ABSL_FLAG(std::string, cache_dir, "",
+          "A directory to cache lint results in. Unchanged files are not "
+          "linted again in later runs with the same configuration. The "
+          "directory can be shared by parallel runs.");
+
+ABSL_FLAG(int, cache_max_size_mb, 512,
+          "Size limit of --cache_dir in megabytes. Least recently used "
+          "results are removed when a run grows the cache beyond it.");
+
+ABSL_FLAG(bool, fix, false,
+          "Applies automatic fixes of findings to the sql files in place, "
+          "instead of printing them.");
+
+ABSL_FLAG(std::string, baseline, "",
+          "A baseline file written by --write_baseline. Findings in it are "
+          "not printed, so only new findings are reported.");
+
+ABSL_FLAG(std::string, write_baseline, "",
+          "Writes all findings of the linted files to this baseline file "
+          "instead of printing them.");
+
+ABSL_FLAG(std::string, write_schema, "",
+          "Converts the schema dumps given as arguments, lines of "
+          "'table,column,type', into this schema file for the 'schema' "
+          "configuration option.");
+
+ABSL_FLAG(std::string, diff, "",
+          "A unified diff, like the output of 'git diff'. Only the statements "
+          "with changed lines are linted, and only findings in changed lines "
+          "are printed. Use '-' to read from standard input.");
+
+ABSL_FLAG(std::vector<std::string>, exclude, {},
+          "Comma separated '.gitignore' style patterns. Matching files and "
+          "directories are skipped while searching directory arguments.");
+
+ABSL_FLAG(std::string, exclude_from, "",
+          "A '.gitignore' style file of patterns to skip while searching "
+          "directory arguments.");
+
+ABSL_FLAG(int, threads, 0,
+          "Number of threads searching directory arguments, reading and "
+          "decompressing inputs and linting query logs. Uses the number of "
+          "cores if it is not positive.");
+
+ABSL_FLAG(std::string, files_from, "",
+          "A file containing the names of sql files to lint, separated by "
+          "newlines or NUL characters. Use '-' to read from standard input.");
+
 namespace zetasql::linter {
 namespace {
 
-std::string ReadFile(std::string filename) {
-  std::ifstream file(filename.c_str());
-  std::string str = "";
-  for (std::string line; std::getline(file, line);) {
-    str += line + "\n";
-  }
-  return str;
-}
+// Events of a file are coalesced until it is quiet for this long.
+constexpr int kWatchQuietPeriodMs = 100;
+
+// Fixes that conflict with others are applied in later passes, after the
+// file is linted again, at most this many times.
+constexpr int kMaxFixPasses = 4;
 
 Config ReadFromConfigFile(std::string filename) {
   Config config;
-  std::string str = ReadFile(filename);
-  if (!google::protobuf::TextFormat::ParseFromString(str, &config)) {
-    std::cerr << "Configuration file couldn't be parsed." << std::endl;
+  absl::Status status = ReadConfigFile(filename, &config);
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
     config = Config();
   }
   return config;
 }
 
-bool HasValidExtension(std::string filename) {
-  std::vector<std::string> supported_extensions{".sql", ".sqlm", ".sqlp",
-                                                ".sqlt", ".gsql"};
+bool HasValidExtension(const std::string& filename) {
+  if (!IsSupportedInput(filename)) {
+    std::cerr << "Ignoring " << filename << ";  not have a valid extension ("
+              << SqlExtensionList()
+              << ", compressed .gz, .zst, or archives .tar, .tar.gz, .tgz, "
+                 ".tar.zst, .tzst)"
+              << std::endl;
+    return 0;
+  }
+  return 1;
+}
+
+int ThreadCount() {
+  int threads = absl::GetFlag(FLAGS_threads);
+  if (threads <= 0) threads = ThreadPool::DefaultThreadCount();
+  return threads;
+}
 
-  std::string extension_str = absl::StrJoin(supported_extensions.begin(),
-                                            supported_extensions.end(), ", ");
+// Returns a matcher of --exclude and --exclude_from patterns.
+ExcludeMatcher ExcludeMatcherFromFlags() {
+  ExcludeMatcher matcher;
+  absl::Status status = absl::OkStatus();
+  for (const std::string& pattern : absl::GetFlag(FLAGS_exclude))
+    if (status.ok()) status = matcher.AddPattern(pattern);
+  std::string exclude_from = absl::GetFlag(FLAGS_exclude_from);
+  if (status.ok() && !exclude_from.empty())
+    status = matcher.AddPatterns(ReadFile(exclude_from));
+  if (status.ok()) status = matcher.Compile();
+  if (!status.ok()) std::cerr << status.message() << std::endl;
+  return matcher;
+}
 
-  bool ok = false;
-  std::string extension = "";
-  // Find until last '.';
-  for (int i = filename.size() - 1; i >= 0; i--) {
-    extension = filename[i] + extension;
-    if (filename[i] == '.') break;
+// Replaces directories in 'args' with the sql files inside of them.
+std::vector<std::string> DiscoverFiles(const std::vector<std::string>& args) {
+  ExcludeMatcher matcher = ExcludeMatcherFromFlags();
+  std::vector<std::string> files;
+  std::vector<std::string> directories;
+  for (const std::string& arg : args) {
+    if (IsDirectory(arg))
+      directories.push_back(arg);
+    else
+      files.push_back(arg);
   }
+  if (directories.empty()) return files;
 
-  for (const std::string supported_extension : supported_extensions)
-    if (supported_extension == extension) ok = true;
-  if (!ok) {
-    std::cerr << "Ignoring " << filename << ";  not have a valid extension ("
-              << extension_str << ")" << std::endl;
+  for (std::string& file : FindSqlFiles(directories, matcher, ThreadCount()))
+    files.push_back(std::move(file));
+  return files;
+}
+
+// Lints statements from standard input as soon as their semicolon arrives.
+// If <single> is true, it stops after the first statement.
+void stream_run(const Config& config, bool single) {
+  StatementSplitter splitter;
+  std::string statement;
+  char buffer[64 * 1024];
+  while (true) {
+    ssize_t size = read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) continue;
+    if (size > 0)
+      splitter.Append(absl::string_view(buffer, size));
+    else
+      splitter.Finish();
+
+    while (splitter.NextStatement(&statement)) {
+      auto [line, column] = splitter.StatementStart();
+      LinterResult result = RunStatementChecks(statement, config, line, column);
+      for (LintError& error : result.GetErrors()) error.PrintError();
+      std::cout.flush();
+      if (single) return;
+    }
+    if (size <= 0) return;
+  }
+}
+
+// Lints the query log given with --query_log.
+int query_log_run(const Config& config) {
+  std::string query_log = absl::GetFlag(FLAGS_query_log);
+  if (query_log == "-") {
+    // Unlike std::cin, a file stream knows how much of a pipe is readable
+    // without blocking, so records are batched only while they are waiting.
+    std::ifstream stdin_file("/dev/stdin", std::ios::binary);
+    LintQueryLog(stdin_file ? stdin_file : std::cin, std::cout, config,
+                 ThreadCount(), absl::GetFlag(FLAGS_fingerprint_cache_size));
     return 0;
   }
-  return 1;
+  std::ifstream file(query_log, std::ios::binary);
+  if (!file) {
+    std::cerr << "Query log couldn't be opened: " << query_log << std::endl;
+    return 1;
+  }
+  LintQueryLog(file, std::cout, config, ThreadCount(),
+               absl::GetFlag(FLAGS_fingerprint_cache_size));
+  return 0;
+}
+
+void run(const std::vector<std::string>& sql_files, const Config& config,
+         const Baseline& baseline) {
+  bool debug = absl::GetFlag(FLAGS_print_ast);
+  std::string write_baseline = absl::GetFlag(FLAGS_write_baseline);
+  std::vector<uint64_t> fingerprints;
+  ConfigResolver resolver(config, absl::GetFlag(FLAGS_config_name));
+  std::unique_ptr<DiskCache> cache;
+  if (!absl::GetFlag(FLAGS_cache_dir).empty()) {
+    cache = std::make_unique<DiskCache>(
+        absl::GetFlag(FLAGS_cache_dir),
+        int64_t{absl::GetFlag(FLAGS_cache_max_size_mb)} << 20);
+  }
+  std::vector<std::string> filenames;
+  for (const std::string& filename : sql_files)
+    if (HasValidExtension(filename)) filenames.push_back(filename);
+
+  // Later files are read and decompressed by --threads workers while
+  // earlier ones are linted.
+  InputReader reader(std::move(filenames), 16, ThreadCount());
+  InputFile input;
+  while (reader.Next(&input)) {
+    if (!input.status.ok()) {
+      std::cerr << input.name << ": " << input.status.message() << std::endl;
+      continue;
+    }
+    if (debug) PrintASTTree(input.content);
+    std::shared_ptr<const ResolvedConfig> file_config =
+        resolver.Resolve(input.source);
+    LinterResult result(input.name);
+    if (cache == nullptr) {
+      result = RunChecks(input.content, file_config->options, input.name);
+    } else {
+      uint64_t key = DiskCache::Key(input.content, file_config->fingerprint);
+      if (!cache->Lookup(key, &result)) {
+        result = RunChecks(input.content, file_config->options, input.name);
+        cache->Store(key, result);
+      }
+    }
+
+    if (!write_baseline.empty()) {
+      AppendFingerprints(input.name, input.content, result, &fingerprints);
+      continue;
+    }
+    baseline.Suppress(input.name, input.content, &result);
+    result.PrintResult();
+  }
+  if (cache != nullptr) cache->Evict();
+  if (!write_baseline.empty()) {
+    int count = fingerprints.size();
+    absl::Status status =
+        WriteBaseline(write_baseline, std::move(fingerprints));
+    if (status.ok())
+      std::cerr << count << " findings written to the baseline" << std::endl;
+    else
+      std::cerr << status.message() << std::endl;
+  }
 }
 
-void quick_run(Config config) {
-  std::string str = "";
-  for (std::string line; std::getline(std::cin, line);) {
-    bool end = false;
-    for (char c : line) {
-      str += c;
-      if (c == ';') {
-        end = true;
-        break;
+// Applies automatic fixes to <sql_files> in place, on --threads workers.
+void fix_run(const std::vector<std::string>& sql_files, const Config& config) {
+  ConfigResolver resolver(config, absl::GetFlag(FLAGS_config_name));
+  std::atomic<int> fixed_findings(0);
+  std::atomic<int> fixed_files(0);
+  absl::Mutex output_mutex;
+
+  auto fix = [&](const std::string& filename) {
+    // Unlike 'ReadFile', the content is kept as it is, a missing newline at
+    // the end isn't added to the fixed file.
+    struct stat info;
+    std::ifstream file;
+    if (stat(filename.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+      file.open(filename, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    if (!file.is_open() || file.bad()) {
+      absl::MutexLock lock(&output_mutex);
+      std::cerr << filename << ": File couldn't be read" << std::endl;
+      return;
+    }
+    std::shared_ptr<const ResolvedConfig> file_config =
+        resolver.Resolve(filename);
+    std::string fixed;
+    int count = 0;
+    for (int pass = 0; pass < kMaxFixPasses; ++pass) {
+      LinterResult result = RunChecks(content, file_config->options, filename);
+      int fixable = 0;
+      for (const LintError& error : result.GetErrors())
+        if (!error.GetFix().empty()) ++fixable;
+      int applied = ApplyFixes(content, result, &fixed);
+      if (applied == 0) break;
+      count += applied;
+      content.swap(fixed);
+      if (applied == fixable) break;
+    }
+    if (count == 0) return;
+
+    absl::Status status = WriteFileAtomically(filename, content);
+    if (!status.ok()) {
+      absl::MutexLock lock(&output_mutex);
+      std::cerr << status.message() << std::endl;
+      return;
+    }
+    fixed_findings += count;
+    ++fixed_files;
+  };
+
+  {
+    ThreadPool pool(ThreadCount(), 2 * ThreadCount());
+    for (const std::string& filename : sql_files) {
+      if (!HasValidExtension(filename)) continue;
+      if (IsArchiveOrCompressed(filename)) {
+        std::cerr << "Ignoring " << filename
+                  << "; archives can't be fixed in place" << std::endl;
+        continue;
       }
+      pool.Schedule([&fix, filename]() { fix(filename); });
+    }
+  }
+  std::cerr << "Fixed " << fixed_findings << " findings in " << fixed_files
+            << " files" << std::endl;
+}
+
+// Lints the lines changed by the diff given with --diff, in the changed sql
+// files, or only in <sql_files> if there are any.
+int diff_run(const std::vector<std::string>& sql_files, const Config& config,
+             const Baseline& baseline) {
+  std::string diff_file = absl::GetFlag(FLAGS_diff);
+  std::stringstream diff;
+  if (diff_file == "-") {
+    diff << std::cin.rdbuf();
+  } else {
+    std::ifstream file(diff_file, std::ios::binary);
+    if (!file) {
+      std::cerr << "Diff couldn't be opened: " << diff_file << std::endl;
+      return 1;
+    }
+    diff << file.rdbuf();
+  }
+  std::map<std::string, LineRanges> changes;
+  absl::Status status = ParseUnifiedDiff(diff.str(), &changes);
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> filenames;
+  if (sql_files.empty()) {
+    for (const auto& [filename, lines] : changes)
+      if (HasSqlExtension(filename)) filenames.push_back(filename);
+  } else {
+    for (const std::string& filename : sql_files) {
+      absl::string_view name = filename;
+      absl::ConsumePrefix(&name, "./");
+      if (changes.count(std::string(name)) > 0 && HasValidExtension(filename))
+        filenames.push_back(std::string(name));
     }
-    str += "\n";
-    if (end) break;
   }
-  zetasql::linter::LinterResult result =
-      zetasql::linter::RunChecks(absl::string_view(str), config, "");
 
-  result.PrintResult();
+  ConfigResolver resolver(config, absl::GetFlag(FLAGS_config_name));
+  StatementCache cache;
+  for (const std::string& filename : filenames) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+      std::cerr << filename << ": File couldn't be read" << std::endl;
+      continue;
+    }
+    std::string content = ReadFile(filename);
+    std::shared_ptr<const ResolvedConfig> file_config =
+        resolver.Resolve(filename);
+    LinterResult result = cache.RunChecksOnLines(
+        content, file_config->options, file_config->fingerprint,
+        changes[filename], filename);
+    baseline.Suppress(filename, content, &result);
+    result.PrintResult();
+  }
+  return 0;
 }
 
-void run(std::vector<std::string> sql_files, Config config) {
-  bool debug = absl::GetFlag(FLAGS_print_ast);
-  bool runner = true;
-  for (const std::string filename : sql_files) {
-    // The first argument is './runner'.
-    if (runner || !HasValidExtension(filename)) {
-      runner = false;
+// Lints <sql_files> with each configuration of --configs, and prints the
+// findings of each configuration and a summary of their differences.
+void multi_config_run(const std::vector<std::string>& sql_files) {
+  std::vector<std::string> names = absl::GetFlag(FLAGS_configs);
+  std::vector<Config> configs;
+  for (const std::string& name : names)
+    configs.push_back(ReadFromConfigFile(name));
+  ConfigComparison comparison(names);
+
+  std::vector<std::string> filenames;
+  for (const std::string& filename : sql_files)
+    if (HasValidExtension(filename)) filenames.push_back(filename);
+  InputReader reader(std::move(filenames), 16, ThreadCount());
+  InputFile input;
+  while (reader.Next(&input)) {
+    if (!input.status.ok()) {
+      std::cerr << input.name << ": " << input.status.message() << std::endl;
       continue;
     }
-    std::string str = ReadFile(filename);
-    if (debug) PrintASTTree(str);
-    LinterResult result = RunChecks(absl::string_view(str), config, filename);
+    std::vector<LinterResult> results =
+        RunChecks(input.content, configs, input.name);
+    for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+      results[i].Sort();
+      for (LintError& error : results[i].GetErrors())
+        std::cout << names[i] << ": " << error.ToString() << "\n";
+    }
+    comparison.Add(std::move(results));
+  }
+  std::cout << comparison.Summary();
+}
 
-    result.PrintResult();
+// Lints sql files in the directories given with --watch, then lints files
+// again when they change and prints only new and resolved findings. All
+// files are linted again when a configuration file changes.
+void watch_run(const std::vector<std::string>& args, const Config& config) {
+  ExcludeMatcher matcher = ExcludeMatcherFromFlags();
+  FileWatcher watcher(matcher, absl::GetFlag(FLAGS_config_name));
+  std::vector<std::string> directories;
+  std::vector<std::string> files;
+  for (const std::string& arg : args) {
+    absl::Status status = watcher.Watch(arg, &files);
+    if (status.ok())
+      directories.push_back(arg);
+    else
+      std::cerr << "Ignoring " << arg << "; " << status.message() << std::endl;
+  }
+  ConfigResolver resolver(config, absl::GetFlag(FLAGS_config_name));
+  FindingTracker tracker;
+
+  auto lint = [&](const std::vector<std::string>& paths) {
+    std::vector<std::string> added, resolved;
+    for (const std::string& path : paths) {
+      struct stat info;
+      if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        // Removed files, and directories that were moved away.
+        tracker.Remove(path, &resolved);
+        continue;
+      }
+      std::string content = ReadFile(path);
+      LinterResult result =
+          RunChecks(content, resolver.Resolve(path)->options, path);
+      tracker.Update(path, content, result, &added, &resolved);
+    }
+    for (const std::string& finding : resolved)
+      std::cout << "- " << finding << std::endl;
+    for (const std::string& finding : added)
+      std::cout << "+ " << finding << std::endl;
+    std::cerr << "Linted " << paths.size() << " files" << std::endl;
+  };
+
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+  lint(files);
+  std::vector<std::string> paths;
+  while (true) {
+    if (!watcher.WaitForChanges(absl::InfiniteDuration(),
+                                absl::Milliseconds(kWatchQuietPeriodMs),
+                                &paths))
+      continue;
+    const int count = paths.size();
+    paths.erase(std::remove_if(paths.begin(), paths.end(),
+                               [&watcher](const std::string& path) {
+                                 return watcher.IsConfigFile(path);
+                               }),
+                paths.end());
+    const bool config_changed = static_cast<int>(paths.size()) < count;
+    if (watcher.Overflowed()) {
+      // Changes were lost, all files are linted again.
+      resolver.Clear();
+      paths = FindSqlFiles(directories, matcher, ThreadCount());
+      for (std::string& file : tracker.Files()) paths.push_back(file);
+    } else if (config_changed) {
+      // The resolver reads changed configuration files again, and any
+      // merged configuration can include them. The tracker has all linted
+      // files, clean ones too.
+      for (std::string& file : tracker.Files()) paths.push_back(file);
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    lint(paths);
   }
 }
 
@@ -130,23 +559,101 @@ void run(std::vector<std::string> sql_files, Config config) {
 int main(int argc, char* argv[]) {
   if (argc < 2) {
     std::cerr << "Usage: ./runner --config=<config_file> <file_names>\n"
+              << "       ./runner --config=<config_file> @<file_list>\n"
+              << "       ./runner --config=<config_file> --files_from=-\n"
               << std::endl;
     return 1;
   }
 
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  // The first argument is './runner'.
   std::vector<std::string> sql_files;
-  for (char* file : absl::ParseCommandLine(argc, argv))
-    sql_files.push_back(std::string(file));
+  absl::Status status = zetasql::linter::ExpandResponseFiles(
+      std::vector<std::string>(args.begin() + 1, args.end()), &sql_files);
+  if (!status.ok()) {
+    std::cerr << status.message() << std::endl;
+    return 1;
+  }
+
+  std::string files_from = absl::GetFlag(FLAGS_files_from);
+  if (files_from == "-") {
+    for (std::string& file : zetasql::linter::ReadFileList(std::cin))
+      sql_files.push_back(std::move(file));
+  } else if (!files_from.empty()) {
+    std::ifstream file_list(files_from, std::ios::binary);
+    if (!file_list) {
+      std::cerr << "File list couldn't be opened: " << files_from << std::endl;
+      return 1;
+    }
+    for (std::string& file : zetasql::linter::ReadFileList(file_list))
+      sql_files.push_back(std::move(file));
+  }
+
+  std::string write_schema = absl::GetFlag(FLAGS_write_schema);
+  if (!write_schema.empty()) {
+    std::string dump;
+    for (const std::string& file : sql_files)
+      absl::StrAppend(&dump, zetasql::linter::ReadFile(file));
+    status = zetasql::linter::WriteSchema(dump, write_schema);
+    if (!status.ok()) {
+      std::cerr << status.message() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (absl::GetFlag(FLAGS_watch)) {
+    zetasql::linter::watch_run(
+        sql_files,
+        zetasql::linter::ReadFromConfigFile(absl::GetFlag(FLAGS_config)));
+    return 0;
+  }
+
+  sql_files = zetasql::linter::DiscoverFiles(sql_files);
+
   std::string config_file = absl::GetFlag(FLAGS_config);
   bool quick = absl::GetFlag(FLAGS_quick);
 
   zetasql::linter::Config config =
       zetasql::linter::ReadFromConfigFile(config_file);
 
-  if (quick)
-    zetasql::linter::quick_run(config);
+  zetasql::linter::Baseline baseline;
+  std::string baseline_file = absl::GetFlag(FLAGS_baseline);
+  if (!baseline_file.empty()) {
+    status = baseline.Load(baseline_file);
+    if (!status.ok()) {
+      std::cerr << status.message() << std::endl;
+      return 1;
+    }
+  }
+
+  if (!absl::GetFlag(FLAGS_diff).empty())
+    return zetasql::linter::diff_run(sql_files, config, baseline);
+
+  if (!absl::GetFlag(FLAGS_query_log).empty())
+    return zetasql::linter::query_log_run(config);
+
+  if (!absl::GetFlag(FLAGS_configs).empty()) {
+    zetasql::linter::multi_config_run(sql_files);
+    return 0;
+  }
+
+  if (absl::GetFlag(FLAGS_lsp)) {
+    zetasql::linter::LspServer server(
+        std::cin, std::cout, config, absl::GetFlag(FLAGS_config_name),
+        absl::Milliseconds(absl::GetFlag(FLAGS_lsp_debounce_ms)));
+    return server.Run();
+  }
+
+  if (absl::GetFlag(FLAGS_fix)) {
+    zetasql::linter::fix_run(sql_files, config);
+    return 0;
+  }
+
+  if (quick || absl::GetFlag(FLAGS_stream))
+    zetasql::linter::stream_run(config, quick);
   else
-    zetasql::linter::run(sql_files, config);
+    zetasql::linter::run(sql_files, config, baseline);
 
   return 0;
 }
@@ -0,0 +1,339 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/schema_catalog.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "src/file_utils.h"
+#include "src/hash_util.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+
+namespace zetasql::linter {
+
+// Entries of the schema file. Strings are offsets and sizes in the string
+// section.
+struct SchemaCatalog::TableEntry {
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint32_t first_column;
+  uint32_t column_count;
+};
+
+struct SchemaCatalog::ColumnEntry {
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint32_t type_offset;
+  uint32_t type_size;
+};
+
+namespace {
+
+// "ZLSCHM01" in the byte order of the writer.
+constexpr uint64_t kMagic = 0x31304d4843534c5aULL;
+
+struct Header {
+  uint64_t magic;
+  uint32_t table_count;
+  uint32_t column_count;
+  uint32_t string_size;
+  uint32_t reserved;
+};
+
+// Compares <a> and <b> like their lowercase versions.
+int CompareIgnoreCase(absl::string_view a, absl::string_view b) {
+  const size_t size = std::min(a.size(), b.size());
+  for (size_t i = 0; i < size; ++i) {
+    const unsigned char x = absl::ascii_tolower(a[i]);
+    const unsigned char y = absl::ascii_tolower(b[i]);
+    if (x != y) return x < y ? -1 : 1;
+  }
+  if (a.size() == b.size()) return 0;
+  return a.size() < b.size() ? -1 : 1;
+}
+
+// Sets options of the analyzer and the builtin catalog of schema catalogs.
+void InitializeAnalyzer(AnalyzerOptions *options, SimpleCatalog *builtins) {
+  options->mutable_language()->EnableMaximumLanguageFeatures();
+  options->set_error_message_mode(ERROR_MESSAGE_WITH_PAYLOAD);
+  options->set_record_parse_locations(true);
+  builtins->AddZetaSQLFunctions(options->language());
+}
+
+// Columns of a table of a schema dump.
+struct DumpTable {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> columns;
+};
+
+// Appends <text> to the string section <strings> once, and returns its
+// offset.
+uint32_t AddString(absl::string_view text, std::string *strings,
+                   absl::flat_hash_map<std::string, uint32_t> *offsets) {
+  auto [it, inserted] = offsets->emplace(text, strings->size());
+  if (inserted) strings->append(text.data(), text.size());
+  return it->second;
+}
+
+}  // namespace
+
+absl::Status WriteSchema(absl::string_view dump, const std::string &filename) {
+  AnalyzerOptions options;
+  TypeFactory type_factory;
+  SimpleCatalog builtins("builtins", &type_factory);
+  InitializeAnalyzer(&options, &builtins);
+
+  // Tables by their lowercase names, so they are sorted ignoring case.
+  std::map<std::string, DumpTable> tables;
+  int line_number = 0;
+  for (absl::string_view line : absl::StrSplit(dump, '\n')) {
+    ++line_number;
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || absl::StartsWithIgnoreCase(line, "table_name,"))
+      continue;
+    // Types can have commas, e.g. STRUCT<a INT64, b STRING>.
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, absl::MaxSplits(',', 2));
+    if (fields.size() != 3)
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Line ", line_number, " of the schema dump isn't table,column,type"));
+    absl::string_view table = absl::StripAsciiWhitespace(fields[0]);
+    absl::string_view column = absl::StripAsciiWhitespace(fields[1]);
+    absl::string_view type_name = absl::StripAsciiWhitespace(fields[2]);
+    if (type_name.size() >= 2 && type_name.front() == '"' &&
+        type_name.back() == '"')
+      type_name = type_name.substr(1, type_name.size() - 2);
+
+    const Type *type;
+    absl::Status status = AnalyzeType(std::string(type_name), options,
+                                      &builtins, &type_factory, &type);
+    if (!status.ok())
+      return absl::InvalidArgumentError(
+          absl::StrCat("Line ", line_number,
+                       " of the schema dump: unknown type '", type_name, "'"));
+
+    DumpTable &entry = tables[absl::AsciiStrToLower(table)];
+    if (entry.name.empty()) entry.name = std::string(table);
+    for (const auto &existing : entry.columns) {
+      if (absl::EqualsIgnoreCase(existing.first, column))
+        return absl::InvalidArgumentError(
+            absl::StrCat("Line ", line_number, " of the schema dump: column ",
+                         column, " of ", table, " is repeated"));
+    }
+    entry.columns.emplace_back(column, type_name);
+  }
+
+  std::vector<SchemaCatalog::TableEntry> table_entries;
+  std::vector<SchemaCatalog::ColumnEntry> column_entries;
+  std::string strings;
+  absl::flat_hash_map<std::string, uint32_t> offsets;
+  for (const auto &[key, table] : tables) {
+    table_entries.push_back(
+        {AddString(table.name, &strings, &offsets),
+         static_cast<uint32_t>(table.name.size()),
+         static_cast<uint32_t>(column_entries.size()),
+         static_cast<uint32_t>(table.columns.size())});
+    for (const auto &[name, type_name] : table.columns) {
+      column_entries.push_back({AddString(name, &strings, &offsets),
+                                static_cast<uint32_t>(name.size()),
+                                AddString(type_name, &strings, &offsets),
+                                static_cast<uint32_t>(type_name.size())});
+    }
+  }
+
+  Header header = {kMagic, static_cast<uint32_t>(table_entries.size()),
+                   static_cast<uint32_t>(column_entries.size()),
+                   static_cast<uint32_t>(strings.size()), 0};
+  std::string content(reinterpret_cast<const char *>(&header), sizeof(header));
+  content.append(reinterpret_cast<const char *>(table_entries.data()),
+                 table_entries.size() * sizeof(SchemaCatalog::TableEntry));
+  content.append(reinterpret_cast<const char *>(column_entries.data()),
+                 column_entries.size() * sizeof(SchemaCatalog::ColumnEntry));
+  content.append(strings);
+  return WriteFileAtomically(filename, content);
+}
+
+SchemaCatalog::SchemaCatalog() : builtins_("builtins", &type_factory_) {
+  InitializeAnalyzer(&analyzer_options_, &builtins_);
+}
+
+SchemaCatalog::~SchemaCatalog() {
+  if (data_ != nullptr) munmap(data_, size_);
+}
+
+absl::Status SchemaCatalog::Load(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return absl::NotFoundError(absl::StrCat(
+        "Schema couldn't be opened: ", filename, ": ", strerror(errno)));
+  }
+  struct stat info;
+  void *data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 &&
+      info.st_size >= static_cast<off_t>(sizeof(Header)))
+    data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  absl::Status invalid =
+      absl::InvalidArgumentError(absl::StrCat("Invalid schema: ", filename));
+  if (data == MAP_FAILED) return invalid;
+
+  const size_t size = info.st_size;
+  const Header *header = static_cast<const Header *>(data);
+  const uint64_t expected_size =
+      sizeof(Header) + uint64_t{header->table_count} * sizeof(TableEntry) +
+      uint64_t{header->column_count} * sizeof(ColumnEntry) +
+      header->string_size;
+  if (header->magic != kMagic || expected_size != size) {
+    munmap(data, size);
+    return invalid;
+  }
+  if (data_ != nullptr) munmap(data_, size_);
+  data_ = data;
+  size_ = size;
+  filename_ = filename;
+  stamp_ = StampOf(info);
+  fingerprint_ = Fingerprint64(
+      absl::string_view(static_cast<const char *>(data), size));
+  table_count_ = header->table_count;
+  column_count_ = header->column_count;
+  tables_ = reinterpret_cast<const TableEntry *>(header + 1);
+  columns_ = reinterpret_cast<const ColumnEntry *>(tables_ + table_count_);
+  strings_ = reinterpret_cast<const char *>(columns_ + header->column_count);
+  return absl::OkStatus();
+}
+
+bool SchemaCatalog::IsCurrent() const {
+  return FileStamp(filename_) == stamp_;
+}
+
+absl::Status SchemaCatalog::Shared(const std::string &filename,
+                                   std::shared_ptr<SchemaCatalog> *catalog) {
+  struct Loaded {
+    std::string stamp;
+    absl::Status status;
+    std::shared_ptr<SchemaCatalog> catalog;
+  };
+  static absl::Mutex mutex(absl::kConstInit);
+  static auto *catalogs = new std::map<std::string, Loaded>();
+  const std::string stamp = FileStamp(filename);
+  absl::MutexLock lock(&mutex);
+  Loaded &loaded = (*catalogs)[filename];
+  if ((loaded.catalog == nullptr && loaded.status.ok()) ||
+      loaded.stamp != stamp) {
+    // Users of an earlier version keep it until they are done.
+    auto fresh = std::make_shared<SchemaCatalog>();
+    loaded.stamp = stamp;
+    loaded.status = fresh->Load(filename);
+    loaded.catalog = loaded.status.ok() ? std::move(fresh) : nullptr;
+  }
+  *catalog = loaded.catalog;
+  return loaded.status;
+}
+
+absl::string_view SchemaCatalog::String(uint32_t offset, uint32_t size) const {
+  const size_t string_size =
+      static_cast<const char *>(data_) + size_ - strings_;
+  if (uint64_t{offset} + size > string_size) return "";
+  return absl::string_view(strings_ + offset, size);
+}
+
+const SchemaCatalog::TableEntry *SchemaCatalog::FindEntry(
+    absl::string_view name) const {
+  const TableEntry *entry = std::lower_bound(
+      tables_, tables_ + table_count_, name,
+      [this](const TableEntry &table, absl::string_view key) {
+        return CompareIgnoreCase(String(table.name_offset, table.name_size),
+                                 key) < 0;
+      });
+  if (entry == tables_ + table_count_ ||
+      CompareIgnoreCase(String(entry->name_offset, entry->name_size), name) !=
+          0)
+    return nullptr;
+  return entry;
+}
+
+absl::Status SchemaCatalog::FindTable(const absl::Span<const std::string> &path,
+                                      const Table **table,
+                                      const FindOptions &options) {
+  const std::string name = absl::StrJoin(path, ".");
+  const TableEntry *entry = FindEntry(name);
+  if (entry == nullptr)
+    return absl::NotFoundError(absl::StrCat("Table not found: ", name));
+
+  absl::MutexLock lock(&mutex_);
+  std::unique_ptr<const Table> &used = used_tables_[entry];
+  if (used == nullptr) {
+    std::vector<SimpleTable::NameAndType> columns;
+    const uint64_t end = uint64_t{entry->first_column} + entry->column_count;
+    for (uint64_t i = entry->first_column; i < end && i < column_count_; ++i) {
+      const ColumnEntry &column = columns_[i];
+      const std::string type_name(
+          String(column.type_offset, column.type_size));
+      const Type *type;
+      // Types are checked when the schema file is written.
+      if (!AnalyzeType(type_name, analyzer_options_, &builtins_,
+                       &type_factory_, &type)
+               .ok())
+        type = types::StringType();
+      columns.emplace_back(
+          std::string(String(column.name_offset, column.name_size)), type);
+    }
+    used = std::make_unique<SimpleTable>(
+        std::string(String(entry->name_offset, entry->name_size)), columns);
+  }
+  *table = used.get();
+  return absl::OkStatus();
+}
+
+absl::Status SchemaCatalog::GetFunction(const std::string &name,
+                                        const Function **function,
+                                        const FindOptions &options) {
+  return builtins_.GetFunction(name, function, options);
+}
+
+absl::Status SchemaCatalog::GetType(const std::string &name, const Type **type,
+                                    const FindOptions &options) {
+  return builtins_.GetType(name, type, options);
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,140 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_SCHEMA_CATALOG_H_
+#define SRC_SCHEMA_CATALOG_H_
+
+// A ZetaSQL catalog of the tables of a schema, for the semantic checks.
+//
+// A schema dump is a text file of lines 'table,column,type', e.g. an export of
+// INFORMATION_SCHEMA.COLUMNS. 'WriteSchema' converts it once into a schema
+// file: 32 bit words in the byte order of the machine that wrote it, a magic
+// number, the number of tables, columns and string bytes, then tables sorted
+// by their names ignoring case, their columns and the strings. A schema file
+// is memory mapped, so loading it doesn't depend on the number of tables.
+// A table is converted into a ZetaSQL table only when a query uses it.
+//
+// A catalog is loaded once per version of its file and shared by all
+// threads, together with the analyzer options and the type factory of its
+// queries.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+
+namespace zetasql::linter {
+
+// Converts the schema dump <dump> into the schema file <filename>. Returns
+// an error for malformed lines and unknown types.
+absl::Status WriteSchema(absl::string_view dump, const std::string &filename);
+
+class SchemaCatalog : public Catalog {
+ public:
+  SchemaCatalog();
+  ~SchemaCatalog() override;
+
+  SchemaCatalog(const SchemaCatalog &) = delete;
+  SchemaCatalog &operator=(const SchemaCatalog &) = delete;
+
+  // Maps the schema file <filename>.
+  absl::Status Load(const std::string &filename);
+
+  // Sets <catalog> to the catalog of the schema file <filename>. A file is
+  // loaded again only if it was rewritten since the last call, e.g. by
+  // 'WriteSchema'; otherwise calls share the catalog or return the same
+  // error.
+  static absl::Status Shared(const std::string &filename,
+                             std::shared_ptr<SchemaCatalog> *catalog);
+
+  // Returns false if the schema file was rewritten since it was loaded.
+  bool IsCurrent() const;
+
+  // Fingerprint of the content of the schema file. It is a part of the keys
+  // of cached lint results, see 'ConfigFingerprint'.
+  uint64_t Fingerprint() const { return fingerprint_; }
+
+  // Number of tables in the schema.
+  int TableCount() const { return table_count_; }
+
+  // Options to analyze queries against this catalog.
+  const AnalyzerOptions &analyzer_options() const { return analyzer_options_; }
+
+  TypeFactory *type_factory() { return &type_factory_; }
+
+  std::string FullName() const override { return "schema"; }
+
+  // Tables are looked up by their whole dotted path, ignoring case.
+  absl::Status FindTable(const absl::Span<const std::string> &path,
+                         const Table **table,
+                         const FindOptions &options = FindOptions()) override;
+
+  // Functions and types are the builtin ones.
+  absl::Status GetFunction(const std::string &name, const Function **function,
+                           const FindOptions &options = FindOptions()) override;
+  absl::Status GetType(const std::string &name, const Type **type,
+                       const FindOptions &options = FindOptions()) override;
+
+ private:
+  friend absl::Status WriteSchema(absl::string_view dump,
+                                  const std::string &filename);
+
+  // Parts of the mapped file.
+  struct TableEntry;
+  struct ColumnEntry;
+
+  // Returns the table named <name> in the schema file, or null.
+  const TableEntry *FindEntry(absl::string_view name) const;
+
+  // Returns the string at <offset> of the string section.
+  absl::string_view String(uint32_t offset, uint32_t size) const;
+
+  void *data_ = nullptr;
+  size_t size_ = 0;
+  uint64_t fingerprint_ = 0;
+  std::string filename_;
+  std::string stamp_;
+  uint32_t table_count_ = 0;
+  uint32_t column_count_ = 0;
+  const TableEntry *tables_ = nullptr;
+  const ColumnEntry *columns_ = nullptr;
+  const char *strings_ = nullptr;
+
+  AnalyzerOptions analyzer_options_;
+  TypeFactory type_factory_;
+  // Builtin functions and types.
+  SimpleCatalog builtins_;
+
+  // ZetaSQL tables of the used entries. Tables are never removed, so
+  // pointers to them stay valid.
+  absl::Mutex mutex_;
+  absl::flat_hash_map<const TableEntry *, std::unique_ptr<const Table>>
+      used_tables_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_SCHEMA_CATALOG_H_
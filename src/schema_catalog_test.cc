@@ -0,0 +1,110 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/schema_catalog.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/type.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(SchemaCatalogTest, FindTable) {
+  std::string filename = testing::TempDir() + "/schema.bin";
+  ASSERT_TRUE(WriteSchema("table_name,column_name,data_type\n"
+                          "ds.Orders,id,INT64\n"
+                          "ds.Orders,tags,\"ARRAY<STRING>\"\n"
+                          "ds.Users,id,STRING\n"
+                          "ds.orders,total,STRUCT<a NUMERIC, b STRING>\n",
+                          filename)
+                  .ok());
+  SchemaCatalog catalog;
+  ASSERT_TRUE(catalog.Load(filename).ok());
+  EXPECT_EQ(catalog.TableCount(), 2);
+
+  const Table *table = nullptr;
+  ASSERT_TRUE(catalog.FindTable({"DS", "ORDERS"}, &table).ok());
+  ASSERT_EQ(table->NumColumns(), 3);
+  EXPECT_EQ(table->GetColumn(0)->Name(), "id");
+  EXPECT_TRUE(table->GetColumn(0)->GetType()->IsInt64());
+  EXPECT_TRUE(table->GetColumn(1)->GetType()->IsArray());
+  EXPECT_TRUE(table->GetColumn(2)->GetType()->IsStruct());
+
+  // A used table is converted once.
+  const Table *again = nullptr;
+  ASSERT_TRUE(catalog.FindTable({"ds", "Orders"}, &again).ok());
+  EXPECT_EQ(table, again);
+
+  ASSERT_TRUE(catalog.FindTable({"ds", "users"}, &table).ok());
+  EXPECT_TRUE(table->GetColumn(0)->GetType()->IsString());
+  EXPECT_FALSE(catalog.FindTable({"ds", "missing"}, &table).ok());
+  EXPECT_FALSE(catalog.FindTable({"Orders"}, &table).ok());
+}
+
+TEST(SchemaCatalogTest, InvalidDumps) {
+  std::string filename = testing::TempDir() + "/invalid.bin";
+  EXPECT_FALSE(WriteSchema("t,a\n", filename).ok());
+  EXPECT_FALSE(WriteSchema("t,a,NOT_A_TYPE\n", filename).ok());
+  EXPECT_FALSE(WriteSchema("t,a,INT64\nT,A,STRING\n", filename).ok());
+}
+
+TEST(SchemaCatalogTest, InvalidFiles) {
+  SchemaCatalog catalog;
+  EXPECT_FALSE(catalog.Load(testing::TempDir() + "/missing.bin").ok());
+
+  std::string filename = testing::TempDir() + "/garbage.bin";
+  std::ofstream(filename, std::ios::binary) << "not a schema file at all";
+  EXPECT_FALSE(catalog.Load(filename).ok());
+
+  std::shared_ptr<SchemaCatalog> shared;
+  EXPECT_FALSE(SchemaCatalog::Shared(filename, &shared).ok());
+  EXPECT_EQ(shared, nullptr);
+}
+
+TEST(SchemaCatalogTest, Shared) {
+  std::string filename = testing::TempDir() + "/shared.bin";
+  ASSERT_TRUE(WriteSchema("t,a,INT64\n", filename).ok());
+  std::shared_ptr<SchemaCatalog> first;
+  std::shared_ptr<SchemaCatalog> second;
+  ASSERT_TRUE(SchemaCatalog::Shared(filename, &first).ok());
+  ASSERT_TRUE(SchemaCatalog::Shared(filename, &second).ok());
+  EXPECT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(first->IsCurrent());
+
+  // A rewritten schema is loaded again.
+  ASSERT_TRUE(WriteSchema("t,a,INT64\nt,b,STRING\n", filename).ok());
+  ASSERT_TRUE(SchemaCatalog::Shared(filename, &second).ok());
+  EXPECT_NE(first, second);
+  EXPECT_NE(first->Fingerprint(), second->Fingerprint());
+  EXPECT_FALSE(first->IsCurrent());
+  EXPECT_TRUE(second->IsCurrent());
+  const Table *table = nullptr;
+  ASSERT_TRUE(second->FindTable({"t"}, &table).ok());
+  EXPECT_EQ(table->NumColumns(), 2);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
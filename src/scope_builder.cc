@@ -0,0 +1,181 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/scope_builder.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
+#include "zetasql/parser/parse_tree.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns if <name> is a date part, like DAY in DATE_DIFF(a, b, DAY).
+bool IsDatePart(absl::string_view name) {
+  static const auto *kDateParts = new absl::flat_hash_set<std::string>(
+      {"microsecond", "millisecond", "second", "minute", "hour", "dayofweek",
+       "day", "dayofyear", "week", "isoweek", "month", "quarter", "year",
+       "isoyear", "date", "datetime", "time"});
+  return kDateParts->contains(absl::AsciiStrToLower(name));
+}
+
+// Returns if the path expression <path> names a column.
+bool IsColumnReference(const ASTPathExpression *path) {
+  const ASTNode *parent = path->parent();
+  if (parent == nullptr) return false;
+  switch (parent->node_kind()) {
+    case AST_TABLE_PATH_EXPRESSION:
+    case AST_TVF:
+    case AST_SIMPLE_TYPE:
+    case AST_DOT_STAR:
+    case AST_DOT_STAR_WITH_MODIFIERS:
+      return false;
+    case AST_FUNCTION_CALL:
+    case AST_EXTRACT_EXPRESSION:
+      // The first child is the name of the function, or the date part of
+      // EXTRACT.
+      if (parent->child(0) == path) return false;
+      return path->num_names() > 1 ||
+             !IsDatePart(path->first_name()->GetAsString());
+    default:
+      return true;
+  }
+}
+
+void AddTable(const std::string &name, const ASTNode *table,
+              QueryScope *scope) {
+  scope->tables.push_back({name, table});
+  scope->table_names.insert(absl::AsciiStrToLower(name));
+}
+
+// Adds the tables of <from_clause> to <scope>. Only the nodes of the join
+// tree are visited, not the expressions and subqueries in it.
+void AddTables(const ASTFromClause *from_clause, QueryScope *scope) {
+  std::vector<const ASTNode *> stack = {from_clause->table_expression()};
+  while (!stack.empty()) {
+    const ASTNode *table = stack.back();
+    stack.pop_back();
+    if (table == nullptr) continue;
+    switch (table->node_kind()) {
+      case AST_JOIN: {
+        const auto *join = table->GetAs<ASTJoin>();
+        scope->has_join = true;
+        // Right side first, so tables are added in the order they are
+        // written.
+        stack.push_back(join->rhs());
+        stack.push_back(join->lhs());
+        if (join->using_clause() != nullptr)
+          for (const ASTIdentifier *key : join->using_clause()->keys())
+            scope->using_columns.insert(
+                absl::AsciiStrToLower(key->GetAsString()));
+        break;
+      }
+      case AST_PARENTHESIZED_JOIN:
+        stack.push_back(table->GetAs<ASTParenthesizedJoin>()->join());
+        break;
+      case AST_TABLE_PATH_EXPRESSION: {
+        const auto *path = table->GetAs<ASTTablePathExpression>();
+        if (path->alias() != nullptr)
+          AddTable(path->alias()->GetAsString(), table, scope);
+        else if (path->path_expr() != nullptr)
+          AddTable(path->path_expr()->last_name()->GetAsString(), table,
+                   scope);
+        break;
+      }
+      case AST_TABLE_SUBQUERY: {
+        const auto *subquery = table->GetAs<ASTTableSubquery>();
+        if (subquery->alias() != nullptr)
+          AddTable(subquery->alias()->GetAsString(), table, scope);
+        break;
+      }
+      case AST_TVF: {
+        const auto *tvf = table->GetAs<ASTTVF>();
+        if (tvf->alias() != nullptr)
+          AddTable(tvf->alias()->GetAsString(), table, scope);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+QueryScopes BuildQueryScopes(const ASTNode *root) {
+  QueryScopes result;
+  // Nodes to visit, with the index of the scope they are in. An explicit
+  // stack doesn't overflow on deep trees, like long UNION ALL chains.
+  std::vector<std::pair<const ASTNode *, int>> stack = {{root, -1}};
+  while (!stack.empty()) {
+    auto [node, scope] = stack.back();
+    stack.pop_back();
+    // A child that is visited with another scope.
+    const ASTNode *skipped = nullptr;
+
+    switch (node->node_kind()) {
+      case AST_SELECT: {
+        const auto *select = node->GetAs<ASTSelect>();
+        QueryScope query;
+        query.select = select;
+        query.parent = scope;
+        if (select->from_clause() != nullptr)
+          AddTables(select->from_clause(), &query);
+        for (const ASTSelectColumn *column : select->select_list()->columns())
+          if (column->alias() != nullptr)
+            query.output_aliases.insert(
+                absl::AsciiStrToLower(column->alias()->GetAsString()));
+        scope = result.scopes.size();
+        result.scopes.push_back(std::move(query));
+
+        // ORDER BY of a query with a single SELECT is in its scope.
+        const ASTNode *parent = node->parent();
+        if (parent != nullptr && parent->node_kind() == AST_QUERY) {
+          const ASTOrderBy *order_by = parent->GetAs<ASTQuery>()->order_by();
+          if (order_by != nullptr) stack.emplace_back(order_by, scope);
+        }
+        break;
+      }
+      case AST_QUERY: {
+        const auto *query = node->GetAs<ASTQuery>();
+        if (query->query_expr()->node_kind() == AST_SELECT)
+          skipped = query->order_by();
+        break;
+      }
+      case AST_PATH_EXPRESSION: {
+        const auto *path = node->GetAs<ASTPathExpression>();
+        if (scope >= 0 && IsColumnReference(path))
+          result.columns.push_back({path, scope});
+        // Identifiers of the path don't need to be visited.
+        continue;
+      }
+      default:
+        break;
+    }
+
+    for (int i = node->num_children() - 1; i >= 0; --i)
+      if (node->child(i) != skipped) stack.emplace_back(node->child(i), scope);
+  }
+  return result;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,83 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_SCOPE_BUILDER_H_
+#define SRC_SCOPE_BUILDER_H_
+
+// Scopes of the query blocks of a statement. Every SELECT is a query block,
+// and its scope is the set of tables and aliases in its FROM clause that
+// columns can be qualified with. Scopes and the column references in them
+// are built in a single walk of the syntax tree, so checks about names of a
+// query don't search the tree again for every column.
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/parser/parse_tree.h"
+
+namespace zetasql::linter {
+
+// A table of a FROM clause, as it is named by columns of the query.
+struct RangeVariable {
+  // Alias of the table, or the last name of its path if it doesn't have one.
+  std::string name;
+  // The table path, subquery or table valued function.
+  const ASTNode *table;
+};
+
+// Scope of a single SELECT.
+struct QueryScope {
+  const ASTSelect *select = nullptr;
+  // Index of the scope of the enclosing query block, or -1.
+  int parent = -1;
+  // True if the FROM clause joins more than one table.
+  bool has_join = false;
+  // Tables of the FROM clause, in the order they are written.
+  std::vector<RangeVariable> tables;
+  // Lowercase names of 'tables', of the columns of USING clauses and of the
+  // aliases of the select list. Names are case insensitive.
+  absl::flat_hash_set<std::string> table_names;
+  absl::flat_hash_set<std::string> using_columns;
+  absl::flat_hash_set<std::string> output_aliases;
+};
+
+// A path expression naming a column, like 'a' or 't.a'.
+struct ColumnReference {
+  const ASTPathExpression *path;
+  // Index of the scope of the query block the column is in.
+  int scope;
+};
+
+struct QueryScopes {
+  // Scopes of all SELECTs of a statement. Enclosing scopes come first.
+  std::vector<QueryScope> scopes;
+  // Column references in SELECTs, in no particular order. Names of tables,
+  // functions and types, and date parts like DAY in DATE_DIFF(a, b, DAY),
+  // are not column references.
+  std::vector<ColumnReference> columns;
+};
+
+// Builds the scopes of the query blocks of the syntax tree <root>. Nodes are
+// visited at most twice, so it is linear in the size of the tree even for
+// statements with hundreds of UNION ALL branches or joins.
+QueryScopes BuildQueryScopes(const ASTNode *root);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_SCOPE_BUILDER_H_
@@ -0,0 +1,108 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/scope_builder.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "zetasql/parser/parser.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+// Returns the full names of the columns of <scope>, sorted.
+std::vector<std::string> ColumnNames(const QueryScopes &scopes, int scope) {
+  std::vector<std::string> names;
+  for (const ColumnReference &column : scopes.columns)
+    if (column.scope == scope)
+      names.push_back(column.path->ToIdentifierPathString());
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+TEST(ScopeBuilderTest, TablesAndAliases) {
+  std::unique_ptr<ParserOutput> output;
+  ASSERT_TRUE(ParseStatement("SELECT a.x, y AS Z FROM ds.a "
+                             "JOIN (SELECT w FROM c) AS b USING (k) "
+                             "ORDER BY z;",
+                             ParserOptions(), &output)
+                  .ok());
+  QueryScopes scopes = BuildQueryScopes(output->statement());
+  ASSERT_EQ(scopes.scopes.size(), 2);
+
+  const QueryScope &outer = scopes.scopes[0];
+  EXPECT_EQ(outer.parent, -1);
+  EXPECT_TRUE(outer.has_join);
+  ASSERT_EQ(outer.tables.size(), 2);
+  EXPECT_EQ(outer.tables[0].name, "a");
+  EXPECT_EQ(outer.tables[1].name, "b");
+  EXPECT_TRUE(outer.using_columns.contains("k"));
+  EXPECT_TRUE(outer.output_aliases.contains("z"));
+  // ORDER BY is in the scope of its SELECT.
+  EXPECT_EQ(ColumnNames(scopes, 0),
+            std::vector<std::string>({"a.x", "y", "z"}));
+
+  const QueryScope &inner = scopes.scopes[1];
+  EXPECT_EQ(inner.parent, 0);
+  EXPECT_FALSE(inner.has_join);
+  EXPECT_TRUE(inner.table_names.contains("c"));
+  EXPECT_EQ(ColumnNames(scopes, 1), std::vector<std::string>({"w"}));
+}
+
+TEST(ScopeBuilderTest, ColumnReferences) {
+  std::unique_ptr<ParserOutput> output;
+  ASSERT_TRUE(ParseStatement("SELECT COUNT(*), DATE_DIFF(d, e, DAY), "
+                             "CAST(f AS INT64), t.*, EXTRACT(YEAR FROM g) "
+                             "FROM t;",
+                             ParserOptions(), &output)
+                  .ok());
+  QueryScopes scopes = BuildQueryScopes(output->statement());
+  EXPECT_EQ(ColumnNames(scopes, 0),
+            std::vector<std::string>({"d", "e", "f", "g"}));
+
+  // Names outside of queries are not columns.
+  ASSERT_TRUE(ParseStatement("CREATE TABLE T (a INT64);", ParserOptions(),
+                             &output)
+                  .ok());
+  scopes = BuildQueryScopes(output->statement());
+  EXPECT_TRUE(scopes.scopes.empty());
+  EXPECT_TRUE(scopes.columns.empty());
+}
+
+TEST(ScopeBuilderTest, LongUnion) {
+  std::string sql = "SELECT a FROM t JOIN u ON t.k = u.k";
+  for (int i = 1; i < 300; ++i)
+    sql += " UNION ALL SELECT a FROM t JOIN u ON t.k = u.k";
+  std::unique_ptr<ParserOutput> output;
+  ASSERT_TRUE(ParseStatement(sql, ParserOptions(), &output).ok());
+  QueryScopes scopes = BuildQueryScopes(output->statement());
+  ASSERT_EQ(scopes.scopes.size(), 300);
+  EXPECT_EQ(scopes.columns.size(), 900);
+  for (const QueryScope &scope : scopes.scopes) {
+    EXPECT_TRUE(scope.has_join);
+    EXPECT_EQ(scope.tables.size(), 2);
+  }
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
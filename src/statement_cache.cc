@@ -0,0 +1,279 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/statement_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "src/checks.h"
+#include "src/checks_list.h"
+#include "src/checks_util.h"
+#include "src/config.pb.h"
+#include "src/diff_parser.h"
+#include "src/hash_util.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+#include "src/linter_options.h"
+#include "src/pattern_matcher.h"
+#include "src/statement_splitter.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+static_assert(static_cast<int>(ErrorCode::COUNT) <= 64,
+              "NOLINT state of a part should fit in 64 bits.");
+
+// Returns the position of the first character of <text> that isn't
+// whitespace or in a comment, or -1 if there is none.
+int CodeStart(absl::string_view text) {
+  for (int i = 0; i < static_cast<int>(text.size()); ++i) {
+    if (absl::ascii_isspace(text[i])) continue;
+    absl::string_view rest = text.substr(i);
+    if (absl::StartsWith(rest, "--") || absl::StartsWith(rest, "//") ||
+        rest[0] == '#') {
+      size_t end = text.find('\n', i);
+      if (end == absl::string_view::npos) return -1;
+      i = end;
+    } else if (absl::StartsWith(rest, "/*")) {
+      size_t end = text.find("*/", i + 2);
+      if (end == absl::string_view::npos) return -1;
+      i = end + 1;
+    } else {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns if <text> has anything other than whitespace and comments.
+bool HasCode(absl::string_view text) { return CodeStart(text) >= 0; }
+
+// Returns if a statement of <part> starts or ends a block of a script, so the
+// part can't be parsed without the rest of the block.
+bool IsScriptFragment(absl::string_view part) {
+  static const auto *kBlockKeywords = new absl::flat_hash_set<std::string>(
+      {"BEGIN", "CASE", "ELSE", "ELSEIF", "END", "EXCEPTION", "FOR", "IF",
+       "LOOP", "REPEAT", "UNTIL", "WHEN", "WHILE"});
+  for (const auto &[start, end] : StatementRanges(part)) {
+    absl::string_view statement = part.substr(start, end - start);
+    int code = CodeStart(statement);
+    if (code < 0) continue;
+    int word_end = code;
+    while (word_end < static_cast<int>(statement.size()) &&
+           absl::ascii_isalpha(statement[word_end]))
+      ++word_end;
+    if (kBlockKeywords->contains(absl::AsciiStrToUpper(
+            statement.substr(code, word_end - code))))
+      return true;
+  }
+  return false;
+}
+
+// Returns start positions of the parts of <sql>. A part starts at the start
+// of a line, after the end of a statement and the rest of its line, which can
+// only have whitespace or a line comment.
+std::vector<int> PartStarts(absl::string_view sql) {
+  std::vector<int> starts = {0};
+  for (const auto &[start, end] : StatementRanges(sql)) {
+    size_t newline = sql.find('\n', end);
+    if (newline == absl::string_view::npos) break;
+    absl::string_view rest =
+        absl::StripLeadingAsciiWhitespace(sql.substr(end, newline - end));
+    if (!rest.empty() && !absl::StartsWith(rest, "--") &&
+        !absl::StartsWith(rest, "//") && rest[0] != '#')
+      continue;
+    int next = newline + 1;
+    if (next < static_cast<int>(sql.size()) && next > starts.back())
+      starts.push_back(next);
+  }
+  // Comments after the last statement stay with it, 'CheckSemicolon' looks
+  // for the last statement.
+  if (starts.size() > 1 && !HasCode(sql.substr(starts.back())))
+    starts.pop_back();
+  return starts;
+}
+
+}  // namespace
+
+StatementCache::StatementCache(int max_entries) : entries_(max_entries) {}
+
+LinterResult StatementCache::RunChecks(absl::string_view sql,
+                                       const Config &config,
+                                       uint64_t config_fingerprint,
+                                       absl::string_view filename) {
+  LinterOptions options;
+  GetOptionsFromConfig(config, &options);
+  return Run(sql, options, config_fingerprint, filename, nullptr);
+}
+
+LinterResult StatementCache::RunChecksOnLines(absl::string_view sql,
+                                              const Config &config,
+                                              uint64_t config_fingerprint,
+                                              const LineRanges &lines,
+                                              absl::string_view filename) {
+  LinterOptions options;
+  GetOptionsFromConfig(config, &options);
+  return RunChecksOnLines(sql, options, config_fingerprint, lines, filename);
+}
+
+LinterResult StatementCache::RunChecks(absl::string_view sql,
+                                       const LinterOptions &options,
+                                       uint64_t config_fingerprint,
+                                       absl::string_view filename) {
+  return Run(sql, options, config_fingerprint, filename, nullptr);
+}
+
+LinterResult StatementCache::RunChecksOnLines(absl::string_view sql,
+                                              const LinterOptions &options,
+                                              uint64_t config_fingerprint,
+                                              const LineRanges &lines,
+                                              absl::string_view filename) {
+  LinterResult result =
+      Run(sql, options, config_fingerprint, filename, &lines);
+  result.RemoveErrors([&lines](const LintError &error) {
+    return !ContainsLine(lines, error.GetLineNumber());
+  });
+  return result;
+}
+
+LinterResult StatementCache::Run(absl::string_view sql,
+                                 const LinterOptions &options,
+                                 uint64_t config_fingerprint,
+                                 absl::string_view filename,
+                                 const LineRanges *lines) {
+  // Lines of parts are counted with '\n', other delimiters don't split.
+  if (options.LineDelimeter() != '\n')
+    return linter::RunChecks(sql, options, filename);
+
+  // NOLINT comments are parsed for the whole file, to find the state at the
+  // start of each part. Errors in them are reported from here.
+  LinterOptions file_options = options;
+  file_options.SetFilename(filename);
+  LinterResult result = ParseNoLintComments(sql, &file_options);
+  result.SetFilename(filename);
+
+  std::vector<CommentUse> comments;
+  std::vector<ImportUse> imports;
+  std::vector<int> starts = PartStarts(sql);
+  int line = 0;
+  for (int i = 0; i < static_cast<int>(starts.size()); ++i) {
+    const int start = starts[i];
+    const int end =
+        i + 1 < static_cast<int>(starts.size()) ? starts[i + 1]
+                                               : static_cast<int>(sql.size());
+    absl::string_view part = sql.substr(start, end - start);
+    const int lines_before = line;
+    for (char c : part)
+      if (c == '\n') ++line;
+    // The lines of the part, a last line without a newline included.
+    if (lines != nullptr &&
+        !OverlapsLines(*lines, lines_before + 1,
+                       absl::EndsWith(part, "\n") ? line : line + 1))
+      continue;
+
+    uint64_t active_mask = 0;
+    for (int code = 0; code < static_cast<int>(ErrorCode::COUNT); ++code)
+      if (file_options.IsActive(static_cast<ErrorCode>(code), start))
+        active_mask |= uint64_t{1} << code;
+    uint64_t key = CombineFingerprints(
+        CombineFingerprints(config_fingerprint, Fingerprint64(part)),
+        active_mask);
+
+    std::shared_ptr<const Entry> entry = entries_.Find(key);
+    if (entry == nullptr) {
+      ++misses_;
+      entry = LintPart(part, options, active_mask);
+      // Cached parts are dropped only for scripts, other parts are linted
+      // alone even if one of them can't be parsed.
+      if (entry == nullptr) return linter::RunChecks(sql, options, filename);
+      entries_.Insert(key, entry);
+    } else {
+      ++hits_;
+    }
+
+    for (const Finding &finding : entry->findings) {
+      result.Add(finding.type, finding.line + lines_before, finding.column,
+                 finding.message,
+                 finding.offset < 0 ? -1 : finding.offset + start);
+    }
+    if (lines != nullptr) continue;
+    for (CommentUse use : entry->comments) {
+      use.position += start;
+      comments.push_back(use);
+    }
+    for (ImportUse use : entry->imports) {
+      use.type_end += start;
+      use.name_end += start;
+      imports.push_back(std::move(use));
+    }
+  }
+  // Summaries of skipped parts are not cached, the whole file is scanned
+  // instead. Scanning only tokenizes, it is cheap compared to parsing.
+  if (lines != nullptr) {
+    ScanCommentTypes(sql, file_options, &comments);
+    ScanImports(sql, file_options, &imports);
+  }
+  result.Add(EvaluateCommentTypes(sql, comments));
+  result.Add(EvaluateImports(sql, imports));
+  return result;
+}
+
+std::shared_ptr<const StatementCache::Entry> StatementCache::LintPart(
+    absl::string_view part, const LinterOptions &config_options,
+    uint64_t active_mask) {
+  LinterOptions options = config_options;
+  options.SetFilename("");
+  for (int code = 0; code < static_cast<int>(ErrorCode::COUNT); ++code) {
+    if ((active_mask >> code) & 1)
+      options.EnableCheck(static_cast<ErrorCode>(code));
+    else
+      options.DisableCheck(static_cast<ErrorCode>(code));
+  }
+  // Errors of NOLINT comments are already reported for the whole file.
+  ParseNoLintComments(part, &options);
+
+  LinterResult result = CheckParserSucceeds(part, &options);
+  // A part that can't be parsed keeps its parser error and the findings of
+  // checks that don't need the parser, e.g. while a statement is typed.
+  const bool parsed = options.RememberParser();
+  if (!parsed && IsScriptFragment(part)) return nullptr;
+  options.SetTextMatches(std::make_shared<const std::vector<TextMatch>>(
+      FindTextPatterns(part, options)));
+  ChecksList checks =
+      parsed ? GetStatementLocalChecks() : GetParserIndependentChecks();
+  for (const auto &check : checks.GetList()) result.Add(check(part, options));
+
+  auto entry = std::make_shared<Entry>();
+  for (LintError &error : result.GetErrors()) {
+    auto [line, column] = error.GetPosition();
+    entry->findings.push_back({error.GetType(), line, column, error.GetOffset(),
+                               error.GetErrorMessage()});
+  }
+  ScanCommentTypes(part, options, &entry->comments);
+  ScanImports(part, options, &entry->imports);
+  return entry;
+}
+
+}  // namespace zetasql::linter
@@ -0,0 +1,132 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_STATEMENT_CACHE_H_
+#define SRC_STATEMENT_CACHE_H_
+
+// A cache of lint results of single statements, so that a file where a few
+// statements changed is re-linted by parsing and checking only those.
+//
+// A file is split into parts of whole lines, each ending with one or more
+// statements. The key of a part is the hash of its text, the fingerprint of
+// the configuration and the NOLINT state at the start of the part. Findings
+// are stored relative to the part and moved to its current position on a
+// hit. Checks that compare statements with each other ('CheckCommentType'
+// and 'CheckImports') store a summary of the part instead, and the
+// summaries of all parts are evaluated for each run.
+//
+// When only some lines of a file changed, 'RunChecksOnLines' parses and
+// checks only the parts with those lines.
+//
+// A part that can't be parsed gets its parser error and the findings of the
+// checks that don't need the parser, and other parts are linted as usual. A
+// whole file run would stop at the first parser error instead. Parts of a
+// script, like the statements that start and end a BEGIN/END block, can't be
+// parsed alone and make the whole file linted without the cache.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/checks.h"
+#include "src/config.pb.h"
+#include "src/diff_parser.h"
+#include "src/generational_cache.h"
+#include "src/lint_error.h"
+#include "src/linter_options.h"
+
+namespace zetasql::linter {
+
+class StatementCache {
+ public:
+  // The cache holds at most about <max_entries> parts.
+  explicit StatementCache(int max_entries = 1 << 16);
+
+  StatementCache(const StatementCache &) = delete;
+  StatementCache &operator=(const StatementCache &) = delete;
+
+  // Returns the same result as 'RunChecks(sql, config, filename)', if all
+  // statements can be parsed.
+  // <config_fingerprint> should be 'ConfigFingerprint(config)'. It is safe to
+  // call from multiple threads.
+  LinterResult RunChecks(absl::string_view sql, const Config &config,
+                         uint64_t config_fingerprint,
+                         absl::string_view filename = "");
+
+  // Returns the findings of 'RunChecks' in <lines>. Only the parts with any
+  // of <lines> are parsed and checked, but 'CheckCommentType' and
+  // 'CheckImports' still compare them with the whole file.
+  LinterResult RunChecksOnLines(absl::string_view sql, const Config &config,
+                                uint64_t config_fingerprint,
+                                const LineRanges &lines,
+                                absl::string_view filename = "");
+
+  // Same with the functions above, with <options> already computed from the
+  // configuration, e.g. the options of a 'ResolvedConfig'.
+  LinterResult RunChecks(absl::string_view sql, const LinterOptions &options,
+                         uint64_t config_fingerprint,
+                         absl::string_view filename = "");
+  LinterResult RunChecksOnLines(absl::string_view sql,
+                                const LinterOptions &options,
+                                uint64_t config_fingerprint,
+                                const LineRanges &lines,
+                                absl::string_view filename = "");
+
+  // Returns the number of parts that were found in the cache.
+  int64_t Hits() const { return hits_; }
+
+  // Returns the number of parts that were linted.
+  int64_t Misses() const { return misses_; }
+
+ private:
+  // A finding, with a position relative to the start of its part.
+  struct Finding {
+    ErrorCode type;
+    int line;
+    int column;
+    int offset;
+    std::string message;
+  };
+
+  struct Entry {
+    std::vector<Finding> findings;
+    std::vector<CommentUse> comments;
+    std::vector<ImportUse> imports;
+  };
+
+  // Runs the checks on all parts, or on parts with <lines> if it isn't null.
+  LinterResult Run(absl::string_view sql, const LinterOptions &options,
+                   uint64_t config_fingerprint, absl::string_view filename,
+                   const LineRanges *lines);
+
+  // Lints a part with checks active at its start given by <active_mask>.
+  // Returns nullptr if it is a part of a script that can't be parsed alone.
+  static std::shared_ptr<const Entry> LintPart(absl::string_view part,
+                                               const LinterOptions &options,
+                                               uint64_t active_mask);
+
+  GenerationalCache<Entry> entries_;
+
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_STATEMENT_CACHE_H_
@@ -0,0 +1,174 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/statement_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "src/config.pb.h"
+#include "src/config_resolver.h"
+#include "src/diff_parser.h"
+#include "src/lint_error.h"
+#include "src/linter.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+std::vector<std::pair<ErrorCode, std::pair<int, int>>> Findings(
+    LinterResult result) {
+  result.Sort();
+  std::vector<std::pair<ErrorCode, std::pair<int, int>>> findings;
+  for (const LintError &error : result.GetErrors())
+    findings.emplace_back(error.GetType(), error.GetPosition());
+  return findings;
+}
+
+// Has findings of statement local checks, comment style and import checks
+// across statements and NOLINT comments that cover many statements.
+constexpr absl::string_view kFile =
+    "IMPORT PROTO 'a.proto';\n"
+    "IMPORT MODULE b;\n"
+    "-- First comment style.\n"
+    "SELECT a b FROM T;\n"
+    "# NOLINT(alias)\n"
+    "SELECT a b FROM T; # Inconsistent.\n"
+    "SELECT\n"
+    "  COUNT(1)\n"
+    "FROM T;\n"
+    "IMPORT PROTO 'a.proto';\n"
+    "select 1; SELECT 2;\n"
+    "/* Block\n"
+    "   comment */ SELECT 3;\n"
+    "SELECT 4\n";
+
+TEST(StatementCacheTest, SameResultAsWholeFile) {
+  Config config;
+  StatementCache cache;
+  LinterResult result =
+      cache.RunChecks(kFile, config, ConfigFingerprint(config));
+  EXPECT_EQ(Findings(result), Findings(RunChecks(kFile, config, "")));
+}
+
+TEST(StatementCacheTest, OnlyChangedStatementsAreLinted) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  StatementCache cache;
+  absl::string_view sql =
+      "SELECT a b FROM T;\n"
+      "-- NOLINT(alias)\n"
+      "SELECT a b FROM T;\n"
+      "SELECT\n"
+      "  COUNT(1)\n"
+      "FROM T;\n"
+      "SELECT 1; SELECT 2;\n"
+      "SELECT 3\n";
+  cache.RunChecks(sql, config, fingerprint);
+  int64_t parts = cache.Misses();
+  EXPECT_EQ(parts, 5);
+
+  std::string changed(sql);
+  changed.replace(changed.find("FROM T;\nSELECT 1"), 6, "FROM LongerTable");
+  LinterResult result = cache.RunChecks(changed, config, fingerprint);
+  EXPECT_EQ(cache.Misses(), parts + 1);
+  EXPECT_EQ(cache.Hits(), parts - 1);
+  EXPECT_EQ(Findings(result), Findings(RunChecks(changed, config, "")));
+
+  // Moving statements keeps the findings right.
+  std::string moved = absl::StrCat("SELECT 0;\n\n", sql);
+  result = cache.RunChecks(moved, config, fingerprint);
+  EXPECT_EQ(Findings(result), Findings(RunChecks(moved, config, "")));
+}
+
+TEST(StatementCacheTest, NolintStateIsPartOfTheKey) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  StatementCache cache;
+  absl::string_view sql = "SELECT 1;\nSELECT a b FROM T;\n";
+  absl::string_view disabled =
+      "SELECT 1; -- NOLINT(alias)\nSELECT a b FROM T;\n";
+
+  EXPECT_FALSE(cache.RunChecks(sql, config, fingerprint).ok());
+  EXPECT_TRUE(cache.RunChecks(disabled, config, fingerprint).ok());
+}
+
+TEST(StatementCacheTest, OnlyChangedLinesAreLinted) {
+  Config config;
+  StatementCache cache;
+  // Line 6 has a comment style inconsistent with line 3, line 10 a
+  // duplicate import.
+  LineRanges lines = {{6, 6}, {10, 10}};
+  LinterResult result =
+      cache.RunChecksOnLines(kFile, config, ConfigFingerprint(config), lines);
+  EXPECT_EQ(cache.Misses(), 2);
+
+  LinterResult expected = RunChecks(kFile, config, "");
+  expected.RemoveErrors([&lines](const LintError &error) {
+    return !ContainsLine(lines, error.GetLineNumber());
+  });
+  EXPECT_FALSE(Findings(result).empty());
+  EXPECT_EQ(Findings(result), Findings(expected));
+}
+
+TEST(StatementCacheTest, UnparsedStatementKeepsOtherParts) {
+  Config config;
+  uint64_t fingerprint = ConfigFingerprint(config);
+  StatementCache cache;
+  absl::string_view sql =
+      "SELECT a b FROM T;\n"
+      "SELECT 1;\n"
+      "SELECT 2;\n"
+      "SELECT 3;\n";
+  cache.RunChecks(sql, config, fingerprint);
+  int64_t parts = cache.Misses();
+  EXPECT_EQ(parts, 4);
+
+  // Only the statement being typed is linted again.
+  std::string typing(sql);
+  typing.replace(typing.find("SELECT 2;"), 9, "SELECT 2 FROM;");
+  LinterResult result = cache.RunChecks(typing, config, fingerprint);
+  EXPECT_EQ(cache.Misses() - parts, 1);
+  EXPECT_EQ(cache.Hits(), parts - 1);
+
+  bool parse_failed = false, alias = false;
+  for (const auto &[type, position] : Findings(result)) {
+    if (type == ErrorCode::kParseFailed) parse_failed = position.first == 3;
+    if (type == ErrorCode::kAlias) alias = position.first == 1;
+  }
+  EXPECT_TRUE(parse_failed);
+  EXPECT_TRUE(alias);
+}
+
+TEST(StatementCacheTest, ScriptsAreLintedWhole) {
+  Config config;
+  StatementCache cache;
+  absl::string_view sql =
+      "BEGIN\n"
+      "  SELECT a b FROM T;\n"
+      "  SELECT 1;\n"
+      "END;\n";
+  LinterResult result =
+      cache.RunChecks(sql, config, ConfigFingerprint(config));
+  EXPECT_EQ(Findings(result), Findings(RunChecks(sql, config, "")));
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
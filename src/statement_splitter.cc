@@ -0,0 +1,212 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/statement_splitter.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+bool IsWhitespace(absl::string_view text) {
+  for (char c : text)
+    if (!absl::ascii_isspace(c)) return false;
+  return true;
+}
+
+// Moves a 0-based <line, column> position over 'text'. Columns are counted
+// in characters, UTF-8 continuation bytes don't move it.
+void Advance(absl::string_view text, std::pair<int, int> *position) {
+  for (char c : text) {
+    if (c == '\n') {
+      ++position->first;
+      position->second = 0;
+    } else if ((c & 0xC0) != 0x80) {
+      ++position->second;
+    }
+  }
+}
+
+}  // namespace
+
+bool ScanStatementEnd(absl::string_view text, bool at_end, int *position,
+                      SplitterState *state) {
+  int &i = *position;
+  const int size = static_cast<int>(text.size());
+  // Returns true if <count> characters after 'i' are not available yet.
+  auto need_more = [&](int count) { return !at_end && i + count >= size; };
+
+  while (i < size) {
+    const char c = text[i];
+    switch (*state) {
+      case SplitterState::kCode:
+        if (c == ';') {
+          ++i;
+          return true;
+        }
+        if (c == '\'' || c == '"') {
+          if (need_more(2)) return false;
+          if (i + 2 < size && text[i + 1] == c && text[i + 2] == c) {
+            *state = c == '\'' ? SplitterState::kTripleSingleQuote
+                               : SplitterState::kTripleDoubleQuote;
+            i += 3;
+          } else {
+            *state = c == '\'' ? SplitterState::kSingleQuote
+                               : SplitterState::kDoubleQuote;
+            ++i;
+          }
+        } else if (c == '`') {
+          *state = SplitterState::kBacktick;
+          ++i;
+        } else if (c == '#') {
+          *state = SplitterState::kLineComment;
+          ++i;
+        } else if (c == '-' || c == '/') {
+          if (need_more(1)) return false;
+          char next = i + 1 < size ? text[i + 1] : '\0';
+          if (next == c) {
+            *state = SplitterState::kLineComment;
+            i += 2;
+          } else if (c == '/' && next == '*') {
+            *state = SplitterState::kBlockComment;
+            i += 2;
+          } else {
+            ++i;
+          }
+        } else {
+          ++i;
+        }
+        break;
+
+      case SplitterState::kSingleQuote:
+      case SplitterState::kDoubleQuote:
+      case SplitterState::kBacktick: {
+        const char quote = *state == SplitterState::kSingleQuote   ? '\''
+                           : *state == SplitterState::kDoubleQuote ? '"'
+                                                                   : '`';
+        if (c == '\\') {
+          if (need_more(1)) return false;
+          i += 2;
+        } else {
+          // Only triple quoted strings can continue in the next line.
+          if (c == quote || c == '\n') *state = SplitterState::kCode;
+          ++i;
+        }
+        break;
+      }
+
+      case SplitterState::kTripleSingleQuote:
+      case SplitterState::kTripleDoubleQuote: {
+        const char quote =
+            *state == SplitterState::kTripleSingleQuote ? '\'' : '"';
+        if (c == '\\') {
+          if (need_more(1)) return false;
+          i += 2;
+        } else if (c == quote) {
+          if (need_more(2)) return false;
+          if (i + 2 < size && text[i + 1] == quote && text[i + 2] == quote) {
+            *state = SplitterState::kCode;
+            i += 3;
+          } else {
+            ++i;
+          }
+        } else {
+          ++i;
+        }
+        break;
+      }
+
+      case SplitterState::kLineComment:
+        if (c == '\n') *state = SplitterState::kCode;
+        ++i;
+        break;
+
+      case SplitterState::kBlockComment:
+        if (c == '*') {
+          if (need_more(1)) return false;
+          if (i + 1 < size && text[i + 1] == '/') {
+            *state = SplitterState::kCode;
+            i += 2;
+            break;
+          }
+        }
+        ++i;
+        break;
+    }
+  }
+  // An escape at the very end can step over the end.
+  if (i > size) i = size;
+  return false;
+}
+
+std::vector<std::pair<int, int>> StatementRanges(absl::string_view sql) {
+  std::vector<std::pair<int, int>> ranges;
+  SplitterState state = SplitterState::kCode;
+  int start = 0;
+  int position = 0;
+  while (position < static_cast<int>(sql.size())) {
+    if (!ScanStatementEnd(sql, true, &position, &state)) break;
+    ranges.emplace_back(start, position);
+    start = position;
+  }
+  if (!IsWhitespace(sql.substr(start)))
+    ranges.emplace_back(start, static_cast<int>(sql.size()));
+  return ranges;
+}
+
+void StatementSplitter::Append(absl::string_view text) {
+  buffer_.append(text.data(), text.size());
+}
+
+void StatementSplitter::Finish() { finished_ = true; }
+
+bool StatementSplitter::NextStatement(std::string *statement) {
+  if (ScanStatementEnd(buffer_, finished_, &scanned_, &state_)) {
+    *statement = Consume(scanned_);
+    return true;
+  }
+  if (max_statement_size_ > 0 &&
+      static_cast<int>(buffer_.size()) > max_statement_size_) {
+    *statement = Consume(static_cast<int>(buffer_.size()));
+    state_ = SplitterState::kCode;
+    return true;
+  }
+  if (finished_ && !buffer_.empty()) {
+    bool whitespace = IsWhitespace(buffer_);
+    std::string rest = Consume(static_cast<int>(buffer_.size()));
+    if (whitespace) return false;
+    *statement = std::move(rest);
+    return true;
+  }
+  return false;
+}
+
+std::string StatementSplitter::Consume(int size) {
+  statement_start_ = buffer_start_;
+  std::string statement = buffer_.substr(0, size);
+  Advance(statement, &buffer_start_);
+  buffer_.erase(0, size);
+  scanned_ = 0;
+  return statement;
+}
+
+}  // namespace zetasql::linter
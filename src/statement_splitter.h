@@ -0,0 +1,99 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_STATEMENT_SPLITTER_H_
+#define SRC_STATEMENT_SPLITTER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Lexical state of the statement splitter.
+enum class SplitterState {
+  kCode,
+  kSingleQuote,
+  kDoubleQuote,
+  kTripleSingleQuote,
+  kTripleDoubleQuote,
+  kBacktick,
+  kLineComment,
+  kBlockComment,
+};
+
+// Scans 'text' from *position in lexical state *state, and stops just after
+// the first semicolon that ends a statement. Returns true if such a semicolon
+// is found. Otherwise stops at the first position where more text is
+// needed to decide (only if <at_end> is false) or at the end of text.
+bool ScanStatementEnd(absl::string_view text, bool at_end, int *position,
+                      SplitterState *state);
+
+// Returns [start, end) byte ranges of all statements in a complete sql text.
+// Whitespace after the last statement isn't returned as a statement.
+std::vector<std::pair<int, int>> StatementRanges(absl::string_view sql);
+
+// Splits sql text into statements, without parsing it. A statement ends with
+// a semicolon(';') that is not inside of a string literal, a quoted
+// identifier or a comment.
+//
+// The text can be given in arbitrary pieces with 'Append', and statements
+// are returned as soon as their semicolon arrives. Only the unfinished
+// statement is kept in memory, so memory usage doesn't depend on the
+// length of the stream.
+class StatementSplitter {
+ public:
+  // A statement longer than <max_statement_size> bytes is returned without
+  // waiting for its semicolon, so that a missing semicolon can't make the
+  // buffer grow forever. Non-positive values mean no limit.
+  explicit StatementSplitter(int max_statement_size = 16 << 20)
+      : max_statement_size_(max_statement_size) {}
+
+  // Adds more text to the end of the stream.
+  void Append(absl::string_view text);
+
+  // Sets 'statement' to the next complete statement, including its
+  // semicolon. Returns false if there is no complete statement yet.
+  bool NextStatement(std::string *statement);
+
+  // Marks the end of the stream. The remaining text will be returned by
+  // 'NextStatement' as the last statement, unless it is only whitespace.
+  void Finish();
+
+  // Position of the first character of the last returned statement in the
+  // whole stream, as 0-based <line, column>.
+  std::pair<int, int> StatementStart() const { return statement_start_; }
+
+ private:
+  // Removes the first <size> characters of the buffer and returns them.
+  std::string Consume(int size);
+
+  std::string buffer_;
+  int scanned_ = 0;
+  SplitterState state_ = SplitterState::kCode;
+  bool finished_ = false;
+  const int max_statement_size_;
+
+  // Position of buffer_[0] in the whole stream.
+  std::pair<int, int> buffer_start_ = {0, 0};
+  std::pair<int, int> statement_start_ = {0, 0};
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_STATEMENT_SPLITTER_H_
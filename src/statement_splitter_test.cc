@@ -0,0 +1,98 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/statement_splitter.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+std::vector<std::string> Split(absl::string_view sql) {
+  std::vector<std::string> statements;
+  for (auto [start, end] : StatementRanges(sql))
+    statements.emplace_back(sql.substr(start, end - start));
+  return statements;
+}
+
+TEST(StatementSplitterTest, IgnoresSemicolonsInStringsAndComments) {
+  EXPECT_EQ(Split("SELECT 1;SELECT 2;"),
+            std::vector<std::string>({"SELECT 1;", "SELECT 2;"}));
+  EXPECT_EQ(Split("SELECT ';', \";\", `a;b`;\n"),
+            std::vector<std::string>({"SELECT ';', \";\", `a;b`;"}));
+  EXPECT_EQ(Split("SELECT 'it\\'s;';"),
+            std::vector<std::string>({"SELECT 'it\\'s;';"}));
+  EXPECT_EQ(Split("SELECT '''a;\n'';b''';"),
+            std::vector<std::string>({"SELECT '''a;\n'';b''';"}));
+  absl::string_view comments = "-- a;\n# b;\n// c;\n/* d;\n*/SELECT 1;";
+  EXPECT_EQ(Split(comments), std::vector<std::string>({std::string(comments)}));
+  EXPECT_EQ(Split("SELECT 1 - 2 / 3;SELECT 4"),
+            std::vector<std::string>({"SELECT 1 - 2 / 3;", "SELECT 4"}));
+  EXPECT_EQ(Split("SELECT 1;\n  \n"), std::vector<std::string>({"SELECT 1;"}));
+  EXPECT_EQ(Split("SELECT 1; -- end\n"),
+            std::vector<std::string>({"SELECT 1;", " -- end\n"}));
+}
+
+TEST(StatementSplitterTest, Incremental) {
+  absl::string_view stream =
+      "SELECT 'a;b';\nSELECT \"\"\"x;\n\"\"\"; /* ; */ SELECT 3;\nSELECT 4";
+  // Feeding one character at a time should give the same result with
+  // feeding the whole stream at once.
+  StatementSplitter splitter;
+  std::vector<std::string> statements;
+  std::vector<std::pair<int, int>> starts;
+  std::string statement;
+  for (char c : stream) {
+    splitter.Append(absl::string_view(&c, 1));
+    while (splitter.NextStatement(&statement)) {
+      statements.push_back(statement);
+      starts.push_back(splitter.StatementStart());
+    }
+  }
+  EXPECT_EQ(statements.size(), 3);
+  splitter.Finish();
+  EXPECT_TRUE(splitter.NextStatement(&statement));
+  statements.push_back(statement);
+  starts.push_back(splitter.StatementStart());
+  EXPECT_FALSE(splitter.NextStatement(&statement));
+
+  EXPECT_EQ(statements, std::vector<std::string>(
+                            {"SELECT 'a;b';", "\nSELECT \"\"\"x;\n\"\"\";",
+                             " /* ; */ SELECT 3;", "\nSELECT 4"}));
+  std::vector<std::pair<int, int>> expected_starts = {
+      {0, 0}, {0, 13}, {2, 4}, {2, 22}};
+  EXPECT_EQ(starts, expected_starts);
+}
+
+TEST(StatementSplitterTest, BoundedBuffer) {
+  StatementSplitter splitter(10);
+  std::string statement;
+  splitter.Append("SELECT 'unterminated string");
+  EXPECT_TRUE(splitter.NextStatement(&statement));
+  EXPECT_EQ(statement, "SELECT 'unterminated string");
+  splitter.Append("\nSELECT 1;");
+  EXPECT_TRUE(splitter.NextStatement(&statement));
+  EXPECT_EQ(statement, "\nSELECT 1;");
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,88 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/thread_pool.h"
+
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql::linter {
+
+ThreadPool::ThreadPool(int num_threads, int max_queue_size)
+    : max_queue_size_(max_queue_size) {
+  if (num_threads < 1) num_threads = 1;
+  for (int i = 0; i < num_threads; ++i)
+    workers_.emplace_back([this]() { WorkerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+  }
+  for (std::thread &worker : workers_) worker.join();
+}
+
+void ThreadPool::Schedule(std::function<void()> task) {
+  absl::MutexLock lock(&mutex_);
+  if (max_queue_size_ > 0) {
+    auto has_space = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+      return static_cast<int>(queue_.size()) < max_queue_size_;
+    };
+    mutex_.Await(absl::Condition(&has_space));
+  }
+  queue_.push_back(std::move(task));
+}
+
+void ThreadPool::Wait() {
+  absl::MutexLock lock(&mutex_);
+  auto idle = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return queue_.empty() && running_ == 0;
+  };
+  mutex_.Await(absl::Condition(&idle));
+}
+
+int ThreadPool::DefaultThreadCount() {
+  int count = static_cast<int>(std::thread::hardware_concurrency());
+  return count > 0 ? count : 1;
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock lock(&mutex_);
+      // Workers leave only after the queue is drained, so destroying
+      // the pool never drops scheduled tasks.
+      auto has_work = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return !queue_.empty() || (stopping_ && running_ == 0);
+      };
+      mutex_.Await(absl::Condition(&has_work));
+      if (queue_.empty()) return;
+      task = std::move(queue_.front());
+      queue_.pop_front();
+      ++running_;
+    }
+    task();
+    absl::MutexLock lock(&mutex_);
+    --running_;
+  }
+}
+
+}  // namespace zetasql::linter
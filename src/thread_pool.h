@@ -0,0 +1,67 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_THREAD_POOL_H_
+#define SRC_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql::linter {
+
+// A fixed size pool of worker threads running scheduled tasks in
+// FIFO order. Tasks can schedule other tasks.
+class ThreadPool {
+ public:
+  // Starts <num_threads> workers. If <max_queue_size> is positive, 'Schedule'
+  // blocks while that many tasks are waiting, which bounds the memory used
+  // by producers that are faster than the workers. Tasks that schedule other
+  // tasks should only be used with an unbounded queue.
+  explicit ThreadPool(int num_threads, int max_queue_size = 0);
+
+  // Waits for all scheduled tasks and stops the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Adds a task to the queue.
+  void Schedule(std::function<void()> task);
+
+  // Blocks until the queue is empty and no task is running.
+  void Wait();
+
+  // Returns a reasonable default number of workers for this machine.
+  static int DefaultThreadCount();
+
+ private:
+  void WorkerLoop();
+
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  int running_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  const int max_queue_size_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_THREAD_POOL_H_
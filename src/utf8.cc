@@ -0,0 +1,175 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/utf8.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "absl/strings/string_view.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr int kBlockSize = 64;
+
+// Masks of the 64 bytes at <data>. Bit i of 'non_ascii' is set if data[i] is
+// not ASCII, and bit i of 'continuation' if it is in [0x80, 0xBF].
+struct BlockMasks {
+  uint64_t non_ascii;
+  uint64_t continuation;
+};
+
+#ifdef __SSE2__
+
+BlockMasks ClassifyBlock(const char *data) {
+  // Continuation bytes are the signed bytes below -64.
+  const __m128i limit = _mm_set1_epi8(-64);
+  BlockMasks masks = {0, 0};
+  for (int b = 0; b < 4; ++b) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + b);
+    masks.non_ascii |=
+        static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(block)))
+        << (16 * b);
+    masks.continuation |= static_cast<uint64_t>(static_cast<uint16_t>(
+                              _mm_movemask_epi8(_mm_cmplt_epi8(block, limit))))
+                          << (16 * b);
+  }
+  return masks;
+}
+
+#else
+
+BlockMasks ClassifyBlock(const char *data) {
+  BlockMasks masks = {0, 0};
+  for (int i = 0; i < kBlockSize; ++i) {
+    const unsigned char c = data[i];
+    if (c >= 0x80) masks.non_ascii |= uint64_t{1} << i;
+    if ((c & 0xC0) == 0x80) masks.continuation |= uint64_t{1} << i;
+  }
+  return masks;
+}
+
+#endif
+
+// Returns if a block is ASCII by testing the high bit of 8 bytes at a time.
+bool IsAsciiBlock(const char *data) {
+  uint64_t bits = 0;
+  for (int i = 0; i < kBlockSize; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    bits |= word;
+  }
+  return (bits & 0x8080808080808080) == 0;
+}
+
+bool IsContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+// Returns the length of the well-formed UTF-8 sequence at <position> of
+// <text>, which starts with a non-ASCII byte, or 0 if it is malformed.
+int SequenceLength(absl::string_view text, int position) {
+  const unsigned char lead = text[position];
+  int length;
+  // Bounds of the second byte, which exclude overlong encodings, surrogates
+  // and code points above U+10FFFF.
+  unsigned char low = 0x80, high = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    if (lead == 0xE0) low = 0xA0;
+    if (lead == 0xED) high = 0x9F;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    if (lead == 0xF0) low = 0x90;
+    if (lead == 0xF4) high = 0x8F;
+  } else {
+    return 0;
+  }
+  if (position + length > static_cast<int>(text.size())) return 0;
+  const unsigned char second = text[position + 1];
+  if (second < low || second > high) return 0;
+  for (int i = 2; i < length; ++i)
+    if (!IsContinuation(text[position + i])) return 0;
+  return length;
+}
+
+}  // namespace
+
+bool IsAscii(absl::string_view text) {
+  const int size = text.size();
+  int i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize)
+    if (!IsAsciiBlock(text.data() + i)) return false;
+  for (; i < size; ++i)
+    if (static_cast<unsigned char>(text[i]) >= 0x80) return false;
+  return true;
+}
+
+int FindInvalidUtf8(absl::string_view text) {
+  const int size = text.size();
+  int i = 0;
+  while (i < size) {
+    if (i + kBlockSize <= size) {
+      const uint64_t non_ascii = ClassifyBlock(text.data() + i).non_ascii;
+      if (non_ascii == 0) {
+        i += kBlockSize;
+        continue;
+      }
+      i += __builtin_ctzll(non_ascii);
+    } else if (static_cast<unsigned char>(text[i]) < 0x80) {
+      ++i;
+      continue;
+    }
+    const int length = SequenceLength(text, i);
+    if (length == 0) return i;
+    i += length;
+  }
+  return -1;
+}
+
+int CountCharacters(absl::string_view text) {
+  const int size = text.size();
+  int count = 0;
+  int i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize) {
+    const BlockMasks masks = ClassifyBlock(text.data() + i);
+    count += kBlockSize;
+    if (masks.non_ascii != 0) count -= __builtin_popcountll(masks.continuation);
+  }
+  for (; i < size; ++i)
+    if (!IsContinuation(text[i])) ++count;
+  return count;
+}
+
+int DisplayColumn(absl::string_view line_prefix, int tab_width) {
+  int column = 1;
+  for (char c : line_prefix) {
+    if (c == '\t')
+      column += tab_width - (column - 1) % tab_width;
+    else if (!IsContinuation(c))
+      ++column;
+  }
+  return column;
+}
+
+}  // namespace zetasql::linter
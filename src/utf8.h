@@ -0,0 +1,51 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef SRC_UTF8_H_
+#define SRC_UTF8_H_
+
+// UTF-8 handling of sql text. Lines are measured and columns are counted in
+// characters instead of bytes, so non-ASCII identifiers and comments don't
+// make lines look longer than they are.
+//
+// Most sql files are ASCII, so every function skips ASCII blocks of 64 bytes
+// with a single vector compare and only decodes blocks that have other bytes.
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Returns if every byte of <text> is ASCII.
+bool IsAscii(absl::string_view text);
+
+// Returns the position of the first byte of <text> that doesn't start a
+// well-formed UTF-8 sequence, or -1 if <text> is valid UTF-8. Overlong
+// encodings, surrogates and code points above U+10FFFF are malformed.
+int FindInvalidUtf8(absl::string_view text);
+
+// Returns the number of characters in <text>, i.e. the number of bytes that
+// aren't UTF-8 continuation bytes.
+int CountCharacters(absl::string_view text);
+
+// Returns the 1-based column of the character after <line_prefix>, which is
+// the text from the start of a line. Tabs are expanded to multiples of
+// <tab_width>, same with ZetaSQL error locations.
+int DisplayColumn(absl::string_view line_prefix, int tab_width = 8);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_UTF8_H_
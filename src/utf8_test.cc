@@ -0,0 +1,87 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "src/utf8.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(Utf8Test, IsAscii) {
+  EXPECT_TRUE(IsAscii(""));
+  EXPECT_TRUE(IsAscii(std::string(200, 'a')));
+  EXPECT_FALSE(IsAscii("SELECT 'é';"));
+
+  // Non-ASCII bytes in the middle of a block and in the tail.
+  std::string text(130, 'a');
+  text[70] = '\xC3';
+  EXPECT_FALSE(IsAscii(text));
+  EXPECT_TRUE(IsAscii(absl::string_view(text).substr(0, 70)));
+  EXPECT_FALSE(IsAscii(absl::string_view(text).substr(64)));
+}
+
+TEST(Utf8Test, FindInvalidUtf8) {
+  EXPECT_EQ(FindInvalidUtf8(""), -1);
+  EXPECT_EQ(FindInvalidUtf8("SELECT 1;"), -1);
+  EXPECT_EQ(FindInvalidUtf8("-- ünïcödé, 日本語, 🙂"), -1);
+
+  EXPECT_EQ(FindInvalidUtf8("ab\xE9"), 2);          // Latin-1.
+  EXPECT_EQ(FindInvalidUtf8("a\x80"), 1);           // Lone continuation.
+  EXPECT_EQ(FindInvalidUtf8("\xC3"), 0);            // Truncated.
+  EXPECT_EQ(FindInvalidUtf8("\xC0\xAF"), 0);        // Overlong.
+  EXPECT_EQ(FindInvalidUtf8("\xE0\x80\xAF"), 0);    // Overlong.
+  EXPECT_EQ(FindInvalidUtf8("\xED\xA0\x80"), 0);    // Surrogate.
+  EXPECT_EQ(FindInvalidUtf8("\xF4\x90\x80\x80"), 0);  // Above U+10FFFF.
+  EXPECT_EQ(FindInvalidUtf8("\xE2\x82\xACx\xFF"), 4);
+
+  // Sequences crossing block boundaries.
+  std::string text(63, 'a');
+  text += "日本";
+  text += std::string(70, 'b');
+  EXPECT_EQ(FindInvalidUtf8(text), -1);
+  text[130] = '\xFE';
+  EXPECT_EQ(FindInvalidUtf8(text), 130);
+}
+
+TEST(Utf8Test, CountCharacters) {
+  EXPECT_EQ(CountCharacters(""), 0);
+  EXPECT_EQ(CountCharacters("abc"), 3);
+  EXPECT_EQ(CountCharacters("café"), 4);
+  EXPECT_EQ(CountCharacters("日本語🙂"), 4);
+
+  std::string text;
+  for (int i = 0; i < 50; ++i) text += "aé日";
+  EXPECT_EQ(CountCharacters(text), 150);
+  EXPECT_EQ(CountCharacters(std::string(100, 'x')), 100);
+}
+
+TEST(Utf8Test, DisplayColumn) {
+  EXPECT_EQ(DisplayColumn(""), 1);
+  EXPECT_EQ(DisplayColumn("abc"), 4);
+  EXPECT_EQ(DisplayColumn("SELECT 'é"), 10);
+  EXPECT_EQ(DisplayColumn("\t"), 9);
+  EXPECT_EQ(DisplayColumn("é\t"), 9);
+  EXPECT_EQ(DisplayColumn("ab\t", 4), 5);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter
@@ -0,0 +1,220 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/wire_format.h"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "src/json_util.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+constexpr int kHeaderSize = 4;
+
+// Reads exactly <size> bytes. Sets <eof> if the stream ends before the first
+// byte.
+absl::Status ReadFully(int fd, char *data, size_t size, bool *eof) {
+  size_t done = 0;
+  *eof = false;
+  while (done < size) {
+    ssize_t count = recv(fd, data + done, size - done, 0);
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return absl::DeadlineExceededError("Connection timed out.");
+    if (count < 0)
+      return absl::UnavailableError(
+          absl::StrCat("Read failed: ", std::strerror(errno)));
+    if (count == 0) {
+      *eof = done == 0;
+      return absl::DataLossError("Connection closed inside a frame.");
+    }
+    done += count;
+  }
+  return absl::OkStatus();
+}
+
+// Returns the string member <key> of <object>, or an empty string.
+std::string StringMember(const JsonValue &object, absl::string_view key) {
+  const JsonValue *value = object.Find(key);
+  if (value == nullptr || !value->IsString()) return "";
+  return value->String();
+}
+
+int IntMember(const JsonValue &object, absl::string_view key) {
+  const JsonValue *value = object.Find(key);
+  if (value == nullptr) return 0;
+  return static_cast<int>(value->Number());
+}
+
+// Returns the array member <key> of <object>, or nullptr.
+const std::vector<JsonValue> *ArrayMember(const JsonValue &object,
+                                          absl::string_view key) {
+  const JsonValue *value = object.Find(key);
+  if (value == nullptr || !value->IsArray()) return nullptr;
+  return &value->Elements();
+}
+
+}  // namespace
+
+void AppendFrame(absl::string_view payload, std::string *out) {
+  uint32_t size = payload.size();
+  for (int i = 0; i < kHeaderSize; ++i)
+    out->push_back(static_cast<char>(size >> (8 * i)));
+  out->append(payload.data(), payload.size());
+}
+
+absl::Status WriteFrame(int fd, absl::string_view payload) {
+  if (payload.size() > kMaxFrameSize)
+    return absl::InvalidArgumentError("Frame is too large.");
+  std::string frame;
+  frame.reserve(kHeaderSize + payload.size());
+  AppendFrame(payload, &frame);
+  size_t done = 0;
+  while (done < frame.size()) {
+    // The peer can close the connection at any time, which shouldn't kill
+    // the writer with SIGPIPE.
+    ssize_t count =
+        send(fd, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0)
+      return absl::UnavailableError(
+          absl::StrCat("Write failed: ", std::strerror(errno)));
+    done += count;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ReadFrame(int fd, std::string *payload) {
+  unsigned char header[kHeaderSize];
+  bool eof = false;
+  absl::Status status =
+      ReadFully(fd, reinterpret_cast<char *>(header), kHeaderSize, &eof);
+  if (eof) return absl::OutOfRangeError("End of stream.");
+  if (!status.ok()) return status;
+  uint32_t size = 0;
+  for (int i = kHeaderSize - 1; i >= 0; --i) size = (size << 8) | header[i];
+  if (size > kMaxFrameSize)
+    return absl::InvalidArgumentError(
+        absl::StrCat("Frame of ", size, " bytes is too large."));
+  payload->resize(size);
+  status = ReadFully(fd, payload->data(), size, &eof);
+  return status;
+}
+
+std::string EncodeRequest(const LintRequest &request) {
+  std::string out = "{\"config\": ";
+  AppendJsonString(request.config, &out);
+  out += ", \"files\": [";
+  for (int i = 0; i < static_cast<int>(request.files.size()); ++i) {
+    if (i > 0) out += ", ";
+    out += "{\"name\": ";
+    AppendJsonString(request.files[i].name, &out);
+    out += ", \"content\": ";
+    AppendJsonString(request.files[i].content, &out);
+    out += "}";
+  }
+  out += "]}";
+  return out;
+}
+
+absl::Status DecodeRequest(absl::string_view payload, LintRequest *request) {
+  JsonValue value;
+  absl::Status status = ParseJson(payload, &value);
+  if (!status.ok()) return status;
+  const std::vector<JsonValue> *files =
+      value.IsObject() ? ArrayMember(value, "files") : nullptr;
+  if (files == nullptr)
+    return absl::InvalidArgumentError("Request doesn't have a 'files' array.");
+  *request = LintRequest();
+  request->config = StringMember(value, "config");
+  for (const JsonValue &file : *files) {
+    if (!file.IsObject())
+      return absl::InvalidArgumentError("Request file isn't an object.");
+    request->files.push_back(
+        {StringMember(file, "name"), StringMember(file, "content")});
+  }
+  return absl::OkStatus();
+}
+
+std::string EncodeResponse(const LintResponse &response) {
+  std::string out = "{\"error\": ";
+  AppendJsonString(response.error, &out);
+  out += ", \"files\": [";
+  for (int i = 0; i < static_cast<int>(response.files.size()); ++i) {
+    const LintResponseFile &file = response.files[i];
+    if (i > 0) out += ", ";
+    out += "{\"name\": ";
+    AppendJsonString(file.name, &out);
+    out += ", \"findings\": [";
+    for (int j = 0; j < static_cast<int>(file.findings.size()); ++j) {
+      const LintFinding &finding = file.findings[j];
+      if (j > 0) out += ", ";
+      out += "{\"check\": ";
+      AppendJsonString(finding.check, &out);
+      absl::StrAppend(&out, ", \"line\": ", finding.line,
+                      ", \"column\": ", finding.column, ", \"message\": ");
+      AppendJsonString(finding.message, &out);
+      out += "}";
+    }
+    out += "]}";
+  }
+  out += "]}";
+  return out;
+}
+
+absl::Status DecodeResponse(absl::string_view payload,
+                            LintResponse *response) {
+  JsonValue value;
+  absl::Status status = ParseJson(payload, &value);
+  if (!status.ok()) return status;
+  const std::vector<JsonValue> *files =
+      value.IsObject() ? ArrayMember(value, "files") : nullptr;
+  if (files == nullptr)
+    return absl::InvalidArgumentError(
+        "Response doesn't have a 'files' array.");
+  *response = LintResponse();
+  response->error = StringMember(value, "error");
+  for (const JsonValue &file : *files) {
+    const std::vector<JsonValue> *findings =
+        file.IsObject() ? ArrayMember(file, "findings") : nullptr;
+    if (findings == nullptr)
+      return absl::InvalidArgumentError(
+          "Response file doesn't have a 'findings' array.");
+    LintResponseFile &out = response->files.emplace_back();
+    out.name = StringMember(file, "name");
+    for (const JsonValue &finding : *findings) {
+      out.findings.push_back(
+          {StringMember(finding, "check"), IntMember(finding, "line"),
+           IntMember(finding, "column"), StringMember(finding, "message")});
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace zetasql::linter
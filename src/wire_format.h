@@ -0,0 +1,91 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SRC_WIRE_FORMAT_H_
+#define SRC_WIRE_FORMAT_H_
+
+// Messages between the lint daemon and its clients.
+//
+// A connection carries frames in both directions. A frame is the length of
+// its payload as a 4 byte little endian integer, followed by the payload.
+// Every request frame is answered by one response frame, in order. Payloads
+// are JSON documents:
+//
+//    request:  {"config": "<text proto>", "files": [{"name": "a.sql",
+//               "content": "SELECT 1;\n"}]}
+//    response: {"error": "", "files": [{"name": "a.sql", "findings": [
+//               {"check": "alias", "line": 1, "column": 10,
+//                "message": "..."}]}]}
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::linter {
+
+// Frames larger than this are rejected, before their payload is read.
+constexpr int kMaxFrameSize = 256 << 20;
+
+struct LintRequestFile {
+  std::string name;
+  std::string content;
+};
+
+struct LintRequest {
+  // Base configuration in text proto format, like the --config file.
+  std::string config;
+  std::vector<LintRequestFile> files;
+};
+
+struct LintFinding {
+  std::string check;
+  int line = 0;
+  int column = 0;
+  std::string message;
+};
+
+struct LintResponseFile {
+  std::string name;
+  std::vector<LintFinding> findings;
+};
+
+struct LintResponse {
+  // Set if the whole request failed, e.g. its configuration is invalid.
+  std::string error;
+  std::vector<LintResponseFile> files;
+};
+
+// Appends a frame with <payload> to <out>.
+void AppendFrame(absl::string_view payload, std::string *out);
+
+// Writes a frame with <payload> to the socket <fd>.
+absl::Status WriteFrame(int fd, absl::string_view payload);
+
+// Reads a frame from <fd> into <payload>. Returns an OutOfRange error if the
+// stream ends before the frame starts.
+absl::Status ReadFrame(int fd, std::string *payload);
+
+std::string EncodeRequest(const LintRequest &request);
+absl::Status DecodeRequest(absl::string_view payload, LintRequest *request);
+
+std::string EncodeResponse(const LintResponse &response);
+absl::Status DecodeResponse(absl::string_view payload, LintResponse *response);
+
+}  // namespace zetasql::linter
+
+#endif  // SRC_WIRE_FORMAT_H_
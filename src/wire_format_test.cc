@@ -0,0 +1,120 @@
+//
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/wire_format.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+
+namespace zetasql::linter {
+
+namespace {
+
+TEST(WireFormatTest, Frames) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ASSERT_TRUE(WriteFrame(fds[0], "first").ok());
+  ASSERT_TRUE(WriteFrame(fds[0], "").ok());
+  std::string big(100000, 'x');
+  ASSERT_TRUE(WriteFrame(fds[0], big).ok());
+
+  std::string payload;
+  ASSERT_TRUE(ReadFrame(fds[1], &payload).ok());
+  EXPECT_EQ(payload, "first");
+  ASSERT_TRUE(ReadFrame(fds[1], &payload).ok());
+  EXPECT_EQ(payload, "");
+  ASSERT_TRUE(ReadFrame(fds[1], &payload).ok());
+  EXPECT_EQ(payload, big);
+
+  close(fds[0]);
+  EXPECT_TRUE(absl::IsOutOfRange(ReadFrame(fds[1], &payload)));
+  close(fds[1]);
+}
+
+TEST(WireFormatTest, InvalidFrames) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  std::string payload;
+
+  // A frame that ends before its payload.
+  std::string frame;
+  AppendFrame("truncated", &frame);
+  frame.resize(frame.size() - 1);
+  ASSERT_EQ(write(fds[0], frame.data(), frame.size()), frame.size());
+  close(fds[0]);
+  absl::Status status = ReadFrame(fds[1], &payload);
+  EXPECT_FALSE(status.ok());
+  EXPECT_FALSE(absl::IsOutOfRange(status));
+  close(fds[1]);
+
+  // A header with a size over the limit.
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ASSERT_EQ(write(fds[0], "\xff\xff\xff\xff", 4), 4);
+  EXPECT_TRUE(absl::IsInvalidArgument(ReadFrame(fds[1], &payload)));
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(WireFormatTest, Request) {
+  LintRequest request;
+  request.config = "line_limit: 50\n";
+  request.files.push_back({"a.sql", "SELECT \"a\";\n"});
+  request.files.push_back({"dir/b.sql", ""});
+
+  LintRequest decoded;
+  ASSERT_TRUE(DecodeRequest(EncodeRequest(request), &decoded).ok());
+  EXPECT_EQ(decoded.config, request.config);
+  ASSERT_EQ(decoded.files.size(), 2);
+  EXPECT_EQ(decoded.files[0].name, "a.sql");
+  EXPECT_EQ(decoded.files[0].content, "SELECT \"a\";\n");
+  EXPECT_EQ(decoded.files[1].name, "dir/b.sql");
+
+  EXPECT_FALSE(DecodeRequest("{\"config\": \"\"}", &decoded).ok());
+  EXPECT_FALSE(DecodeRequest("[]", &decoded).ok());
+}
+
+TEST(WireFormatTest, Response) {
+  LintResponse response;
+  response.files.push_back(
+      {"a.sql", {{"alias", 1, 10, "Always use AS keyword before aliases"}}});
+  response.files.push_back({"b.sql", {}});
+
+  LintResponse decoded;
+  ASSERT_TRUE(DecodeResponse(EncodeResponse(response), &decoded).ok());
+  EXPECT_EQ(decoded.error, "");
+  ASSERT_EQ(decoded.files.size(), 2);
+  ASSERT_EQ(decoded.files[0].findings.size(), 1);
+  const LintFinding &finding = decoded.files[0].findings[0];
+  EXPECT_EQ(finding.check, "alias");
+  EXPECT_EQ(finding.line, 1);
+  EXPECT_EQ(finding.column, 10);
+  EXPECT_EQ(finding.message, "Always use AS keyword before aliases");
+  EXPECT_TRUE(decoded.files[1].findings.empty());
+
+  response = LintResponse();
+  response.error = "Configuration couldn't be parsed.";
+  ASSERT_TRUE(DecodeResponse(EncodeResponse(response), &decoded).ok());
+  EXPECT_EQ(decoded.error, response.error);
+}
+
+}  // namespace
+
+}  // namespace zetasql::linter